@@ -54,6 +54,12 @@ int main() {
     run_benchmark<hash::method::sha256>(cpu_q, input_block_size, n_blocs, n_iters);
     run_benchmark<hash::method::md2>(cpu_q, input_block_size, n_blocs, n_iters);
 
+    // Lookup table placements
+    benchmark_table_placements<hash::method::md2>(cuda_q, input_block_size, n_blocs, n_iters);
+    benchmark_table_placements<hash::method::sha256>(cuda_q, input_block_size, n_blocs, n_iters);
+    benchmark_table_placements<hash::method::md2>(cpu_q, input_block_size, n_blocs, n_iters);
+    benchmark_table_placements<hash::method::sha256>(cpu_q, input_block_size, n_blocs, n_iters);
+
     // CPU == GPU ??
     compare_two_devices<hash::method::sha256>(cuda_q, cpu_q, 1024, 4096);
     compare_two_devices<hash::method::keccak, 128>(cuda_q, cpu_q, 1024, 4096);
@@ -0,0 +1,387 @@
+/**
+ * sha256sum, md5sum and b2sum compatible command line tool hashing files with any of the methods of the library.
+ *   sycl_hashsum [-a METHOD] [-l BITS] [FILE]...        prints "DIGEST  FILE" lines
+ *   sycl_hashsum -c [FILE]...                           checks the "DIGEST  FILE" lines read from the FILEs
+ * The default method follows the name of the executable: md5sum, sha1sum, b2sum, and sha256 otherwise.
+ */
+
+#include <sycl_hash.hpp>
+#include <io/file_hashing.hpp>
+#include <tools/sycl_queue_helpers.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <unistd.h>
+
+struct hashsum_args {
+    std::string method = "sha256";
+    int bits = 0;
+    std::vector<byte> key;
+    std::optional<qword> seed;
+    std::string device = "default";
+    bool check = false;
+    bool binary = false;
+    bool quiet = false;
+    bool status = false;
+    bool ignore_missing = false;
+    hash::file_hash_options options;
+    std::vector<std::string> files;
+};
+
+static std::string program_name = "sycl_hashsum";
+
+[[noreturn]] static void usage(int status) {
+    (status ? std::cerr : std::cout)
+            << "Usage: " << program_name << " [OPTION]... [FILE]...\n"
+            << "Print or check checksums. With no FILE, or when FILE is -, read standard input.\n\n"
+            << "  -a, --algorithm NAME  md2, md5, sha1, sha256, sha256d, hash160, sha3, keccak, blake2b, xxhash64,\n"
+            << "                        xxh3, murmur3, crc32c, crc64nvme, siphash, halfsiphash\n"
+            << "  -l, --length BITS     digest length of sha3, keccak and blake2b\n"
+            << "      --key HEX         key of siphash, halfsiphash and blake2b\n"
+            << "      --seed N          seed of xxhash64, xxh3 and murmur3\n"
+            << "  -b, --binary          read in binary mode\n"
+            << "  -t, --text            read in text mode (default), both modes hash the same bytes\n"
+            << "  -c, --check           read checksums from the FILEs and check them\n"
+            << "      --ignore-missing  don't fail or report status for missing files\n"
+            << "      --quiet           don't print OK for each successfully verified file\n"
+            << "      --status          don't output anything, status code shows success\n"
+            << "  -d, --device TYPE     cpu, gpu or default\n"
+            << "  -j, --readers N       number of threads reading the files\n"
+            << "      --io MODE         mmap (default), pread (direct I/O) or uring (io_uring, direct I/O)\n"
+            << "      --help            display this help and exit\n";
+    std::exit(status);
+}
+
+[[noreturn]] static void fail(const std::string &message) {
+    std::cerr << program_name << ": " << message << '\n';
+    std::exit(1);
+}
+
+static std::vector<byte> parse_hex(const std::string &hex) {
+    std::vector<byte> bytes;
+    if (hex.size() % 2) return {};
+    for (size_t i = 0; i < hex.size(); i += 2) {
+        int hi = std::isxdigit((unsigned char) hex[i]) ? std::stoi(hex.substr(i, 1), nullptr, 16) : -1;
+        int lo = std::isxdigit((unsigned char) hex[i + 1]) ? std::stoi(hex.substr(i + 1, 1), nullptr, 16) : -1;
+        if (hi < 0 || lo < 0) return {};
+        bytes.push_back((byte) (hi << 4 | lo));
+    }
+    return bytes;
+}
+
+static std::string to_hex(const byte *digest, dword size) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(2 * size, '0');
+    for (dword i = 0; i < size; ++i) {
+        hex[2 * i] = digits[digest[i] >> 4];
+        hex[2 * i + 1] = digits[digest[i] & 15];
+    }
+    return hex;
+}
+
+/**
+ * File names with a backslash or a new line are escaped, and their line starts with a backslash, as coreutils does.
+ */
+static bool escape_name(const std::string &name, std::string &escaped) {
+    escaped.clear();
+    for (char c: name) {
+        if (c == '\\') escaped += "\\\\";
+        else if (c == '\n') escaped += "\\n";
+        else escaped += c;
+    }
+    return escaped.size() != name.size();
+}
+
+static bool unescape_name(const std::string &escaped, std::string &name) {
+    name.clear();
+    for (size_t i = 0; i < escaped.size(); ++i) {
+        if (escaped[i] != '\\') {
+            name += escaped[i];
+        } else if (i + 1 < escaped.size() && (escaped[i + 1] == '\\' || escaped[i + 1] == 'n')) {
+            name += escaped[++i] == 'n' ? '\n' : '\\';
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Methods with a digest length, blake2b taking an optional key.
+ */
+template<hash::method M>
+static hash::file_hash_function select_with_bits(int bits, const std::vector<byte> &key) {
+    auto make = [&](auto n_outbit) { return hash::make_file_hash_function<M, decltype(n_outbit)::value>(key.data(), (dword) key.size()); };
+    if constexpr (M == hash::method::blake2b) {
+        switch (bits ? bits : 512) {
+            case 128: return make(std::integral_constant<int, 128>{});
+            case 160: return make(std::integral_constant<int, 160>{});
+            case 224: return make(std::integral_constant<int, 224>{});
+            case 256: return make(std::integral_constant<int, 256>{});
+            case 384: return make(std::integral_constant<int, 384>{});
+            case 512: return make(std::integral_constant<int, 512>{});
+        }
+    } else {
+        switch (bits ? bits : 256) {
+            case 224: return make(std::integral_constant<int, 224>{});
+            case 256: return make(std::integral_constant<int, 256>{});
+            case 384: return make(std::integral_constant<int, 384>{});
+            case 512: return make(std::integral_constant<int, 512>{});
+            case 128: if constexpr (M == hash::method::keccak) return make(std::integral_constant<int, 128>{}); else break;
+            case 288: if constexpr (M == hash::method::keccak) return make(std::integral_constant<int, 288>{}); else break;
+        }
+    }
+    fail("invalid length for " + hash::get_name<M>() + ": " + std::to_string(bits));
+}
+
+template<hash::method M>
+static hash::file_hash_function select_keyed(const std::vector<byte> &key) {
+    if (key.size() != hash::get_key_size<M>()) {
+        fail(hash::get_name<M>() + " needs a key of " + std::to_string(hash::get_key_size<M>()) + " bytes, see --key");
+    }
+    return hash::make_file_hash_function<M>(key.data(), (dword) key.size());
+}
+
+template<hash::method M>
+static hash::file_hash_function select_seeded(const std::optional<qword> &seed) {
+    auto key = hash::internal::seed_to_key(seed.value_or(0));
+    return hash::make_file_hash_function<M>(key.data(), (dword) key.size());
+}
+
+static hash::file_hash_function select_function(const hashsum_args &args) {
+    using hash::method;
+    const std::string &name = args.method;
+    if (args.bits && name != "sha3" && name != "keccak" && name != "blake2b") fail("--length is only supported by sha3, keccak and blake2b");
+    if (!args.key.empty() && name != "blake2b" && name != "siphash" && name != "halfsiphash") fail("--key is only supported by siphash, halfsiphash and blake2b");
+    if (args.seed && name != "xxhash64" && name != "xxh3" && name != "murmur3") fail("--seed is only supported by xxhash64, xxh3 and murmur3");
+    if (name == "blake2b" && args.key.size() > 64) fail("blake2b keys are at most 64 bytes");
+    if (name == "md2") return hash::make_file_hash_function<method::md2>();
+    if (name == "md5") return hash::make_file_hash_function<method::md5>();
+    if (name == "sha1") return hash::make_file_hash_function<method::sha1>();
+    if (name == "sha256") return hash::make_file_hash_function<method::sha256>();
+    if (name == "sha256d") return hash::make_file_hash_function<method::sha256d>();
+    if (name == "hash160") return hash::make_file_hash_function<method::hash160>();
+    if (name == "crc32c") return hash::make_file_hash_function<method::crc32c>();
+    if (name == "crc64nvme") return hash::make_file_hash_function<method::crc64nvme>();
+    if (name == "sha3") return select_with_bits<method::sha3>(args.bits, {});
+    if (name == "keccak") return select_with_bits<method::keccak>(args.bits, {});
+    if (name == "blake2b") return select_with_bits<method::blake2b>(args.bits, args.key);
+    if (name == "xxhash64") return select_seeded<method::xxhash64>(args.seed);
+    if (name == "xxh3") return select_seeded<method::xxh3>(args.seed);
+    if (name == "murmur3") return select_seeded<method::murmur3>(args.seed);
+    if (name == "siphash") return select_keyed<method::siphash>(args.key);
+    if (name == "halfsiphash") return select_keyed<method::halfsiphash>(args.key);
+    fail("unknown algorithm: " + name);
+}
+
+static hashsum_args parse_args(int argc, char **argv) {
+    hashsum_args args;
+    std::string name = program_name;
+    if (name.rfind("md5sum", 0) == 0) args.method = "md5";
+    else if (name.rfind("sha1sum", 0) == 0) args.method = "sha1";
+    else if (name.rfind("b2sum", 0) == 0) args.method = "blake2b";
+
+    bool options_ended = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                std::cerr << program_name << ": option requires an argument -- '" << arg << "'\n";
+                usage(1);
+            }
+            return argv[++i];
+        };
+        auto number = [&](const std::string &text) -> qword {
+            try {
+                size_t end;
+                qword n = std::stoull(text, &end, 0);
+                if (end == text.size()) return n;
+            } catch (...) {}
+            fail("invalid number: '" + text + "'");
+        };
+        if (options_ended || arg == "-" || arg[0] != '-') {
+            args.files.push_back(arg);
+        } else if (arg == "--") {
+            options_ended = true;
+        } else if (arg == "-a" || arg == "--algorithm") {
+            args.method = value();
+        } else if (arg == "-l" || arg == "--length") {
+            args.bits = (int) number(value());
+        } else if (arg == "--key") {
+            std::string hex = value();
+            args.key = parse_hex(hex);
+            if (args.key.empty()) fail("invalid key: '" + hex + "'");
+        } else if (arg == "--seed") {
+            args.seed = number(value());
+        } else if (arg == "-b" || arg == "--binary") {
+            args.binary = true;
+        } else if (arg == "-t" || arg == "--text") {
+            args.binary = false;
+        } else if (arg == "-c" || arg == "--check") {
+            args.check = true;
+        } else if (arg == "--ignore-missing") {
+            args.ignore_missing = true;
+        } else if (arg == "--quiet") {
+            args.quiet = true;
+        } else if (arg == "--status") {
+            args.status = true;
+        } else if (arg == "-d" || arg == "--device") {
+            args.device = value();
+        } else if (arg == "-j" || arg == "--readers") {
+            args.options.n_readers = std::max<size_t>(1, number(value()));
+        } else if (arg == "--io") {
+            std::string io = value();
+            if (io == "mmap") args.options.io = hash::file_io::mapped;
+            else if (io == "pread") args.options.io = hash::file_io::pread;
+            else if (io == "uring") args.options.io = hash::file_io::io_uring;
+            else fail("unknown I/O mode: '" + io + "'");
+        } else if (arg == "--help") {
+            usage(0);
+        } else {
+            std::cerr << program_name << ": unrecognized option '" << arg << "'\n";
+            usage(1);
+        }
+    }
+    if (args.files.empty()) args.files.emplace_back("-");
+    if (!args.check && (args.quiet || args.status || args.ignore_missing)) {
+        fail("the --ignore-missing, --quiet and --status options are meaningful only when verifying checksums");
+    }
+    return args;
+}
+
+static sycl::queue select_queue(const std::string &device) {
+    if (device == "cpu") return try_get_queue(sycl::cpu_selector{});
+    if (device == "gpu") return try_get_queue(sycl::gpu_selector{});
+    if (device == "default") return try_get_queue(sycl::default_selector{});
+    fail("unknown device type: " + device);
+}
+
+/**
+ * Hashes the files and hands their result to `on_result(index, digest, error)` in the order of the list.
+ */
+template<typename Func>
+static void hash_in_order(sycl::queue &q, const hash::file_hash_function &function, const std::vector<std::string> &paths, const hash::file_hash_options &options, Func &&on_result) {
+    std::vector<std::optional<std::string>> digests(paths.size());
+    std::vector<std::string> errors(paths.size());
+    size_t next = 0;
+    hash::hash_files(q, function, paths, options, [&](size_t index, const byte *digest, const std::string &error) {
+        digests[index] = digest ? to_hex(digest, function.digest_size) : std::string{};
+        errors[index] = error;
+        for (; next < paths.size() && digests[next]; ++next) {
+            on_result(next, *digests[next], errors[next]);
+            digests[next] = std::string{};
+        }
+    });
+}
+
+static int print_digests(sycl::queue &q, const hash::file_hash_function &function, const hashsum_args &args) {
+    int status = 0;
+    std::string escaped;
+    hash_in_order(q, function, args.files, args.options, [&](size_t index, const std::string &digest, const std::string &error) {
+        if (!error.empty()) {
+            std::cout.flush();
+            std::cerr << program_name << ": " << error << '\n';
+            status = 1;
+            return;
+        }
+        if (escape_name(args.files[index], escaped)) std::cout << '\\';
+        std::cout << digest << ' ' << (args.binary ? '*' : ' ') << escaped << '\n';
+    });
+    return status;
+}
+
+/**
+ * Parses a "DIGEST  FILE" or "DIGEST *FILE" line.
+ */
+static bool parse_check_line(std::string line, dword digest_size, std::string &digest, std::string &path) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    const bool escaped = !line.empty() && line[0] == '\\';
+    const size_t start = escaped ? 1 : 0;
+    const size_t hex_size = 2 * digest_size;
+    if (line.size() < start + hex_size + 3 || line[start + hex_size] != ' ' || (line[start + hex_size + 1] != ' ' && line[start + hex_size + 1] != '*')) {
+        return false;
+    }
+    digest = line.substr(start, hex_size);
+    if (parse_hex(digest).size() != digest_size) return false;
+    std::transform(digest.begin(), digest.end(), digest.begin(), [](char c) { return (char) std::tolower((unsigned char) c); });
+    path = line.substr(start + hex_size + 2);
+    return !escaped || unescape_name(std::string(path), path);
+}
+
+static int check_digests(sycl::queue &q, const hash::file_hash_function &function, const hashsum_args &args) {
+    size_t bad_lines = 0, unreadable = 0, mismatches = 0;
+    bool missing_list = false, nothing_checked = false;
+    for (const auto &list: args.files) {
+        std::ifstream file;
+        if (list != "-") {
+            file.open(list);
+            if (!file) {
+                std::cerr << program_name << ": " << list << ": No such file or directory\n";
+                missing_list = true;
+                continue;
+            }
+        }
+        std::istream &in = list == "-" ? std::cin : file;
+        std::vector<std::string> paths, expected;
+        size_t list_bad_lines = 0;
+        std::string line, digest, path;
+        while (std::getline(in, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            if (!parse_check_line(line, function.digest_size, digest, path)) {
+                ++list_bad_lines;
+                continue;
+            }
+            if (args.ignore_missing && path != "-" && access(path.c_str(), F_OK) != 0) continue;
+            paths.push_back(path);
+            expected.push_back(digest);
+        }
+        bad_lines += list_bad_lines;
+        if (paths.empty() && list_bad_lines) {
+            std::cerr << program_name << ": " << list << ": no properly formatted checksum lines found\n";
+            nothing_checked = true;
+            continue;
+        }
+
+        hash_in_order(q, function, paths, args.options, [&](size_t index, const std::string &digest, const std::string &error) {
+            const char *result = "OK";
+            if (!error.empty()) {
+                std::cout.flush();
+                if (!args.status) std::cerr << program_name << ": " << error << '\n';
+                result = "FAILED open or read";
+                ++unreadable;
+            } else if (digest != expected[index]) {
+                result = "FAILED";
+                ++mismatches;
+            }
+            if (args.status || (args.quiet && result[0] == 'O')) return;
+            std::cout << paths[index] << ": " << result << '\n';
+        });
+    }
+
+    if (!args.status) {
+        auto warn = [](size_t n, const char *one, const char *many) {
+            if (n) std::cerr << program_name << ": WARNING: " << n << ' ' << (n == 1 ? one : many) << '\n';
+        };
+        warn(bad_lines, "line is improperly formatted", "lines are improperly formatted");
+        warn(unreadable, "listed file could not be read", "listed files could not be read");
+        warn(mismatches, "computed checksum did NOT match", "computed checksums did NOT match");
+    }
+    return missing_list || nothing_checked || unreadable || mismatches ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    std::string invoked = argv[0];
+    program_name = invoked.substr(invoked.find_last_of('/') + 1);
+    hashsum_args args = parse_args(argc, argv);
+    auto function = select_function(args);
+    auto q = select_queue(args.device);
+    try {
+        return args.check ? check_digests(q, function, args) : print_digests(q, function, args);
+    } catch (const std::exception &e) {
+        fail(e.what());
+    }
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
 #include <tools/usm_smart_ptr.hpp>
 
 constexpr dword BLAKE2B_ROUNDS = 12;
@@ -9,6 +11,7 @@ constexpr dword BLAKE2B_CHAIN_SIZE = 8;
 constexpr dword BLAKE2B_CHAIN_LENGTH = (BLAKE2B_CHAIN_SIZE * sizeof(qword));
 constexpr dword BLAKE2B_STATE_SIZE = 16;
 constexpr dword BLAKE2B_STATE_LENGTH = (BLAKE2B_STATE_SIZE * sizeof(qword));
+constexpr dword BLAKE2B_ROW_VECTORIZED_MIN_INLEN = 64 * 1024; // Below that, the row-vectorized compression is not worth it
 
 struct blake2b_ctx {
     int64_t digestlen{};
@@ -25,17 +28,25 @@ struct blake2b_ctx {
 namespace hash::internal {
     class blake2b_kernel;
 
+    class blake2b_vectorized_kernel;
+
     using namespace usm_smart_ptr;
 
+    /**
+     * Whether the single-message SIMD compression should be used. It is only selected on CPUs when there are
+     * fewer messages than cores and the messages are large, i.e. when batching does not fill the machine.
+     */
+    bool use_blake2b_row_vectorized(const sycl::queue &q, dword inlen, dword n_batch);
+
     usm_shared_ptr<blake2b_ctx, alloc::device> get_blake2b_ctx(sycl::queue &q, const byte *key, dword keylen, dword n_outbit);
 
 
     sycl::event
-    launch_blake2b_kernel(sycl::queue &item, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, dword n_outbit, const byte *key,
+    launch_blake2b_kernel(sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, dword n_outbit, const byte *key,
                           dword keylen);
 
     sycl::event
-    launch_blake2b_kernel(sycl::queue &item, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, dword n_outbit, const byte *key,
+    launch_blake2b_kernel(sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, dword n_outbit, const byte *key,
                           dword keylen, device_accessible_ptr<blake2b_ctx>);
 
 }
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/table_placement.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword CRC32C_BLOCK_SIZE = 4;            // CRC32C outputs a 4 byte checksum
+
+namespace hash::internal {
+    class crc32c_kernel;
+
+    class crc32c_sliced_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * CRC32C (Castagnoli) of each item, written most significant byte first.
+     * With the automatic placement, CPUs run slice-by-8 on private tables. Other devices, or an explicit placement,
+     * run the byte-wise kernel with its table placed as requested.
+     */
+    sycl::event
+    launch_crc32c_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement = table_placement::automatic);
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/table_placement.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword CRC64NVME_BLOCK_SIZE = 8;         // CRC64-NVME outputs an 8 byte checksum
+
+namespace hash::internal {
+    class crc64nvme_kernel;
+
+    class crc64nvme_sliced_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * CRC-64/NVME of each item, written most significant byte first.
+     * With the automatic placement, CPUs run slice-by-8 on private tables. Other devices, or an explicit placement,
+     * run the byte-wise kernel with its table placed as requested.
+     */
+    sycl::event
+    launch_crc64nvme_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement = table_placement::automatic);
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword HALFSIPHASH_BLOCK_SIZE = 4;       // HalfSipHash-2-4 outputs a 4 byte digest
+constexpr dword HALFSIPHASH_KEY_SIZE = 8;         // The key is 64-bit
+
+namespace hash::internal {
+    class halfsiphash_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * HalfSipHash-2-4 of each item, keyed with the HALFSIPHASH_KEY_SIZE bytes of `key`. Throws `std::invalid_argument` without such a key.
+     * @param n_buckets when not 0, the kernel writes the bucket id `digest % n_buckets` of each item as a dword
+     * instead of the digest, packed whatever the layout of `outdata`.
+     */
+    sycl::event
+    launch_halfsiphash_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, const byte *key, dword keylen,
+                         dword n_buckets = 0);
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/table_placement.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword HASH160_BLOCK_SIZE = 20;           // RIPEMD160(SHA256(x)) outputs a 20 byte digest
+
+namespace hash::internal {
+    class hash160_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * RIPEMD-160 of the SHA-256 of the input, the intermediate digest never leaves the registers.
+     * @param placement where the kernel reads the SHA-256 round constants from
+     */
+    sycl::event
+    launch_hash160_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement = table_placement::automatic);
+
+}
@@ -1,12 +1,13 @@
 #pragma once
 
 #include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
 #include <tools/usm_smart_ptr.hpp>
 
 
 constexpr dword KECCAK_ROUND = 24;
 constexpr dword KECCAK_STATE_SIZE = 25;
-constexpr dword KECCAK_Q_SIZE = 192;
 
 namespace hash::internal {
 
@@ -17,7 +18,7 @@ namespace hash::internal {
 
 
     sycl::event
-    launch_keccak_kernel(bool is_sha3, sycl::queue &item, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, dword n_outbit);
+    launch_keccak_kernel(bool is_sha3, sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, dword n_outbit);
 
 
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <internal/config.hpp>
+#include <internal/table_placement.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
 #include <tools/usm_smart_ptr.hpp>
 
 constexpr dword MD2_BLOCK_SIZE = 16;
@@ -11,6 +14,10 @@ namespace hash::internal {
     using namespace usm_smart_ptr;
 
 
-    sycl::event launch_md2_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch);
+    /**
+     * @param placement where the kernel reads the S-box from
+     */
+    sycl::event
+    launch_md2_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement = table_placement::automatic);
 
 }
\ No newline at end of file
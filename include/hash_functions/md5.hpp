@@ -1,6 +1,9 @@
 #pragma once
 
 #include <internal/config.hpp>
+#include <internal/fixed_length.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
 #include <tools/usm_smart_ptr.hpp>
 
 /****************************** MACROS ******************************/
@@ -9,8 +12,16 @@ constexpr dword MD5_BLOCK_SIZE = 16;            // MD5 outputs a 16 byte digest
 namespace hash::internal {
     class md5_kernel;
 
+    template<dword inlen>
+    class md5_fixed_kernel;
+
     using namespace usm_smart_ptr;
 
-    sycl::event launch_md5_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch);
+    sycl::event launch_md5_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch);
+
+    /**
+     * Launches the kernel specialised for `inlen`. The length must be in `fixed_input_lengths`.
+     */
+    sycl::event launch_md5_fixed_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch);
 
 }
\ No newline at end of file
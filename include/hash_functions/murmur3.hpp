@@ -0,0 +1,21 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword MURMUR3_BLOCK_SIZE = 16;          // MurmurHash3 x64 128-bit outputs a 16 byte digest
+
+namespace hash::internal {
+    class murmur3_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * MurmurHash3 x64 128-bit of each item. Only the low 32 bits of the seed are used, as in the reference.
+     * Not a cryptographic hash.
+     */
+    sycl::event launch_murmur3_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, qword seed);
+
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <internal/config.hpp>
+#include <internal/fixed_length.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
 #include <tools/usm_smart_ptr.hpp>
 
 
@@ -9,8 +12,16 @@ constexpr dword SHA1_BLOCK_SIZE = 20;
 namespace hash::internal {
     class sha1_kernel;
 
+    template<dword inlen>
+    class sha1_fixed_kernel;
+
     using namespace usm_smart_ptr;
 
-    sycl::event launch_sha1_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch);
+    sycl::event launch_sha1_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch);
+
+    /**
+     * Launches the kernel specialised for `inlen`. The length must be in `fixed_input_lengths`.
+     */
+    sycl::event launch_sha1_fixed_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch);
 
 }
\ No newline at end of file
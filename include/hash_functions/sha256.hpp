@@ -1,6 +1,10 @@
 #pragma once
 
 #include <internal/config.hpp>
+#include <internal/fixed_length.hpp>
+#include <internal/table_placement.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
 #include <tools/usm_smart_ptr.hpp>
 
 /****************************** MACROS ******************************/
@@ -9,10 +13,24 @@ constexpr dword SHA256_BLOCK_SIZE = 32;            // SHA256 outputs a 32 byte d
 namespace hash::internal {
     class sha256_kernel;
 
+    template<dword inlen>
+    class sha256_fixed_kernel;
+
     using namespace usm_smart_ptr;
 
 
-    sycl::event launch_sha256_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch);
+    /**
+     * @param placement where the kernel reads the round constants from
+     */
+    sycl::event
+    launch_sha256_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement = table_placement::automatic);
+
+    /**
+     * Launches the kernel specialised for `inlen`. The length must be in `fixed_input_lengths`.
+     */
+    sycl::event
+    launch_sha256_fixed_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch,
+                               table_placement placement = table_placement::automatic);
 
 
 }
\ No newline at end of file
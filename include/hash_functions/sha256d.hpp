@@ -0,0 +1,23 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/table_placement.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword SHA256D_BLOCK_SIZE = 32;           // SHA256(SHA256(x)) outputs a 32 byte digest
+
+namespace hash::internal {
+    class sha256d_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * Double SHA-256, the intermediate digest never leaves the registers.
+     * @param placement where the kernel reads the round constants from
+     */
+    sycl::event
+    launch_sha256d_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement = table_placement::automatic);
+
+}
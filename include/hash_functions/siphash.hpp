@@ -0,0 +1,25 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword SIPHASH_BLOCK_SIZE = 8;           // SipHash-2-4 outputs an 8 byte digest
+constexpr dword SIPHASH_KEY_SIZE = 16;            // The key is 128-bit
+
+namespace hash::internal {
+    class siphash_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * SipHash-2-4 of each item, keyed with the SIPHASH_KEY_SIZE bytes of `key`. Throws `std::invalid_argument` without such a key.
+     * @param n_buckets when not 0, the kernel writes the bucket id `digest % n_buckets` of each item as a dword
+     * instead of the digest, packed whatever the layout of `outdata`.
+     */
+    sycl::event
+    launch_siphash_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, const byte *key, dword keylen,
+                         dword n_buckets = 0);
+
+}
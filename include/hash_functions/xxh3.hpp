@@ -0,0 +1,21 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword XXH3_BLOCK_SIZE = 8;              // XXH3 (64-bit) outputs an 8 byte digest
+
+namespace hash::internal {
+    class xxh3_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * XXH3 64-bit of each item, written in the canonical big endian form.
+     * Not a cryptographic hash.
+     */
+    sycl::event launch_xxh3_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, qword seed);
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/digest_output.hpp>
+#include <internal/record_input.hpp>
+#include <tools/usm_smart_ptr.hpp>
+
+constexpr dword XXHASH64_BLOCK_SIZE = 8;          // xxh64 outputs an 8 byte digest
+
+namespace hash::internal {
+    class xxhash64_kernel;
+
+    using namespace usm_smart_ptr;
+
+    /**
+     * XXH64 of each item, written in the canonical big endian form.
+     * Not a cryptographic hash.
+     */
+    sycl::event launch_xxhash64_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, qword seed);
+
+}
@@ -3,6 +3,7 @@
 #include <utility>
 #include "common.hpp"
 #include "handle.hpp"
+#include "pinned_output.hpp"
 
 namespace hash {
     /**
@@ -14,10 +15,50 @@ namespace hash {
     class hasher {
     private:
         runners runners_;
+        std::vector<pinned_digest_ring> rings_{};
     public:
         explicit hasher(runners v) : runners_(std::move(v)) {}
 
-        handle hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, byte *key, dword keylen) {
+        /**
+         * Sets up the pinned output mode: a ring of `n_slots` slots of pinned host memory per runner, each slot holding
+         * the digests of up to `max_batch` items. See `hash_pinned`. The handles in flight keep the rings they write
+         * into, calling it again or destroying the hasher before waiting for them is safe.
+         */
+        void enable_pinned_output(dword n_slots, dword max_batch) {
+            rings_.clear();
+            for (auto &runner: runners_) {
+                rings_.emplace_back(runner.q, n_slots, get_block_size<M, n_outbit>() * max_batch);
+            }
+        }
+
+        /**
+         * Hashes with the kernels writing the digests straight into the pinned rings of the hasher, instead of a device
+         * buffer copied back into the caller's memory. `enable_pinned_output` must have been called.
+         * @param on_ready `void(dword first, const byte *digests, dword count)` called by the `wait` of the handle for
+         * the share of each runner: the digests of the items `first` to `first + count - 1`, valid during the call.
+         * At most `n_slots` handles may be in flight: the next call throws `std::logic_error` until the oldest one is
+         * waited for or destroyed.
+         */
+        template<typename Func>
+        pinned_handle hash_pinned(const byte *indata, dword inlen, dword n_batch, const byte *key, dword keylen, Func on_ready) {
+            if (rings_.size() != runners_.size()) {
+                throw std::logic_error("hasher: enable_pinned_output was not called");
+            }
+            pinned_handle handle;
+            auto offsets = internal::get_batch_offsets(runners_, n_batch);
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                internal::hash_to_ring<M, n_outbit>(handle, runners_[i].q, indata, inlen, (dword) offsets[i], (dword) (offsets[i + 1] - offsets[i]), rings_[i], key, keylen, on_ready);
+            }
+            return handle;
+        }
+
+        template<typename Func>
+        pinned_handle hash_pinned(const byte *indata, dword inlen, dword n_batch, Func on_ready) {
+            static_assert(!is_keyed<M>(), "This method needs a key");
+            return hash_pinned(indata, inlen, n_batch, nullptr, 0, std::move(on_ready));
+        }
+
+        handle hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, const byte *key, dword keylen) {
             size_t size = runners_.size();
             std::vector<handle_item> handles;
             handles.reserve(size);
@@ -29,9 +70,19 @@ namespace hash {
         }
 
         handle hash(const byte *indata, dword inlen, byte *outdata, dword n_batch) {
+            static_assert(!is_keyed<M>(), "This method needs a key");
             return hash(indata, inlen, outdata, n_batch, nullptr, 0);
         }
 
+        /**
+         * Hashes with a seed, for the seeded methods (see `is_seeded`).
+         */
+        handle hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, qword seed) {
+            static_assert(is_seeded<M>(), "This method does not take a seed");
+            auto key = internal::seed_to_key(seed);
+            return hash(indata, inlen, outdata, n_batch, key.data(), key.size());
+        }
+
 
     };
 
@@ -46,6 +97,7 @@ namespace hash {
     private:
         hash::runners runners_;
         std::vector<usm_shared_ptr < blake2b_ctx, alloc::device>> keyed_ctxts_{};
+        std::vector<pinned_digest_ring> rings_{};
     public:
         explicit hasher(const hash::runners &v, const byte *key, dword keylen) : runners_(v) {
             size_t size = v.size();
@@ -67,6 +119,33 @@ namespace hash {
             }
             return handle(std::move(handles));
         }
+
+        /**
+         * See `hasher::enable_pinned_output`.
+         */
+        void enable_pinned_output(dword n_slots, dword max_batch) {
+            rings_.clear();
+            for (auto &runner: runners_) {
+                rings_.emplace_back(runner.q, n_slots, get_block_size<method::blake2b, n_outbit>() * max_batch);
+            }
+        }
+
+        /**
+         * See `hasher::hash_pinned`.
+         */
+        template<typename Func>
+        pinned_handle hash_pinned(const byte *indata, dword inlen, dword n_batch, Func on_ready) {
+            if (rings_.size() != runners_.size()) {
+                throw std::logic_error("hasher: enable_pinned_output was not called");
+            }
+            pinned_handle handle;
+            auto offsets = internal::get_batch_offsets(runners_, n_batch);
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                internal::hash_to_ring<method::blake2b, n_outbit>(handle, runners_[i].q, indata, inlen, (dword) offsets[i], (dword) (offsets[i + 1] - offsets[i]), rings_[i], nullptr, 0, on_ready, keyed_ctxts_[i].get());
+                handle.own(keyed_ctxts_[i]);
+            }
+            return handle;
+        }
     };
 
 
@@ -74,6 +153,15 @@ namespace hash {
     using md5 = hasher<hash::method::md5>;
     using sha1 = hasher<hash::method::sha1>;
     using sha256 = hasher<hash::method::sha256>;
+    using sha256d = hasher<hash::method::sha256d>;
+    using hash160 = hasher<hash::method::hash160>;
+    using xxhash64 = hasher<hash::method::xxhash64>;
+    using xxh3 = hasher<hash::method::xxh3>;
+    using murmur3 = hasher<hash::method::murmur3>;
+    using crc32c = hasher<hash::method::crc32c>;
+    using crc64nvme = hasher<hash::method::crc64nvme>;
+    using siphash = hasher<hash::method::siphash>;
+    using halfsiphash = hasher<hash::method::halfsiphash>;
 
     template<int n_outbit>
     using keccak = hasher<hash::method::keccak, n_outbit>;
@@ -6,6 +6,15 @@
 #include "../hash_functions/md5.hpp"
 #include "../hash_functions/md2.hpp"
 #include "../hash_functions/sha1.hpp"
+#include "../hash_functions/sha256d.hpp"
+#include "../hash_functions/hash160.hpp"
+#include "../hash_functions/xxhash64.hpp"
+#include "../hash_functions/xxh3.hpp"
+#include "../hash_functions/murmur3.hpp"
+#include "../hash_functions/crc32c.hpp"
+#include "../hash_functions/crc64nvme.hpp"
+#include "../hash_functions/siphash.hpp"
+#include "../hash_functions/halfsiphash.hpp"
 
 #include "handle.hpp"
 
@@ -46,6 +55,50 @@ namespace hash {
     };
 
 
+    /**
+     * Whether a method has kernels specialised on the input length, see `fixed_input_lengths`.
+     */
+    template<method M>
+    inline constexpr bool has_fixed_length_kernels() {
+        return M == method::sha256 || M == method::sha1 || M == method::md5;
+    }
+
+    /**
+     * Whether a method takes a seed. The seed is passed to `dispatch_hash` as the key, see `internal::seed_from_key`.
+     */
+    template<method M>
+    inline constexpr bool is_seeded() {
+        return M == method::xxhash64 || M == method::xxh3 || M == method::murmur3;
+    }
+
+    /**
+     * Whether a method is a keyed PRF that requires a key of `get_key_size<M>()` bytes, passed as the key of `dispatch_hash`.
+     */
+    template<method M>
+    inline constexpr bool is_keyed() {
+        return M == method::siphash || M == method::halfsiphash;
+    }
+
+    /**
+     * Size in bytes of the key of a keyed method.
+     */
+    template<method M, typename = std::enable_if_t<is_keyed<M>()>>
+    inline constexpr dword get_key_size() {
+        if constexpr(M == method::siphash) {
+            return SIPHASH_KEY_SIZE;
+        } else {
+            return HALFSIPHASH_KEY_SIZE;
+        }
+    }
+
+    /**
+     * Whether a method can reduce its digest modulo a bucket count inside the kernel, see `compute_buckets`.
+     */
+    template<method M>
+    inline constexpr bool has_bucket_mode() {
+        return is_keyed<M>();
+    }
+
     /**
      * Returns the size of the hash result, in bytes, produced by a hashing function.
      * @tparam M the hashing function we want
@@ -61,6 +114,24 @@ namespace hash {
             return MD2_BLOCK_SIZE;
         } else if constexpr(M == method::sha1) {
             return SHA1_BLOCK_SIZE;
+        } else if constexpr(M == method::sha256d) {
+            return SHA256D_BLOCK_SIZE;
+        } else if constexpr(M == method::hash160) {
+            return HASH160_BLOCK_SIZE;
+        } else if constexpr(M == method::xxhash64) {
+            return XXHASH64_BLOCK_SIZE;
+        } else if constexpr(M == method::xxh3) {
+            return XXH3_BLOCK_SIZE;
+        } else if constexpr(M == method::murmur3) {
+            return MURMUR3_BLOCK_SIZE;
+        } else if constexpr(M == method::crc32c) {
+            return CRC32C_BLOCK_SIZE;
+        } else if constexpr(M == method::crc64nvme) {
+            return CRC64NVME_BLOCK_SIZE;
+        } else if constexpr(M == method::siphash) {
+            return SIPHASH_BLOCK_SIZE;
+        } else if constexpr(M == method::halfsiphash) {
+            return HALFSIPHASH_BLOCK_SIZE;
         } else {
             static_assert(nothing_matched<M>::value);
         }
@@ -107,6 +178,24 @@ namespace hash {
             return {"sha3"};
         } else if constexpr(M == method::blake2b) {
             return {"blake2b"};
+        } else if constexpr(M == method::sha256d) {
+            return {"sha256d"};
+        } else if constexpr(M == method::hash160) {
+            return {"hash160"};
+        } else if constexpr(M == method::xxhash64) {
+            return {"xxhash64"};
+        } else if constexpr(M == method::xxh3) {
+            return {"xxh3"};
+        } else if constexpr(M == method::murmur3) {
+            return {"murmur3"};
+        } else if constexpr(M == method::crc32c) {
+            return {"crc32c"};
+        } else if constexpr(M == method::crc64nvme) {
+            return {"crc64nvme"};
+        } else if constexpr(M == method::siphash) {
+            return {"siphash"};
+        } else if constexpr(M == method::halfsiphash) {
+            return {"halfsiphash"};
         } else {
             static_assert(nothing_matched<M>::value);
         }
@@ -126,14 +215,11 @@ namespace hash {
         };
 
         /**
-         * Breaks the work space into batches which will run on the various queues. It takes into account the
-         * device performance.
-         * @return
+         * Splits `n_batch` items between the runners according to their performance: runner `i` gets the items
+         * `offsets[i]` to `offsets[i + 1] - 1`.
          */
-        template<method M, int n_outbit = 0>
-        [[nodiscard]] inline std::vector<queue_work> get_hash_queue_work_item(const ::hash::runners &v, const byte *in, dword inlen, byte *out, dword n_batch) {
+        [[nodiscard]] inline std::vector<size_t> get_batch_offsets(const ::hash::runners &v, dword n_batch) {
             size_t len = v.size();
-            std::vector<queue_work> out_vector(len);
             std::vector<size_t> batch_offsets(len + 1);
             double coefs_sum = 0;
             for (const auto &elt: v) {
@@ -144,6 +230,19 @@ namespace hash {
                 batch_offsets[i + 1] = prev_offset;
             }
             batch_offsets[len] = n_batch;
+            return batch_offsets;
+        }
+
+        /**
+         * Breaks the work space into batches which will run on the various queues. It takes into account the
+         * device performance.
+         * @return
+         */
+        template<method M, int n_outbit = 0>
+        [[nodiscard]] inline std::vector<queue_work> get_hash_queue_work_item(const ::hash::runners &v, const byte *in, dword inlen, byte *out, dword n_batch) {
+            size_t len = v.size();
+            std::vector<queue_work> out_vector(len);
+            std::vector<size_t> batch_offsets = get_batch_offsets(v, n_batch);
 
             for (size_t i = 0; i < len; ++i) {
                 const byte *in_ptr = in + batch_offsets[i] * inlen;
@@ -155,6 +254,29 @@ namespace hash {
         }
 
 
+        /**
+         * Seeded methods receive their seed through the key pointer of `dispatch_hash`: `keylen` bytes (at most 8)
+         * read as a little endian integer. No key means a seed of 0.
+         */
+        inline qword seed_from_key(const byte *key, dword keylen) {
+            qword seed = 0;
+            for (dword i = 0; key && i < keylen && i < sizeof(qword); ++i) {
+                seed |= (qword) key[i] << (8 * i);
+            }
+            return seed;
+        }
+
+        /**
+         * Little endian bytes of a seed, to be passed as the key of a seeded method.
+         */
+        inline std::array<byte, sizeof(qword)> seed_to_key(qword seed) {
+            std::array<byte, sizeof(qword)> key{};
+            for (dword i = 0; i < sizeof(qword); ++i) {
+                key[i] = (byte) (seed >> (8 * i));
+            }
+            return key;
+        }
+
         /**
          * Function used to launch the hashing kernel.
          * One must ensure that the memory can be read by the device.
@@ -163,20 +285,35 @@ namespace hash {
          * @tparam buffers Pack of buffers/extra arguments which will be passed to the kernel.
          * Principally used to pass the constant buffers from the outside so the call is not blocking.
          * If no buffers are passed, but needed, the function is blocking on some SYCL implementations.
+         * @param indata input pointer, or a `record_input` to read the items at an offset and stride, in place
+         * @param outdata output pointer, or a `digest_output` to keep only part of each digest or lay them out
+         * differently. Throws `std::invalid_argument` if its layout does not fit the digests.
          * @return A SYCL event.
          */
         template<method M, int n_outbit, typename... buffers>
         [[nodiscard]] inline sycl::event
-        dispatch_hash(sycl::queue &q, const sycl::event &e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, const byte *key, dword keylen,
+        dispatch_hash(sycl::queue &q, const sycl::event &e, record_input indata, digest_output outdata, dword inlen, dword n_batch, const byte *key, dword keylen,
                       buffers... bufs) {
             if (n_batch == 0) return sycl::event{};
+            if (!outdata.is_packed()) {
+                outdata.check(get_block_size<M, n_outbit>(), n_batch);
+            }
             if constexpr(M == method::sha256) {
+                if (fixed_input_lengths::contains(inlen)) {
+                    return launch_sha256_fixed_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
+                }
                 return launch_sha256_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
             } else if constexpr(M == method::md5) {
+                if (fixed_input_lengths::contains(inlen)) {
+                    return launch_md5_fixed_kernel(q, e, indata, outdata, inlen, n_batch);
+                }
                 return launch_md5_kernel(q, e, indata, outdata, inlen, n_batch);
             } else if constexpr(M == method::md2) {
                 return launch_md2_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
             } else if constexpr(M == method::sha1) {
+                if (fixed_input_lengths::contains(inlen)) {
+                    return launch_sha1_fixed_kernel(q, e, indata, outdata, inlen, n_batch);
+                }
                 return launch_sha1_kernel(q, e, indata, outdata, inlen, n_batch);
             } else if constexpr(M == method::keccak && (n_outbit == 128 || n_outbit == 224 || n_outbit == 256 || n_outbit == 288 || n_outbit == 384 || n_outbit == 512)) {
                 return launch_keccak_kernel(false, q, e, indata, outdata, inlen, n_batch, n_outbit, bufs...);
@@ -184,6 +321,24 @@ namespace hash {
                 return launch_keccak_kernel(true, q, e, indata, outdata, inlen, n_batch, n_outbit, bufs...);
             } else if constexpr (M == method::blake2b) {
                 return launch_blake2b_kernel(q, e, indata, outdata, inlen, n_batch, n_outbit, key, keylen, bufs...);
+            } else if constexpr(M == method::sha256d) {
+                return launch_sha256d_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
+            } else if constexpr(M == method::hash160) {
+                return launch_hash160_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
+            } else if constexpr(M == method::xxhash64) {
+                return launch_xxhash64_kernel(q, e, indata, outdata, inlen, n_batch, seed_from_key(key, keylen));
+            } else if constexpr(M == method::xxh3) {
+                return launch_xxh3_kernel(q, e, indata, outdata, inlen, n_batch, seed_from_key(key, keylen));
+            } else if constexpr(M == method::murmur3) {
+                return launch_murmur3_kernel(q, e, indata, outdata, inlen, n_batch, seed_from_key(key, keylen));
+            } else if constexpr(M == method::crc32c) {
+                return launch_crc32c_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
+            } else if constexpr(M == method::crc64nvme) {
+                return launch_crc64nvme_kernel(q, e, indata, outdata, inlen, n_batch, bufs...);
+            } else if constexpr(M == method::siphash) {
+                return launch_siphash_kernel(q, e, indata, outdata, inlen, n_batch, key, keylen, bufs...);
+            } else if constexpr(M == method::halfsiphash) {
+                return launch_halfsiphash_kernel(q, e, indata, outdata, inlen, n_batch, key, keylen, bufs...);
             } else {
                 static_assert(nothing_matched<M>::value);
             }
@@ -26,7 +26,16 @@ namespace hash {
         sha1,
         sha3,
         md5,
-        md2
+        md2,
+        sha256d,
+        hash160,
+        xxhash64,
+        xxh3,
+        murmur3,
+        crc32c,
+        crc64nvme,
+        siphash,
+        halfsiphash
     };
 
 
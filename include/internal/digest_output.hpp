@@ -0,0 +1,104 @@
+#pragma once
+
+#include "config.hpp"
+#include "../tools/usm_smart_ptr.hpp"
+
+#include <stdexcept>
+
+namespace hash {
+
+    /**
+     * How the digests of a call are laid out in the output. The default writes every digest whole, one after the
+     * other, as `get_block_size` expects.
+     */
+    struct output_layout {
+        dword width = 0; /** Bytes kept of each digest, its first ones. 0 keeps the whole digest */
+        size_t stride = 0; /** Bytes from a digest to the next, or from a column to the next with `soa`. 0 packs them */
+        bool soa = false; /** Structure of arrays: the digests are cut in 4 bytes columns, column `c` of all the items then column `c + 1` */
+        size_t offset = 0; /** Bytes from the base to the first digest, to write into a field of an array of structures */
+    };
+
+    /**
+     * Output of a hashing kernel: where the digests go and how. Built from the output pointer, which keeps the default
+     * layout. Trivially copyable, kernels capture it.
+     */
+    class digest_output {
+    private:
+        byte *base_;
+        output_layout layout_;
+
+    public:
+        digest_output(usm_smart_ptr::device_accessible_ptr<byte> base, const output_layout &layout = {}) : base_(base), layout_(layout) {}
+
+        digest_output(usm_smart_ptr::usm_ptr<byte, sycl::usm::alloc::shared> base) : digest_output(usm_smart_ptr::device_accessible_ptr<byte>(base)) {}
+
+        digest_output(usm_smart_ptr::usm_ptr<byte, sycl::usm::alloc::device> base) : digest_output(usm_smart_ptr::device_accessible_ptr<byte>(base)) {}
+
+        [[nodiscard]] inline byte *base() const noexcept { return base_; }
+
+        [[nodiscard]] inline const output_layout &layout() const noexcept { return layout_; }
+
+        [[nodiscard]] inline bool is_packed() const noexcept { return layout_.width == 0 && layout_.stride == 0 && !layout_.soa && layout_.offset == 0; }
+
+        /**
+         * Bytes spanned by the digests of `n_batch` items, from `base() + layout().offset`.
+         */
+        [[nodiscard]] inline size_t span(dword digest_size, dword n_batch) const noexcept {
+            if (n_batch == 0) return 0;
+            const dword width = layout_.width ? layout_.width : digest_size;
+            if (layout_.soa) {
+                const size_t stride = layout_.stride ? layout_.stride : (size_t) 4 * n_batch;
+                return (width / 4 - 1) * stride + (size_t) 4 * n_batch;
+            }
+            const size_t stride = layout_.stride ? layout_.stride : width;
+            return (n_batch - 1) * stride + width;
+        }
+
+        /**
+         * Whether the digests leave bytes untouched between them.
+         */
+        [[nodiscard]] inline bool has_gaps(dword digest_size, dword n_batch) const noexcept {
+            const dword width = layout_.width ? layout_.width : digest_size;
+            return span(digest_size, n_batch) != (size_t) width * n_batch;
+        }
+
+        /**
+         * Throws `std::invalid_argument` if the layout does not fit digests of `digest_size` bytes.
+         */
+        void check(dword digest_size, dword n_batch) const {
+            const dword width = layout_.width ? layout_.width : digest_size;
+            if (width > digest_size) {
+                throw std::invalid_argument("output_layout: the width exceeds the digest size");
+            }
+            if (layout_.soa && width % 4 != 0) {
+                throw std::invalid_argument("output_layout: structure of arrays needs a width multiple of 4");
+            }
+            if (layout_.stride && layout_.stride < (layout_.soa ? (size_t) 4 * n_batch : width)) {
+                throw std::invalid_argument("output_layout: the stride makes the digests overlap");
+            }
+        }
+
+        /**
+         * Writes the kept bytes of the digest of `item`. Called by the kernels once the digest is computed.
+         */
+        inline void store(const byte *digest, dword digest_size, dword item, dword n_batch) const {
+            const dword width = layout_.width ? layout_.width : digest_size;
+            byte *first = base_ + layout_.offset;
+            if (!layout_.soa) {
+                byte *out = first + item * (layout_.stride ? layout_.stride : width);
+                for (dword i = 0; i < width; ++i) {
+                    out[i] = digest[i];
+                }
+                return;
+            }
+            const size_t stride = layout_.stride ? layout_.stride : (size_t) 4 * n_batch;
+            for (dword column = 0; column < width / 4; ++column) {
+                byte *out = first + column * stride + (size_t) item * 4;
+                for (dword i = 0; i < 4; ++i) {
+                    out[i] = digest[4 * column + i];
+                }
+            }
+        }
+    };
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <type_traits>
+#include "config.hpp"
+#include "../tools/intrinsics.hpp"
+
+namespace hash {
+    /**
+     * Tag used to pass the length of the items to hash at compile time:
+     * compute<method::sha256, fixed_len<4096>>(q, in, out, n_batch);
+     * @tparam N length of one item, in bytes
+     */
+    template<dword N>
+    struct fixed_len {
+        static constexpr dword value = N;
+    };
+
+    template<typename T>
+    struct is_fixed_len : std::false_type {
+    };
+
+    template<dword N>
+    struct is_fixed_len<fixed_len<N>> : std::true_type {
+    };
+
+    template<typename T>
+    inline constexpr bool is_fixed_len_v = is_fixed_len<T>::value;
+}
+
+namespace hash::internal {
+
+    /**
+     * Compile-time list of message lengths for which kernels are instantiated in the library.
+     * @tparam lengths lengths, in bytes
+     */
+    template<dword... lengths>
+    struct length_list {
+        /**
+         * Whether a runtime length has a specialised kernel.
+         */
+        static constexpr bool contains(dword len) {
+            return ((len == lengths) || ...);
+        }
+
+        /**
+         * Calls `f` with a std::integral_constant holding the length that matches `len`.
+         * One must check that the list contains the length first.
+         */
+        template<typename Func>
+        static inline sycl::event visit(dword len, Func &&f) {
+            sycl::event e{};
+            [[maybe_unused]] bool found = ((len == lengths ? (e = f(std::integral_constant<dword, lengths>{}), true) : false) || ...);
+            assert(found);
+            return e;
+        }
+    };
+
+    /**
+     * Registry of the lengths for which the Merkle-Damgard hashes (md5, sha1, sha256) have kernels with `inlen`
+     * as a compile-time constant. `dispatch_hash` uses them whenever the runtime length matches.
+     * The small ones fit in one or two compression blocks: UUIDs, sha1/sha256/sha384 digests, keys and digest pairs.
+     * The larger ones are common page and record sizes.
+     * Adding a length here instantiates the kernels for it when the library is rebuilt.
+     */
+    using fixed_input_lengths = length_list<16, 20, 32, 48, 64, 128, 256, 512, 1024, 4096, 8192>;
+
+    constexpr dword MD_BLOCK_LENGTH = 64;
+    constexpr dword MD_BLOCK_WORDS = MD_BLOCK_LENGTH / sizeof(dword);
+
+    /**
+     * Number of 64 bytes blocks a Merkle-Damgard message takes once padded with 0x80 and its 64-bit length.
+     */
+    constexpr dword md_padded_blocks(dword inlen) {
+        return (inlen + 1 + 8 + MD_BLOCK_LENGTH - 1) / MD_BLOCK_LENGTH;
+    }
+
+    /**
+     * Number of full 64 bytes blocks of a message, these can be transformed straight from the input.
+     */
+    constexpr dword md_full_blocks(dword inlen) {
+        return inlen / MD_BLOCK_LENGTH;
+    }
+
+    /**
+     * Number of blocks holding the end of the message and the padding (one or two).
+     */
+    constexpr dword md_tail_blocks(dword inlen) {
+        return md_padded_blocks(inlen % MD_BLOCK_LENGTH);
+    }
+
+    /**
+     * Computes, at compile time, the words of the padded tail of a message where the message bytes are left to zero.
+     * Only the 0x80 terminator and the length in bits are set.
+     * @tparam inlen length of the whole message, in bytes
+     * @tparam big_endian true for the SHA family, false for MD5
+     */
+    template<dword inlen, bool big_endian>
+    constexpr std::array<dword, md_tail_blocks(inlen) * MD_BLOCK_WORDS> md_padding_words() {
+        constexpr dword n_words = md_tail_blocks(inlen) * MD_BLOCK_WORDS;
+        constexpr dword tail_len = inlen % MD_BLOCK_LENGTH;
+        std::array<dword, n_words> words{};
+        constexpr dword shift = big_endian ? 24 - 8 * (tail_len % 4) : 8 * (tail_len % 4);
+        words[tail_len / 4] = dword{0x80} << shift;
+        constexpr qword bitlen = qword{inlen} * 8;
+        if constexpr (big_endian) {
+            words[n_words - 2] = (dword) (bitlen >> 32);
+            words[n_words - 1] = (dword) bitlen;
+        } else {
+            words[n_words - 2] = (dword) bitlen;
+            words[n_words - 1] = (dword) (bitlen >> 32);
+        }
+        return words;
+    }
+
+    template<bool big_endian>
+    static inline dword md_load_word(const byte *p) {
+        if constexpr (big_endian) {
+            return (dword(p[0]) << 24) | (dword(p[1]) << 16) | (dword(p[2]) << 8) | dword(p[3]);
+        } else {
+            return dword(p[0]) | (dword(p[1]) << 8) | (dword(p[2]) << 16) | (dword(p[3]) << 24);
+        }
+    }
+
+    /**
+     * Loads one 64 bytes block as 16 words. When the pointer is 4-byte aligned the block is read with 32-bit loads,
+     * otherwise we fall back to byte loads.
+     */
+    template<bool big_endian>
+    static inline void md_load_block(const byte *data, dword *words) {
+        if ((reinterpret_cast<uintptr_t>(data) & (sizeof(dword) - 1)) == 0) {
+            const auto *aligned = reinterpret_cast<const dword *>(data);
+#pragma unroll
+            for (dword i = 0; i < MD_BLOCK_WORDS; ++i) {
+                words[i] = big_endian ? sbb::byte_swap(aligned[i]) : aligned[i];
+            }
+        } else {
+#pragma unroll
+            for (dword i = 0; i < MD_BLOCK_WORDS; ++i) {
+                words[i] = md_load_word<big_endian>(data + 4 * i);
+            }
+        }
+    }
+
+    /**
+     * Builds the padded tail of a fixed length input. As `inlen` is known at compile time
+     * the loops are fully unrolled and the padding folds into constants.
+     * @param in message of `inlen` bytes
+     * @param m output, md_tail_blocks(inlen) * 16 words
+     */
+    template<dword inlen, bool big_endian>
+    static inline void md_load_padded_tail(const byte *in, dword *m) {
+        constexpr auto padding = md_padding_words<inlen, big_endian>();
+        constexpr dword tail_len = inlen % MD_BLOCK_LENGTH;
+        const byte *tail = in + md_full_blocks(inlen) * MD_BLOCK_LENGTH;
+#pragma unroll
+        for (dword i = 0; i < padding.size(); ++i) {
+            m[i] = padding[i];
+        }
+
+#pragma unroll
+        for (dword i = 0; i < tail_len / 4; ++i) {
+            m[i] = md_load_word<big_endian>(tail + 4 * i);
+        }
+
+#pragma unroll
+        for (dword i = tail_len & ~3u; i < tail_len; ++i) {
+            m[i / 4] |= dword(tail[i]) << (big_endian ? 24 - 8 * (i % 4) : 8 * (i % 4));
+        }
+    }
+
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include "common.hpp"
+#include "../tools/sycl_queue_helpers.hpp"
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+namespace hash {
+
+    /**
+     * Pinned host memory (`alloc::host`) split in slots that the kernels write digests into directly, and that the host
+     * reads without any copy. Slots are handed out in turn, and a slot stays held by its `pinned_handle` until the
+     * handle is waited for or destroyed. The handles share the memory and the flags of the ring, which may be destroyed
+     * before them.
+     */
+    class pinned_digest_ring {
+    private:
+        dword n_slots_;
+        size_t slot_bytes_;
+        usm_shared_ptr<byte, alloc::host> memory_;
+        std::vector<sycl::event> writes_;
+        std::shared_ptr<std::vector<bool>> in_use_;
+        dword next_ = 0;
+
+    public:
+        pinned_digest_ring(sycl::queue &q, dword n_slots, size_t slot_bytes) :
+                n_slots_(std::max<dword>(1, n_slots)),
+                slot_bytes_(std::max<size_t>(1, slot_bytes)),
+                memory_(n_slots_ * slot_bytes_, q),
+                writes_(n_slots_),
+                in_use_(std::make_shared<std::vector<bool>>(n_slots_)) {}
+
+        /**
+         * Takes the next slot, once the kernel that last wrote it is done. Throws `std::logic_error` if the handle of
+         * its previous call was neither waited for nor destroyed: its digests have not been read yet.
+         * @return the slot to pass to `slot` and `set_write`, to be released by the handle of the call
+         */
+        dword acquire(size_t bytes) {
+            if (bytes > slot_bytes_) {
+                throw std::length_error("pinned_digest_ring: the digests of a call exceed a slot");
+            }
+            const dword slot = next_;
+            if ((*in_use_)[slot]) {
+                throw std::logic_error("pinned_digest_ring: more calls in flight than slots, wait for the older handles");
+            }
+            next_ = (next_ + 1) % n_slots_;
+            writes_[slot].wait();
+            (*in_use_)[slot] = true;
+            return slot;
+        }
+
+        /**
+         * Flags of the slots held by a handle, for it to release them.
+         */
+        [[nodiscard]] inline const std::shared_ptr<std::vector<bool>> &in_use() const noexcept { return in_use_; }
+
+        /**
+         * Memory of the slots, kept alive by the handles until their kernels are done and their callbacks ran.
+         */
+        [[nodiscard]] inline const usm_shared_ptr<byte, alloc::host> &memory() const noexcept { return memory_; }
+
+        /**
+         * Records the kernel writing into a slot.
+         */
+        void set_write(dword slot, sycl::event e) { writes_[slot] = std::move(e); }
+
+        [[nodiscard]] inline byte *slot(dword slot) const noexcept { return memory_.raw() + slot * slot_bytes_; }
+
+        [[nodiscard]] inline dword n_slots() const noexcept { return n_slots_; }
+
+        [[nodiscard]] inline size_t slot_bytes() const noexcept { return slot_bytes_; }
+    };
+
+    /**
+     * Calls of `hasher::hash_pinned` in flight: the kernels, the device copies of the inputs that needed one, and the
+     * callbacks to run once the digests are in the ring. It owns a share of the memory its kernels use, so the hasher may
+     * be destroyed or its rings replaced before the handle is waited for. Not copyable.
+     */
+    class pinned_handle {
+    private:
+        std::vector<sycl::event> events_;
+        std::vector<usm_unique_ptr<byte, alloc::device>> inputs_;
+        std::vector<std::function<void()>> on_ready_;
+        std::vector<std::pair<std::shared_ptr<std::vector<bool>>, dword>> slots_;
+        std::vector<std::shared_ptr<const void>> owned_;
+
+        void release_slots() noexcept {
+            for (auto &[in_use, slot]: slots_) {
+                (*in_use)[slot] = false;
+            }
+            slots_.clear();
+        }
+
+    public:
+        pinned_handle() = default;
+
+        pinned_handle(pinned_handle &&) noexcept = default;
+
+        pinned_handle &operator=(pinned_handle &&other) noexcept {
+            std::swap(events_, other.events_);
+            std::swap(inputs_, other.inputs_);
+            std::swap(on_ready_, other.on_ready_);
+            std::swap(slots_, other.slots_);
+            std::swap(owned_, other.owned_);
+            return *this;
+        }
+
+        pinned_handle(const pinned_handle &) = delete;
+
+        pinned_handle &operator=(const pinned_handle &) = delete;
+
+        void add(sycl::event e, std::optional<usm_unique_ptr<byte, alloc::device>> input, std::function<void()> on_ready, const pinned_digest_ring &ring, dword slot) {
+            events_.emplace_back(std::move(e));
+            if (input) inputs_.emplace_back(std::move(*input));
+            on_ready_.emplace_back(std::move(on_ready));
+            slots_.emplace_back(ring.in_use(), slot);
+            owned_.emplace_back(ring.memory());
+        }
+
+        /**
+         * Keeps `memory` alive until the handle is waited for or destroyed, for memory read by the kernels and owned
+         * by the hasher.
+         */
+        void own(std::shared_ptr<const void> memory) { owned_.emplace_back(std::move(memory)); }
+
+        /**
+         * Waits for the kernels, frees the device copies of the inputs, then runs the callbacks in the order of the
+         * runners. The slots are released once the callbacks are done, even if one throws.
+         */
+        void wait() {
+            for (auto &e: events_) {
+                e.wait_and_throw();
+            }
+            events_.clear();
+            inputs_.clear();
+            auto on_ready = std::move(on_ready_);
+            on_ready_.clear();
+            try {
+                for (auto &f: on_ready) {
+                    f();
+                }
+            } catch (...) {
+                release_slots();
+                throw;
+            }
+            release_slots();
+            owned_.clear();
+        }
+
+        /**
+         * The kernels are joined before the memory they use is freed and the slots are released, the callbacks are
+         * not run.
+         */
+        ~pinned_handle() noexcept {
+            if (!events_.empty()) {
+                std::cerr << "Destroying a pinned_handle that still holds data. Did you forget to call .wait()?\n";
+                for (auto &e: events_) {
+                    try {
+                        e.wait_and_throw();
+                    }
+                    catch (std::exception const &ex) {
+                        std::cerr << "Caught asynchronous exception at pinned_handle destruction: " << ex.what() << std::endl;
+                    }
+                }
+            }
+            release_slots();
+        }
+    };
+
+    namespace internal {
+        /**
+         * Launches the kernel of the share of a runner, the items `first` to `first + count - 1`, with the digests
+         * written into the next slot of its ring. The input is copied to the device only if the queue cannot read it.
+         * @param on_ready `void(dword first, const byte *digests, dword count)`
+         */
+        template<method M, int n_outbit, typename Func, typename... buffers>
+        inline void hash_to_ring(pinned_handle &handle, sycl::queue &q, const byte *indata, dword inlen, dword first, dword count, pinned_digest_ring &ring,
+                                 const byte *key, dword keylen, Func on_ready, buffers... bufs) {
+            if (count == 0) {
+                return;
+            }
+            const dword slot = ring.acquire(get_block_size<M, n_outbit>() * count);
+            byte *digests = ring.slot(slot);
+            const byte *in = indata + (size_t) first * inlen;
+            std::optional<usm_unique_ptr<byte, alloc::device>> device_in;
+            sycl::event e{};
+            try {
+                if (inlen && !is_ptr_usable(in, q)) {
+                    device_in.emplace((size_t) inlen * count, q);
+                    e = q.memcpy(device_in->raw(), in, (size_t) inlen * count);
+                    in = device_in->raw();
+                }
+                e = dispatch_hash<M, n_outbit>(q, e, device_accessible_ptr<byte>(in), device_accessible_ptr<byte>(digests), inlen, count, key, keylen, bufs...);
+            } catch (...) {
+                (*ring.in_use())[slot] = false;
+                throw;
+            }
+            ring.set_write(slot, e);
+            handle.add(e, std::move(device_in), [on_ready, first, digests, count]() { on_ready(first, (const byte *) digests, count); }, ring, slot);
+        }
+    }
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "config.hpp"
+#include "../tools/usm_smart_ptr.hpp"
+
+namespace hash {
+
+    /**
+     * Where the items of a call are in the input. The default reads them one after the other, `inlen` bytes each.
+     */
+    struct input_layout {
+        size_t offset = 0; /** Bytes from the base to the first item, to read a field of an array of structures */
+        size_t stride = 0; /** Bytes from an item to the next. 0 packs them. It may be smaller than the length, items then overlap */
+    };
+
+    /**
+     * Input of a hashing kernel: where its items are. Built from the input pointer, which keeps the default layout.
+     * Trivially copyable, kernels capture it and read the items in place.
+     */
+    class record_input {
+    private:
+        const byte *base_;
+        input_layout layout_;
+
+    public:
+        record_input(usm_smart_ptr::device_accessible_ptr<byte> base, const input_layout &layout = {}) : base_(base), layout_(layout) {}
+
+        record_input(usm_smart_ptr::usm_ptr<byte, sycl::usm::alloc::shared> base) : record_input(usm_smart_ptr::device_accessible_ptr<byte>(base)) {}
+
+        record_input(usm_smart_ptr::usm_ptr<byte, sycl::usm::alloc::device> base) : record_input(usm_smart_ptr::device_accessible_ptr<byte>(base)) {}
+
+        [[nodiscard]] inline const byte *base() const noexcept { return base_; }
+
+        [[nodiscard]] inline const input_layout &layout() const noexcept { return layout_; }
+
+        /**
+         * Bytes spanned by `n_batch` items of `inlen` bytes, from `base() + layout().offset`.
+         */
+        [[nodiscard]] inline size_t span(dword inlen, dword n_batch) const noexcept {
+            if (n_batch == 0) return 0;
+            return (n_batch - 1) * (layout_.stride ? layout_.stride : inlen) + inlen;
+        }
+
+        /**
+         * First byte of `item`, read by the kernels.
+         */
+        [[nodiscard]] inline const byte *record(dword item, dword inlen) const noexcept {
+            return base_ + layout_.offset + (size_t) item * (layout_.stride ? layout_.stride : inlen);
+        }
+    };
+
+}
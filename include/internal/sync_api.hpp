@@ -24,7 +24,7 @@ namespace hash {
      * @param out Pointer to the output memory accessible by the HOST
      * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
      */
-    template<method M, typename = std::enable_if_t<M != method::keccak && M != method::sha3 && M != method::blake2b> >
+    template<method M, typename = std::enable_if_t<M != method::keccak && M != method::sha3 && M != method::blake2b && !is_keyed<M>()> >
     inline void compute(sycl::queue &q, const byte *in, dword inlen, byte *out, dword n_batch) {
         if (is_ptr_usable(in, q) && is_ptr_usable(out, q)) {
             internal::dispatch_hash<M, 0>(q, sycl::event{}, device_accessible_ptr<byte>(in), device_accessible_ptr<byte>(out), inlen, n_batch, nullptr, 0).wait();
@@ -33,6 +33,151 @@ namespace hash {
         }
     }
 
+    /**
+     * Computes synchronously a seeded hash.
+     * @tparam M Hash method, one for which `is_seeded<M>()` is true
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the HOST. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param out Pointer to the output memory accessible by the HOST
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     * @param seed Seed of the hash function
+     */
+    template<method M, typename = std::enable_if_t<is_seeded<M>()>>
+    inline void compute(sycl::queue &q, const byte *in, dword inlen, byte *out, dword n_batch, qword seed) {
+        auto key = internal::seed_to_key(seed);
+        if (is_ptr_usable(in, q) && is_ptr_usable(out, q)) {
+            internal::dispatch_hash<M, 0>(q, sycl::event{}, device_accessible_ptr<byte>(in), device_accessible_ptr<byte>(out), inlen, n_batch, key.data(), key.size()).wait();
+        } else {
+            internal::hash_with_data_copy<M, 0>({q, in, out, n_batch, inlen}, key.data(), key.size()).dev_e_.wait();
+        }
+    }
+
+    /**
+     * Computes synchronously a keyed hash.
+     * @tparam M Hash method, one for which `is_keyed<M>()` is true
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the HOST. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param out Pointer to the output memory accessible by the HOST
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     * @param key Key of `get_key_size<M>()` bytes
+     */
+    template<method M, typename = std::enable_if_t<is_keyed<M>()>>
+    inline void compute(sycl::queue &q, const byte *in, dword inlen, byte *out, dword n_batch, const byte *key, dword keylen) {
+        if (is_ptr_usable(in, q) && is_ptr_usable(out, q)) {
+            internal::dispatch_hash<M, 0>(q, sycl::event{}, device_accessible_ptr<byte>(in), device_accessible_ptr<byte>(out), inlen, n_batch, key, keylen).wait();
+        } else {
+            internal::hash_with_data_copy<M, 0>({q, in, out, n_batch, inlen}, key, keylen).dev_e_.wait();
+        }
+    }
+
+    /**
+     * Computes synchronously a hash of items read at an offset and stride, such as a field of an array of structures,
+     * keeping only the first `out_layout.width` bytes of each digest and writing them as `out_layout` says. The kernels
+     * read and write in place, and when a copy is needed only the bytes spanned by the items and the digests move.
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the HOST.
+     * @param inlen Size in bytes of one block to hash.
+     * @param out Pointer to the output memory accessible by the HOST
+     * @param n_batch Number of blocks to hash.
+     * @param in_layout Offset and stride of the items
+     * @param out_layout Width, offset, stride and arrangement of the digests. Throws `std::invalid_argument` if it does not fit.
+     * @param key Key of the method, or its seed as in `dispatch_hash`
+     */
+    template<method M, int n_outbit = 0>
+    inline void compute(sycl::queue &q, const byte *in, dword inlen, byte *out, dword n_batch, const input_layout &in_layout, const output_layout &out_layout,
+                        const byte *key = nullptr, dword keylen = 0) {
+        const record_input input(device_accessible_ptr<byte>(in), in_layout);
+        const digest_output output(device_accessible_ptr<byte>(out), out_layout);
+        output.check(get_block_size<M, n_outbit>(), n_batch);
+        if (n_batch == 0) {
+            return;
+        }
+        if (is_ptr_usable(in, q) && is_ptr_usable(out, q)) {
+            internal::dispatch_hash<M, n_outbit>(q, sycl::event{}, input, output, inlen, n_batch, key, keylen).wait();
+            return;
+        }
+        /* The copies start at the first item and the first digest, their layouts lose the offset */
+        const size_t in_span = input.span(inlen, n_batch), out_span = output.span(get_block_size<M, n_outbit>(), n_batch);
+        const byte *in_first = in + in_layout.offset;
+        byte *out_first = out + out_layout.offset;
+        output_layout device_out_layout = out_layout;
+        device_out_layout.offset = 0;
+        auto device_indata = usm_unique_ptr<byte, alloc::device>(in_span, q);
+        auto device_outdata = usm_unique_ptr<byte, alloc::device>(out_span, q);
+        sycl::event memcpy_in_e = in_span ? q.memcpy(device_indata.raw(), in_first, in_span) : sycl::event{};
+        if (output.has_gaps(get_block_size<M, n_outbit>(), n_batch)) {
+            q.memcpy(device_outdata.raw(), out_first, out_span).wait(); // The bytes between the digests are copied back unchanged
+        }
+        sycl::event submission_e = internal::dispatch_hash<M, n_outbit>(q, memcpy_in_e, record_input(device_indata.get(), input_layout{0, in_layout.stride}),
+                                                                         digest_output(device_outdata.get(), device_out_layout), inlen, n_batch, key, keylen);
+        memcpy_with_dependency(q, out_first, device_outdata.raw(), out_span, submission_e).wait();
+    }
+
+    /**
+     * Computes synchronously a hash, keeping only the first `layout.width` bytes of each digest and writing them
+     * as `layout` says. The kernels write the kept bytes only, and when a copy is needed only the bytes spanned by
+     * the digests come back from the device.
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the HOST. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param out Pointer to the output memory accessible by the HOST, `digest_output::span` bytes long
+     * @param n_batch Number of blocks to hash.
+     * @param layout Width, stride and arrangement of the digests. Throws `std::invalid_argument` if it does not fit.
+     * @param key Key of the method, or its seed as in `dispatch_hash`
+     */
+    template<method M, int n_outbit = 0>
+    inline void compute(sycl::queue &q, const byte *in, dword inlen, byte *out, dword n_batch, const output_layout &layout, const byte *key = nullptr, dword keylen = 0) {
+        compute<M, n_outbit>(q, in, inlen, out, n_batch, input_layout{}, layout, key, keylen);
+    }
+
+    /**
+     * Computes synchronously the bucket id `digest % n_buckets` of each item. The digests are never written out.
+     * @tparam M Hash method, one for which `has_bucket_mode<M>()` is true
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the HOST. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param buckets Pointer to the `n_batch` bucket ids, accessible by the HOST
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     * @param key Key of `get_key_size<M>()` bytes
+     * @param n_buckets Number of buckets, not 0
+     */
+    template<method M, typename = std::enable_if_t<has_bucket_mode<M>()>>
+    inline void compute_buckets(sycl::queue &q, const byte *in, dword inlen, dword *buckets, dword n_batch, const byte *key, dword keylen, dword n_buckets) {
+        if (is_ptr_usable(in, q) && is_ptr_usable(buckets, q)) {
+            internal::dispatch_hash<M, 0>(q, sycl::event{}, device_accessible_ptr<byte>(in), device_accessible_ptr<byte>((byte *) buckets), inlen, n_batch, key, keylen, n_buckets).wait();
+        } else {
+            auto device_indata = usm_unique_ptr<byte, alloc::device>(inlen * n_batch, q);
+            auto device_buckets = usm_unique_ptr<byte, alloc::device>(sizeof(dword) * n_batch, q);
+            sycl::event memcpy_in_e = inlen ? q.memcpy(device_indata.raw(), in, inlen * n_batch) : sycl::event{};
+            sycl::event submission_e = internal::dispatch_hash<M, 0>(q, memcpy_in_e, device_indata.get(), device_buckets.get(), inlen, n_batch, key, keylen, n_buckets);
+            memcpy_with_dependency(q, buckets, device_buckets.raw(), sizeof(dword) * n_batch, submission_e).wait();
+        }
+    }
+
+    /**
+     * Computes synchronously a hash of items whose length is known at compile time.
+     * The kernels have the length as a constant: loops have a fixed trip count and the padding is precomputed.
+     * The length must be registered in `internal::fixed_input_lengths`.
+     * @tparam M Hash method
+     * @tparam L fixed_len<N> where N is the size in bytes of one block to hash.
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the HOST. Contains an array of data.
+     * @param out Pointer to the output memory accessible by the HOST
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     */
+    template<method M, typename L, typename = std::enable_if_t<is_fixed_len_v<L>>>
+    inline void compute(sycl::queue &q, const byte *in, byte *out, dword n_batch) {
+        static_assert(has_fixed_length_kernels<M>(), "This method has no kernels specialised on the input length");
+        static_assert(internal::fixed_input_lengths::contains(L::value), "No kernel is instantiated for this length, add it to fixed_input_lengths");
+        compute<M>(q, in, L::value, out, n_batch);
+    }
+
     /**
      * Computes synchronously a hash.
      * @tparam M Hash method
@@ -84,12 +229,84 @@ namespace hash {
      * @param out Pointer to the output memory accessible by the QUEUE/CONTEXT PROVIDED
      * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
      */
-    template<method M, typename = std::enable_if_t<M != method::keccak && M != method::sha3 && M != method::blake2b>>
+    template<method M, typename = std::enable_if_t<M != method::keccak && M != method::sha3 && M != method::blake2b && !is_keyed<M>()>>
     inline void compute(sycl::queue &q, device_accessible_ptr<byte> indata, dword inlen, device_accessible_ptr<byte> outdata, dword n_batch) {
         internal::dispatch_hash<M, 0>(q, sycl::event{}, indata, outdata, inlen, n_batch, nullptr, 0).wait();
     }
 
 
+    /**
+     * Computes synchronously a seeded hash.
+     * This overload does not perform any memory operation. We assume memory is accessible in read and write by the
+     * device attached to the queue.
+     * @tparam M Hash method, one for which `is_seeded<M>()` is true
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the QUEUE/CONTEXT PROVIDED. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param out Pointer to the output memory accessible by the QUEUE/CONTEXT PROVIDED
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     * @param seed Seed of the hash function
+     */
+    template<method M, typename = std::enable_if_t<is_seeded<M>()>>
+    inline void compute(sycl::queue &q, device_accessible_ptr<byte> indata, dword inlen, device_accessible_ptr<byte> outdata, dword n_batch, qword seed) {
+        auto key = internal::seed_to_key(seed);
+        internal::dispatch_hash<M, 0>(q, sycl::event{}, indata, outdata, inlen, n_batch, key.data(), key.size()).wait();
+    }
+
+    /**
+     * Computes synchronously a keyed hash.
+     * This overload does not perform any memory operation. We assume memory is accessible in read and write by the
+     * device attached to the queue.
+     * @tparam M Hash method, one for which `is_keyed<M>()` is true
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the QUEUE/CONTEXT PROVIDED. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param out Pointer to the output memory accessible by the QUEUE/CONTEXT PROVIDED
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     * @param key Key of `get_key_size<M>()` bytes, in host memory
+     */
+    template<method M, typename = std::enable_if_t<is_keyed<M>()>>
+    inline void compute(sycl::queue &q, device_accessible_ptr<byte> indata, dword inlen, device_accessible_ptr<byte> outdata, dword n_batch, const byte *key, dword keylen) {
+        internal::dispatch_hash<M, 0>(q, sycl::event{}, indata, outdata, inlen, n_batch, key, keylen).wait();
+    }
+
+    /**
+     * Computes synchronously the bucket id `digest % n_buckets` of each item. The digests are never written out.
+     * This overload does not perform any memory operation. We assume memory is accessible in read and write by the
+     * device attached to the queue.
+     * @tparam M Hash method, one for which `has_bucket_mode<M>()` is true
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the QUEUE/CONTEXT PROVIDED. Contains an array of data.
+     * @param inlen Size in bytes of one block to hash.
+     * @param buckets Pointer to the `n_batch` bucket ids, in memory accessible by the QUEUE/CONTEXT PROVIDED
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     * @param key Key of `get_key_size<M>()` bytes, in host memory
+     * @param n_buckets Number of buckets, not 0
+     */
+    template<method M, typename = std::enable_if_t<has_bucket_mode<M>()>>
+    inline void compute_buckets(sycl::queue &q, device_accessible_ptr<byte> indata, dword inlen, device_accessible_ptr<byte> buckets, dword n_batch, const byte *key, dword keylen, dword n_buckets) {
+        internal::dispatch_hash<M, 0>(q, sycl::event{}, indata, buckets, inlen, n_batch, key, keylen, n_buckets).wait();
+    }
+
+    /**
+     * Computes synchronously a hash of items whose length is known at compile time.
+     * This overload does not perform any memory operation. We assume memory is accessible in read and write by the
+     * device attached to the queue.
+     * @tparam M Hash method
+     * @tparam L fixed_len<N> where N is the size in bytes of one block to hash.
+     * @param q Queue to run on
+     * @param in Pointer to the input data in any memory accessible by the QUEUE/CONTEXT PROVIDED. Contains an array of data.
+     * @param out Pointer to the output memory accessible by the QUEUE/CONTEXT PROVIDED
+     * @param n_batch Number of blocks to hash. In and Out pointers must have correct sizes.
+     */
+    template<method M, typename L, typename = std::enable_if_t<is_fixed_len_v<L>>>
+    inline void compute(sycl::queue &q, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword n_batch) {
+        static_assert(has_fixed_length_kernels<M>(), "This method has no kernels specialised on the input length");
+        static_assert(internal::fixed_input_lengths::contains(L::value), "No kernel is instantiated for this length, add it to fixed_input_lengths");
+        internal::dispatch_hash<M, 0>(q, sycl::event{}, indata, outdata, L::value, n_batch, nullptr, 0).wait();
+    }
+
+
     /**
      * Computes synchronously a hash.
      * This overload does not perform any memory operation. We assume memory is accessible in read and write by the
@@ -148,6 +365,24 @@ namespace hash {
 
     alias_sync_compute(compute_sha256, hash::method::sha256)
 
+    alias_sync_compute(compute_sha256d, hash::method::sha256d)
+
+    alias_sync_compute(compute_hash160, hash::method::hash160)
+
+    alias_sync_compute(compute_xxhash64, hash::method::xxhash64)
+
+    alias_sync_compute(compute_xxh3, hash::method::xxh3)
+
+    alias_sync_compute(compute_murmur3, hash::method::murmur3)
+
+    alias_sync_compute(compute_crc32c, hash::method::crc32c)
+
+    alias_sync_compute(compute_crc64nvme, hash::method::crc64nvme)
+
+    alias_sync_compute(compute_siphash, hash::method::siphash)
+
+    alias_sync_compute(compute_halfsiphash, hash::method::halfsiphash)
+
     alias_sync_compute_with_n_outbit(compute_sha3, hash::method::sha3)
 
     alias_sync_compute_with_n_outbit(compute_blake2b, hash::method::blake2b)
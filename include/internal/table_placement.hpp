@@ -0,0 +1,87 @@
+#pragma once
+
+#include <iterator>
+#include <type_traits>
+#include "config.hpp"
+#include "determine_kernel_config.hpp"
+#include "../tools/missing_implementations.hpp"
+
+namespace hash {
+    /**
+     * Where the kernels read their lookup tables (MD2 S-box, SHA-256 round constants) from.
+     */
+    enum class table_placement {
+        automatic /** Chosen from the device, see `internal::resolve_table_placement` */,
+        private_memory /** Each work-item reads the compile-time table, the compiler decides where it lives */,
+        local_memory /** Each work-group copies the table in local memory before hashing */,
+        constant_memory /** The table is bound as a constant buffer. The launch blocks until the kernel completes */
+    };
+}
+
+namespace hash::internal {
+
+    /**
+     * Kernel name of `name` running with a table placed in `placement`.
+     */
+    template<typename name, table_placement placement>
+    class table_kernel;
+
+    /**
+     * GPUs have fast local memory shared by the work-group while indexing a private table with runtime indices spills
+     * it. On CPUs the private table stays in the L1 cache and the barrier needed by local memory is pure overhead.
+     */
+    inline table_placement resolve_table_placement(const sycl::queue &q, table_placement placement) {
+        if (placement != table_placement::automatic) {
+            return placement;
+        }
+        return q.get_device().is_gpu() ? table_placement::local_memory : table_placement::private_memory;
+    }
+
+    /**
+     * Launches a one dimensional hashing kernel over `n_batch` items that reads the lookup table `table`.
+     * @tparam name kernel name, made unique per placement
+     * @tparam table array with static storage duration
+     * @param kernel called with the global id and something indexable that holds the table
+     */
+    template<typename name, auto &table, typename Func>
+    inline sycl::event launch_with_table(sycl::queue &q, sycl::event e, table_placement placement, dword n_batch, Func kernel) {
+        using T = std::remove_const_t<std::remove_reference_t<decltype(table[0])>>;
+        constexpr size_t table_size = std::size(table);
+        auto config = get_kernel_sizes(q, n_batch);
+        sycl::nd_range<1> range(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size));
+
+        switch (resolve_table_placement(q, placement)) {
+            case table_placement::local_memory:
+                return q.submit([&](sycl::handler &cgh) {
+                    cgh.depends_on(e);
+                    local_accessor<T, 1> local_table(sycl::range<1>(table_size), cgh);
+                    cgh.parallel_for<table_kernel<name, table_placement::local_memory>>(range, [=](sycl::nd_item<1> item) {
+                        for (size_t i = item.get_local_linear_id(); i < table_size; i += item.get_local_range(0)) {
+                            local_table[i] = table[i];
+                        }
+                        /* Every work-item must reach the barrier, the bound check on the batch is done afterwards */
+                        item.barrier(sycl::access::fence_space::local_space);
+                        kernel(item.get_global_linear_id(), local_table);
+                    });
+                });
+            case table_placement::constant_memory: {
+                sycl::buffer<T, 1> table_buffer(std::data(table), sycl::range<1>(table_size));
+                return q.submit([&](sycl::handler &cgh) {
+                    cgh.depends_on(e);
+                    auto constant_table = table_buffer.template get_access<sycl::access::mode::read, sycl::access::target::constant_buffer>(cgh);
+                    cgh.parallel_for<table_kernel<name, table_placement::constant_memory>>(range, [=](sycl::nd_item<1> item) {
+                        kernel(item.get_global_linear_id(), constant_table);
+                    });
+                });
+            }
+            default:
+                return q.submit([&](sycl::handler &cgh) {
+                    cgh.depends_on(e);
+                    cgh.parallel_for<table_kernel<name, table_placement::private_memory>>(range, [=](sycl::nd_item<1> item) {
+                        kernel(item.get_global_linear_id(), table);
+                    });
+                });
+        }
+    }
+
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include "file_reader.hpp"
+#include "../internal/common.hpp"
+#include "../tools/host_registration.hpp"
+#include "../tools/missing_implementations.hpp"
+#include "../tools/usm_smart_ptr.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace hash {
+    using namespace usm_smart_ptr;
+
+    /**
+     * A hash method picked at runtime: the size of its digests and the launch of its kernel on device memory.
+     */
+    struct file_hash_function {
+        dword digest_size;
+        std::function<sycl::event(sycl::queue &, sycl::event, device_accessible_ptr<byte>, device_accessible_ptr<byte>, dword, dword)> launch;
+    };
+
+    /**
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     * @param key key of the method if it needs one, or the seed bytes of a seeded method. It is copied.
+     */
+    template<method M, int n_outbit = 0>
+    inline file_hash_function make_file_hash_function(const byte *key = nullptr, dword keylen = 0) {
+        std::vector<byte> key_bytes(key, key + keylen);
+        return {(dword) get_block_size<M, n_outbit>(),
+                [key_bytes](sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch) {
+                    return internal::dispatch_hash<M, n_outbit>(q, e, indata, outdata, inlen, n_batch, key_bytes.empty() ? nullptr : key_bytes.data(), (dword) key_bytes.size());
+                }};
+    }
+
+    /**
+     * The reader options select how the files are read, `file_reader_options`.
+     */
+    struct file_hash_options : file_reader_options {
+        size_t small_file_bytes = 1 << 20; // Files up to this size are hashed in batches, the bigger ones one by one
+        size_t batch_bytes = 64 << 20; // Content of a batch of small files
+        dword batch_files = 1 << 16; // Number of files of a batch
+    };
+
+    /**
+     * Hashes whole files. A `file_source` maps or reads them ahead, within a memory budget, while the small files
+     * are packed in batches: one copy to the device, a kernel per distinct file size, and one copy back. A batch is
+     * hashed as soon as the readers have nothing new, so reading and hashing overlap. On CPU and host devices the
+     * kernels read the packed batches and the big files in place, see `host_registration`, without device copies.
+     * The kernels hash an item of at most 4 GiB, bigger files are reported as errors.
+     * @param on_digest `void(size_t index, const byte *digest, const std::string &error)` called for each path, in no
+     * particular order, with a null digest and the error when the file could not be hashed
+     */
+    template<typename Func>
+    void hash_files(sycl::queue &q, const file_hash_function &function, const std::vector<std::string> &paths, const file_hash_options &options, Func &&on_digest) {
+        const size_t batch_bytes = std::max(options.batch_bytes, options.small_file_bytes);
+        const dword batch_files = std::max<dword>(1, options.batch_files);
+        const dword digest_size = function.digest_size;
+        auto reader = make_file_source(paths, options);
+        std::vector<byte> staging(batch_bytes);
+        std::vector<byte> digests((size_t) digest_size * batch_files);
+        host_registration staging_registration(staging.data(), staging.size(), q);
+        host_registration digests_registration(digests.data(), digests.size(), q);
+        const bool in_place = staging_registration.in_place() && digests_registration.in_place();
+        auto device_batch = usm_unique_ptr<byte, alloc::device>(in_place ? 1 : std::max<size_t>(1, batch_bytes), q);
+        auto device_digests = usm_unique_ptr<byte, alloc::device>(in_place ? 1 : digests.size(), q);
+        byte *batch_in = in_place ? staging.data() : device_batch.raw();
+        byte *digests_out = in_place ? digests.data() : device_digests.raw();
+        std::vector<loaded_file> batch;
+        size_t batched_bytes = 0;
+
+        auto flush = [&]() {
+            if (batch.empty()) return;
+            std::sort(batch.begin(), batch.end(), [](const loaded_file &a, const loaded_file &b) { return a.contents.size() < b.contents.size(); });
+            std::vector<size_t> sizes(batch.size());
+            size_t offset = 0;
+            for (size_t i = 0; i < batch.size(); ++i) {
+                sizes[i] = batch[i].contents.size();
+                std::memcpy(staging.data() + offset, batch[i].contents.data(), sizes[i]);
+                offset += sizes[i];
+                reader->release(batch[i]);
+            }
+            sycl::event copy_e = offset && !in_place ? q.memcpy(device_batch.raw(), staging.data(), offset) : sycl::event{};
+
+            /* Same sized files are contiguous after the sort */
+            std::vector<sycl::event> kernels;
+            offset = 0;
+            for (size_t first = 0, last; first < batch.size(); first = last) {
+                const size_t size = sizes[first];
+                for (last = first; last < batch.size() && sizes[last] == size; ++last);
+                kernels.emplace_back(function.launch(q, copy_e, device_accessible_ptr<byte>(batch_in + offset),
+                                                     device_accessible_ptr<byte>(digests_out + first * digest_size), (dword) size, (dword) (last - first)));
+                offset += size * (last - first);
+            }
+            if (in_place) {
+                for (auto &e: kernels) e.wait();
+            } else {
+                memcpy_with_dependency(q, digests.data(), device_digests.raw(), (size_t) digest_size * batch.size(), kernels).wait();
+            }
+            for (size_t i = 0; i < batch.size(); ++i) {
+                on_digest(batch[i].index, digests.data() + i * digest_size, std::string{});
+            }
+            batch.clear();
+            batched_bytes = 0;
+        };
+
+        auto hash_alone = [&](loaded_file &file) {
+            const size_t size = file.contents.size();
+            if (size > std::numeric_limits<dword>::max()) {
+                reader->release(file);
+                on_digest(file.index, nullptr, paths[file.index] + ": File too large");
+                return;
+            }
+            host_registration registration(file.contents.data(), size, q);
+            if (in_place) {
+                /* Straight from the mapping or the reader's buffer */
+                function.launch(q, sycl::event{}, device_accessible_ptr<byte>(file.contents.data()), device_accessible_ptr<byte>(digests.data()), (dword) size, 1).wait();
+            } else {
+                auto device_in = usm_unique_ptr<byte, alloc::device>(size, q);
+                sycl::event e = q.memcpy(device_in.raw(), file.contents.data(), size);
+                e = function.launch(q, e, device_in.get(), device_digests.get(), (dword) size, 1);
+                memcpy_with_dependency(q, digests.data(), device_digests.raw(), digest_size, e).wait();
+            }
+            reader->release(file);
+            on_digest(file.index, digests.data(), std::string{});
+        };
+
+        loaded_file file;
+        for (;;) {
+            if (!reader->next(file, false)) {
+                flush();
+                if (!reader->next(file, true)) break;
+            }
+            if (!file.error.empty()) {
+                on_digest(file.index, nullptr, file.error);
+            } else if (file.contents.size() > options.small_file_bytes) {
+                hash_alone(file);
+            } else {
+                if (batched_bytes + file.contents.size() > batch_bytes || batch.size() == batch_files) {
+                    flush();
+                }
+                batched_bytes += file.contents.size();
+                batch.emplace_back(std::move(file));
+            }
+        }
+        flush();
+    }
+
+}
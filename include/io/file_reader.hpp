@@ -0,0 +1,174 @@
+#pragma once
+
+#include "../internal/config.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hash {
+
+    constexpr size_t FILE_READ_ALIGNMENT = 4096; // Page and sector size, buffers and offsets of direct reads are aligned on it
+    constexpr size_t FILE_READ_CHUNK_BYTES = 8 << 20; // Size of the reads when a file is not mapped
+
+    /**
+     * How files are brought to memory.
+     */
+    enum class file_io {
+        mapped, /** mmap by a pool of threads, the page cache is used */
+        pread, /** O_DIRECT reads into aligned buffers by a pool of threads, when the file system allows it */
+        io_uring /** O_DIRECT reads kept in flight with io_uring into registered buffers, pread if io_uring is unavailable */
+    };
+
+    struct file_reader_options {
+        file_io io = file_io::mapped;
+        size_t n_readers = 4; // Threads reading the files, mapped and pread
+        size_t memory_budget = 512 << 20; // Host memory of the files read ahead, the io_uring slots apart
+        dword queue_depth = 64; // Reads in flight, io_uring
+        size_t slot_bytes = 1 << 20; // Size of the registered buffers, files up to this size are read in one of them, io_uring
+        dword n_slots = 128; // Number of registered buffers, io_uring
+    };
+
+    /**
+     * Content of a file in host memory: mapped read-only, read in an aligned buffer, or a view of a buffer owned by a
+     * reader. Movable, not copyable.
+     */
+    class file_contents {
+    private:
+        enum class storage {
+            view, mapped, allocated
+        };
+        byte *data_ = nullptr;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+        storage storage_ = storage::view;
+
+        void reset() noexcept;
+
+        void reserve(size_t capacity);
+
+        friend class uring_file_reader;
+
+    public:
+        file_contents() = default;
+
+        file_contents(const file_contents &) = delete;
+
+        file_contents &operator=(const file_contents &) = delete;
+
+        file_contents(file_contents &&other) noexcept;
+
+        file_contents &operator=(file_contents &&other) noexcept;
+
+        ~file_contents() { reset(); }
+
+        /**
+         * Maps a regular file, or reads it when it cannot be mapped (pipes, standard input for the path "-", file
+         * systems without mmap). Throws `std::system_error` when it cannot be opened or read.
+         */
+        static file_contents load(const std::string &path);
+
+        /**
+         * Reads a file with large aligned reads, bypassing the page cache with O_DIRECT when the file system allows it.
+         * Throws `std::system_error` when it cannot be opened or read.
+         */
+        static file_contents read(const std::string &path);
+
+        /**
+         * Non owning view of memory that outlives it.
+         */
+        static file_contents view(const byte *data, size_t size);
+
+        [[nodiscard]] inline const byte *data() const noexcept { return data_; }
+
+        [[nodiscard]] inline size_t size() const noexcept { return size_; }
+
+        [[nodiscard]] inline bool is_mapped() const noexcept { return storage_ == storage::mapped; }
+    };
+
+    /**
+     * A file loaded by a `file_source`, `error` being set when it could not be loaded.
+     */
+    struct loaded_file {
+        size_t index; /** Index of the path in the list given to the source */
+        file_contents contents;
+        std::string error;
+    };
+
+    /**
+     * Loads a list of files ahead of their consumer, within a memory budget. Files are handed out in the order they
+     * finish loading.
+     */
+    class file_source {
+    public:
+        virtual ~file_source() = default;
+
+        /**
+         * Gets the next loaded file, waiting for one if `wait`.
+         * @return false when no file is ready or, when waiting, when all the files were handed out
+         */
+        virtual bool next(loaded_file &file, bool wait) = 0;
+
+        /**
+         * Gives back the memory of a file handed out, once its content is no longer needed. Clears its content.
+         */
+        virtual void release(loaded_file &file) = 0;
+    };
+
+    /**
+     * Threads loading files with `file_contents::load` (mapped) or `file_contents::read` (pread), while the files
+     * handed out and not released yet stay under the memory budget. A file bigger than the budget is loaded once
+     * everything else is released.
+     */
+    class file_reader_pool : public file_source {
+    private:
+        const std::vector<std::string> paths_;
+        const size_t budget_;
+        const bool direct_;
+        std::mutex mutex_;
+        std::condition_variable ready_cv_;
+        std::condition_variable budget_cv_;
+        std::deque<loaded_file> ready_;
+        size_t next_path_ = 0;
+        size_t held_bytes_ = 0;
+        size_t handed_out_ = 0;
+        bool stopping_ = false;
+        std::vector<std::thread> threads_;
+
+        void read_loop();
+
+    public:
+        /**
+         * @param io `file_io::mapped` or `file_io::pread`
+         */
+        file_reader_pool(std::vector<std::string> paths, file_io io, size_t n_threads, size_t memory_budget);
+
+        file_reader_pool(const file_reader_pool &) = delete;
+
+        file_reader_pool &operator=(const file_reader_pool &) = delete;
+
+        ~file_reader_pool() override;
+
+        bool next(loaded_file &file, bool wait) override;
+
+        void release(loaded_file &file) override;
+    };
+
+    namespace internal {
+        /**
+         * @return the io_uring reader, or null when the kernel refuses to set up a ring. Only built with USE_IO_URING.
+         */
+        std::unique_ptr<file_source> make_uring_file_reader(const std::vector<std::string> &paths, const file_reader_options &options);
+    }
+
+    /**
+     * Creates the reader of `options.io`. When io_uring cannot be set up (kernel without it, forbidden by a seccomp
+     * profile, library built without USE_IO_URING), the files are read by a pread pool instead.
+     */
+    std::unique_ptr<file_source> make_file_source(std::vector<std::string> paths, const file_reader_options &options);
+
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "digest_chunks.hpp"
+#include "staging.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace hash {
+    namespace internal {
+        class bloom_insert_kernel;
+
+        class bloom_query_kernel;
+
+        /**
+         * Sets the `n_hashes` bits of each digest, derived by double hashing, with atomics.
+         */
+        sycl::event
+        launch_bloom_insert_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword n_items, device_accessible_ptr<dword> bits, qword n_bits, dword n_hashes);
+
+        /**
+         * Sets bit `first + i` of the bitmap when all the bits of digest `i` are set. The bitmap must be zeroed.
+         */
+        sycl::event
+        launch_bloom_query_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword n_items, device_accessible_ptr<dword> bits, qword n_bits, dword n_hashes,
+                                  device_accessible_ptr<dword> bitmap, dword first);
+    }
+
+    /**
+     * Size of the bit array and number of bits set per item.
+     */
+    struct bloom_filter_params {
+        qword n_bits;
+        dword n_hashes;
+    };
+
+    /**
+     * Smallest filter reaching a false positive rate once `n_items` are inserted: m = -n ln(p) / ln(2)^2 and
+     * k = m / n ln(2). No items is sized as one, a rate outside (0, 1) throws `std::invalid_argument`.
+     */
+    inline bloom_filter_params optimal_bloom_filter_params(qword n_items, double false_positive_rate) {
+        if (!(false_positive_rate > 0 && false_positive_rate < 1)) {
+            throw std::invalid_argument("optimal_bloom_filter_params: the false positive rate must be in (0, 1)");
+        }
+        n_items = std::max<qword>(1, n_items);
+        const double ln2 = std::log(2.0);
+        double n_bits = std::ceil(-(double) n_items * std::log(false_positive_rate) / (ln2 * ln2));
+        double n_hashes = std::round(n_bits / (double) n_items * ln2);
+        return {std::max<qword>(32, (qword) n_bits), std::max<dword>(1, (dword) n_hashes)};
+    }
+
+    /**
+     * Bloom filter whose bit array stays in device memory. The items are hashed with `M` by the usual kernels, then
+     * each digest gives its `n_hashes` bit indices by double hashing.
+     * Digests of at least 16 bytes are used as they are, shorter ones are extended (see `src/sketches/digest_words.hpp`).
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     */
+    template<method M, int n_outbit = 0>
+    class bloom_filter {
+    private:
+        sycl::queue q_;
+        bloom_filter_params params_;
+        std::vector<byte> key_;
+        usm_unique_ptr<dword, alloc::device> bits_;
+
+    public:
+        /**
+         * @param key key of the hash method if it needs one, or the seed bytes of a seeded method
+         */
+        bloom_filter(sycl::queue q, bloom_filter_params params, const byte *key = nullptr, dword keylen = 0) :
+                q_(std::move(q)),
+                params_(params),
+                key_(key, key + keylen),
+                bits_((params.n_bits + 31) / 32, q_) {
+            clear();
+        }
+
+        [[nodiscard]] inline bloom_filter_params params() const noexcept { return params_; }
+
+        /**
+         * Device pointer to the `(n_bits + 31) / 32` words of the bit array, bit `i` being bit `i % 32` of word `i / 32`.
+         */
+        [[nodiscard]] inline device_accessible_ptr<dword> bits() const noexcept { return bits_.get(); }
+
+        void clear() {
+            q_.memset(bits_.raw(), 0, bits_.alloc_size()).wait();
+        }
+
+        /**
+         * Inserts `n_batch` items of `inlen` bytes.
+         * @param in host or device memory
+         */
+        void insert(const byte *in, dword inlen, dword n_batch) {
+            internal::hash_in_chunks<M, n_outbit>(q_, in, inlen, n_batch, key_.data(), (dword) key_.size(), [&](sycl::event e, device_accessible_ptr<byte> digests, dword, dword n) {
+                return internal::launch_bloom_insert_kernel(q_, e, digests, get_block_size<M, n_outbit>(), n, bits_.get(), params_.n_bits, params_.n_hashes);
+            });
+        }
+
+        /**
+         * Looks `n_batch` items of `inlen` bytes up. Bit `i % 32` of `bitmap[i / 32]` is set when item `i` may have been
+         * inserted, cleared when it was not.
+         * @param in host or device memory
+         * @param bitmap `(n_batch + 31) / 32` words in host or device memory
+         */
+        void query(const byte *in, dword inlen, dword n_batch, dword *bitmap) {
+            const size_t bitmap_words = (n_batch + 31) / 32;
+            internal::staged_buffer<dword> out(q_, bitmap, bitmap_words, false);
+            q_.memset(out.get(), 0, sizeof(dword) * bitmap_words).wait();
+            internal::hash_in_chunks<M, n_outbit>(q_, in, inlen, n_batch, key_.data(), (dword) key_.size(), [&](sycl::event e, device_accessible_ptr<byte> digests, dword first, dword n) {
+                return internal::launch_bloom_query_kernel(q_, e, digests, get_block_size<M, n_outbit>(), n, bits_.get(), params_.n_bits, params_.n_hashes, device_accessible_ptr<dword>(out.get()), first);
+            });
+            out.copy_back(q_);
+        }
+
+        /**
+         * Copies the bit array to the host, to save it or to merge filters.
+         */
+        [[nodiscard]] std::vector<dword> get_bits() const {
+            std::vector<dword> bits(bits_.alloc_count());
+            sycl::queue q = q_;
+            q.memcpy(bits.data(), bits_.raw(), bits_.alloc_size()).wait();
+            return bits;
+        }
+    };
+
+}
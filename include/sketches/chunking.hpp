@@ -0,0 +1,182 @@
+#pragma once
+
+#include "../internal/common.hpp"
+#include "../internal/table_placement.hpp"
+#include "scan.hpp"
+#include "staging.hpp"
+
+#include <array>
+#include <vector>
+
+namespace hash {
+    namespace internal {
+        class cdc_count_kernel;
+
+        class cdc_candidates_kernel;
+
+        class cdc_select_kernel;
+
+        class cdc_sha256_kernel;
+
+        constexpr size_t CDC_SEGMENT_BYTES = 16 << 10; // Bytes scanned by each work-item
+        constexpr dword GEAR_WINDOW = 64; // The Gear hash at a byte only depends on the 64 bytes up to it
+
+        constexpr std::array<qword, 256> make_gear_table() {
+            std::array<qword, 256> table{};
+            qword z = 0;
+            for (auto &entry: table) {
+                z += 0x9e3779b97f4a7c15;
+                qword x = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+                entry = x ^ (x >> 31);
+            }
+            return table;
+        }
+
+        /**
+         * Counts the cut point candidates of each segment of `CDC_SEGMENT_BYTES`: the positions after a byte whose Gear
+         * hash has the bits of `mask_large` clear. Each segment first rolls the hash over the 63 bytes before it, so
+         * segments scan independently and find the same hashes as a sequential scan.
+         */
+        sycl::event
+        launch_cdc_count_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, qword len, qword mask_large, table_placement placement, device_accessible_ptr<qword> counts);
+
+        /**
+         * Writes the candidates of each segment from `offsets[segment]`, in increasing order, as `cut << 1 | strict`,
+         * `strict` telling whether the hash also has the bits of `mask_small` clear.
+         */
+        sycl::event
+        launch_cdc_candidates_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, qword len, qword mask_small, qword mask_large, table_placement placement,
+                                     device_accessible_ptr<qword> offsets, device_accessible_ptr<qword> candidates);
+
+        /**
+         * Picks the cut points among the candidates, one chunk after another, on a single work-item: the first strict
+         * candidate at least `min_size` bytes after the start of the chunk and before `avg_size`, then the first one
+         * until `max_size`. Writes the `n_chunks + 1` bounds of the chunks and `n_chunks`.
+         */
+        sycl::event
+        launch_cdc_select_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> candidates, qword n_candidates, qword len, dword min_size, dword avg_size, dword max_size,
+                                 device_accessible_ptr<qword> bounds, device_accessible_ptr<qword> n_chunks);
+
+        /**
+         * SHA-256 of the ragged chunks `indata[bounds[i]]` to `indata[bounds[i + 1] - 1]`.
+         */
+        sycl::event
+        launch_cdc_sha256_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> bounds, dword n_chunks, table_placement placement,
+                                 device_accessible_ptr<byte> digests);
+    }
+
+    /**
+     * Random table of the Gear rolling hash `h = (h << 1) + GEAR_TABLE[byte]`.
+     */
+    inline constexpr std::array<qword, 256> GEAR_TABLE = internal::make_gear_table();
+
+    /**
+     * Sizes of the content defined chunks. `avg_size` is rounded down to a power of two.
+     */
+    struct cdc_params {
+        dword min_size = 2 << 10;
+        dword avg_size = 8 << 10;
+        dword max_size = 64 << 10;
+    };
+
+    /**
+     * A content defined chunk of a buffer and its digest.
+     */
+    template<method M>
+    struct content_chunk {
+        qword offset;
+        dword length;
+        std::array<byte, get_block_size<M>()> digest;
+    };
+
+    namespace internal {
+        /**
+         * FastCDC masks with normalised chunking (level 2): the `log2(avg_size) + 2` and `log2(avg_size) - 2` highest
+         * bits of the hash, which depend on the whole window.
+         */
+        inline void cdc_masks(const cdc_params &params, qword &mask_small, qword &mask_large) {
+            dword bits = 0;
+            while ((2u << bits) <= params.avg_size) ++bits;
+            const dword bits_small = std::min<dword>(bits + 2, 63);
+            const dword bits_large = std::max<dword>(bits, 3) - 2;
+            mask_small = ~0ull << (64 - bits_small);
+            mask_large = ~0ull << (64 - bits_large);
+        }
+
+        /**
+         * Finds the chunks of `len` bytes in device memory. Returns their number, `bounds` receiving their
+         * `n_chunks + 1` bounds.
+         */
+        inline qword cut_on_device(sycl::queue &q, device_accessible_ptr<byte> indata, qword len, const cdc_params &params, table_placement placement,
+                                   usm_unique_ptr<qword, alloc::device> &bounds) {
+            qword mask_small, mask_large;
+            cdc_masks(params, mask_small, mask_large);
+            const dword min_size = std::max<dword>(1, params.min_size);
+            const dword max_size = std::max(min_size, params.max_size);
+            const size_t n_segments = std::max<size_t>(1, (len + CDC_SEGMENT_BYTES - 1) / CDC_SEGMENT_BYTES);
+            auto counts = usm_unique_ptr<qword, alloc::device>(n_segments, q);
+            auto totals = usm_unique_ptr<qword, alloc::device>(n_segments + 1, q);
+            auto e = launch_cdc_count_kernel(q, sycl::event{}, indata, len, mask_large, placement, counts.get());
+            e = launch_exclusive_scan_kernel(q, e, counts.get(), n_segments, 1, totals.get());
+            qword n_candidates;
+            memcpy_with_dependency(q, &n_candidates, totals.raw() + n_segments, sizeof(qword), e).wait();
+
+            auto candidates = usm_unique_ptr<qword, alloc::device>(std::max<qword>(1, n_candidates), q);
+            auto n_chunks = usm_unique_ptr<qword, alloc::device>(1, q);
+            bounds = usm_unique_ptr<qword, alloc::device>(len / min_size + 2, q);
+            e = launch_cdc_candidates_kernel(q, sycl::event{}, indata, len, mask_small, mask_large, placement, counts.get(), candidates.get());
+            e = launch_cdc_select_kernel(q, e, candidates.get(), n_candidates, len, min_size, params.avg_size, max_size, bounds.get(), n_chunks.get());
+            qword result;
+            memcpy_with_dependency(q, &result, n_chunks.raw(), sizeof(qword), e).wait();
+            return result;
+        }
+    }
+
+    /**
+     * Content defined chunking of a buffer with FastCDC: the cut points only depend on the content around them, so an
+     * insertion only changes the chunks around it. Every position is hashed in parallel by segments, then the cut points
+     * are picked on the device.
+     * @param in host or device memory
+     * @return the `n_chunks + 1` bounds of the chunks, 0 first and `len` last
+     */
+    inline std::vector<qword> content_defined_chunks(sycl::queue &q, const byte *in, qword len, const cdc_params &params = {}, table_placement placement = table_placement::automatic) {
+        if (len == 0) return {0};
+        internal::staged_buffer<const byte> data(q, in, len);
+        usm_unique_ptr<qword, alloc::device> bounds(1, q);
+        qword n_chunks = internal::cut_on_device(q, device_accessible_ptr<byte>(data.get()), len, params, placement, bounds);
+        std::vector<qword> result(n_chunks + 1);
+        q.memcpy(result.data(), bounds.raw(), sizeof(qword) * result.size()).wait();
+        return result;
+    }
+
+    /**
+     * Cuts a buffer in content defined chunks (see `content_defined_chunks`) and hashes the chunks on the device,
+     * without the chunks going back to the host in between.
+     * @tparam M Hash method of the chunks, SHA-256
+     * @param in host or device memory
+     */
+    template<method M, typename = std::enable_if_t<M == method::sha256>>
+    std::vector<content_chunk<M>> chunk_and_hash(sycl::queue &q, const byte *in, qword len, const cdc_params &params = {}, table_placement placement = table_placement::automatic) {
+        if (len == 0) return {};
+        constexpr dword digest_size = get_block_size<M>();
+        internal::staged_buffer<const byte> data(q, in, len);
+        usm_unique_ptr<qword, alloc::device> bounds(1, q);
+        auto n_chunks = (dword) internal::cut_on_device(q, device_accessible_ptr<byte>(data.get()), len, params, placement, bounds);
+        auto digests = usm_unique_ptr<byte, alloc::device>((size_t) digest_size * n_chunks, q);
+        internal::launch_cdc_sha256_kernel(q, sycl::event{}, device_accessible_ptr<byte>(data.get()), bounds.get(), n_chunks, placement, digests.get()).wait();
+
+        std::vector<qword> offsets(n_chunks + 1);
+        std::vector<byte> host_digests(digests.alloc_size());
+        q.memcpy(offsets.data(), bounds.raw(), sizeof(qword) * offsets.size()).wait();
+        q.memcpy(host_digests.data(), digests.raw(), digests.alloc_size()).wait();
+        std::vector<content_chunk<M>> chunks(n_chunks);
+        for (dword i = 0; i < n_chunks; ++i) {
+            chunks[i].offset = offsets[i];
+            chunks[i].length = (dword) (offsets[i + 1] - offsets[i]);
+            std::copy_n(host_digests.begin() + (long) i * digest_size, digest_size, chunks[i].digest.begin());
+        }
+        return chunks;
+    }
+
+}
@@ -0,0 +1,271 @@
+#pragma once
+
+#include "../internal/common.hpp"
+#include "sketch_method.hpp"
+#include "staging.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace hash {
+
+    /**
+     * An item of a batch and its estimated count.
+     */
+    struct heavy_hitter {
+        dword index /** Index of the item in the batch */;
+        dword count;
+    };
+
+    namespace internal {
+        template<method M>
+        class cms_add_kernel;
+
+        template<method M>
+        class cms_estimate_kernel;
+
+        template<method M>
+        class cms_distinct_kernel;
+
+        class cms_count_above_kernel;
+
+        class cms_select_kernel;
+
+        class cms_accumulate_kernel;
+
+        /**
+         * Increments, with atomics, the counter of each item in each of the `depth` rows. Row `r` hashes the items with
+         * the seed `cms_row_seed(seed, r)`. The counters saturate at 2^32 - 1.
+         * @param counters `depth * width` dwords, row after row
+         */
+        sycl::event
+        launch_cms_add_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, dword width, dword depth,
+                              device_accessible_ptr<dword> counters);
+
+        /**
+         * Estimated count of each item: the minimum of its counters.
+         */
+        sycl::event
+        launch_cms_estimate_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, dword width, dword depth,
+                                   device_accessible_ptr<dword> counters, device_accessible_ptr<dword> estimates);
+
+        /**
+         * Zeroes the estimate of every repeated item but one, found by inserting 64-bit fingerprints in an open
+         * addressing set of `set_size` (a power of two, at least twice `n_batch`) zeroed words.
+         */
+        sycl::event
+        launch_cms_distinct_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, device_accessible_ptr<qword> set,
+                                   qword set_size, device_accessible_ptr<dword> estimates);
+
+        /**
+         * Adds to `count` the number of estimates greater than or equal to `threshold`.
+         */
+        sycl::event
+        launch_cms_count_above_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> estimates, dword n_batch, dword threshold, device_accessible_ptr<dword> count);
+
+        /**
+         * Compacts the items whose estimate is above `threshold` at the beginning of `out` and the ones equal to it
+         * after the first `n_above` slots, up to `capacity` slots. `counts` holds the two numbers of items written.
+         */
+        sycl::event
+        launch_cms_select_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> estimates, dword n_batch, dword threshold, dword n_above, dword capacity,
+                                 device_accessible_ptr<heavy_hitter> out, device_accessible_ptr<dword> counts);
+
+        /**
+         * `dst[i] += src[i]`, saturating at 2^32 - 1, to merge sketches.
+         */
+        sycl::event
+        launch_cms_accumulate_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> dst, device_accessible_ptr<dword> src, size_t n);
+    }
+
+    /**
+     * Count-Min sketch of a stream of items hashed with `M`: `depth` rows of `width` counters living in device memory.
+     * Estimates never undercount, and overcount by at most `e * n / width` with probability `1 - exp(-depth)` after
+     * `n` items. The counters are 32-bit and saturate: an estimate of 2^32 - 1 means at least that many occurrences.
+     * Like `hasher`, the items are split between the runners and each runner counts in its own sketch. They are summed
+     * on the first runner before any query.
+     * @tparam M Hash method, see `is_sketch_method`
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    class count_min_sketch {
+    private:
+        runners runners_;
+        dword width_;
+        dword depth_;
+        qword seed_;
+        std::vector<usm_unique_ptr<dword, alloc::device>> counters_;
+
+        [[nodiscard]] inline size_t size() const noexcept { return (size_t) width_ * depth_; }
+
+        /**
+         * Adds the counters of `src`, in memory the first runner can read, to the first runner's sketch.
+         */
+        void accumulate(const dword *src) {
+            sycl::queue &q = runners_[0].q;
+            internal::staged_buffer<const dword> staged(q, src, size());
+            internal::launch_cms_accumulate_kernel(q, sycl::event{}, counters_[0].get(), device_accessible_ptr<dword>(staged.get()), size()).wait();
+        }
+
+        /**
+         * Sums the sketches of the other runners into the first one.
+         */
+        void gather() {
+            std::vector<dword> counters(size());
+            for (size_t i = 1; i < runners_.size(); ++i) {
+                runners_[i].q.memcpy(counters.data(), counters_[i].raw(), counters_[i].alloc_size()).wait();
+                runners_[i].q.memset(counters_[i].raw(), 0, counters_[i].alloc_size()).wait();
+                accumulate(counters.data());
+            }
+        }
+
+    public:
+        /**
+         * @param seed Seed of the first row, the other rows derive theirs from it
+         */
+        count_min_sketch(runners v, dword width, dword depth, qword seed = 0) :
+                runners_(std::move(v)),
+                width_(std::max<dword>(1, width)),
+                depth_(std::max<dword>(1, depth)),
+                seed_(seed) {
+            counters_.reserve(runners_.size());
+            for (auto &runner: runners_) {
+                counters_.emplace_back(size(), runner.q);
+            }
+            clear();
+        }
+
+        [[nodiscard]] inline dword width() const noexcept { return width_; }
+
+        [[nodiscard]] inline dword depth() const noexcept { return depth_; }
+
+        void clear() {
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                runners_[i].q.memset(counters_[i].raw(), 0, counters_[i].alloc_size()).wait();
+            }
+        }
+
+        /**
+         * Counts `n_batch` items of `inlen` bytes.
+         * @param in host or device memory
+         */
+        void add(const byte *in, dword inlen, dword n_batch) {
+            auto offsets = internal::get_batch_offsets(runners_, n_batch);
+            std::vector<internal::staged_buffer<const byte>> inputs;
+            std::vector<sycl::event> events;
+            inputs.reserve(runners_.size());
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                auto n = (dword) (offsets[i + 1] - offsets[i]);
+                inputs.emplace_back(runners_[i].q, in + offsets[i] * inlen, (size_t) n * inlen);
+                if (n) {
+                    events.emplace_back(internal::launch_cms_add_kernel(runners_[i].q, sycl::event{}, M, device_accessible_ptr<byte>(inputs.back().get()), inlen, n, seed_, width_, depth_,
+                                                                        counters_[i].get()));
+                }
+            }
+            for (auto &e: events) {
+                e.wait();
+            }
+        }
+
+        /**
+         * Estimated counts of `n_batch` items of `inlen` bytes.
+         * @param in host or device memory
+         * @param counts `n_batch` words in host or device memory
+         */
+        void estimate(const byte *in, dword inlen, dword n_batch, dword *counts) {
+            if (n_batch == 0) return;
+            gather();
+            sycl::queue &q = runners_[0].q;
+            internal::staged_buffer<const byte> staged_in(q, in, (size_t) n_batch * inlen);
+            internal::staged_buffer<dword> staged_counts(q, counts, n_batch, false);
+            internal::launch_cms_estimate_kernel(q, sycl::event{}, M, device_accessible_ptr<byte>(staged_in.get()), inlen, n_batch, seed_, width_, depth_, counters_[0].get(),
+                                                 device_accessible_ptr<dword>(staged_counts.get())).wait();
+            staged_counts.copy_back(q);
+        }
+
+        /**
+         * The `k` distinct items of a batch with the highest estimated counts, in decreasing order. Typically the batch
+         * that was just added, or a list of candidate keys.
+         * The estimates, the deduplication and the selection run on the device, only the selected items come back.
+         * @param in host or device memory
+         */
+        [[nodiscard]] std::vector<heavy_hitter> top_k(const byte *in, dword inlen, dword n_batch, dword k) {
+            if (n_batch == 0 || k == 0) return {};
+            gather();
+            sycl::queue &q = runners_[0].q;
+            internal::staged_buffer<const byte> staged_in(q, in, (size_t) n_batch * inlen);
+            auto indata = device_accessible_ptr<byte>(staged_in.get());
+            auto estimates = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+            size_t set_size = 1;
+            while (set_size < 2 * (size_t) n_batch) set_size <<= 1;
+            auto set = usm_unique_ptr<qword, alloc::device>(set_size, q);
+            auto counts = usm_unique_ptr<dword, alloc::shared>(2, q);
+
+            internal::launch_cms_estimate_kernel(q, sycl::event{}, M, indata, inlen, n_batch, seed_, width_, depth_, counters_[0].get(), estimates.get()).wait();
+            q.memset(set.raw(), 0, set.alloc_size()).wait();
+            internal::launch_cms_distinct_kernel(q, sycl::event{}, M, indata, inlen, n_batch, seed_, set.get(), set_size, estimates.get()).wait();
+
+            /* Largest threshold with at least k items at or above it */
+            auto count_above = [&](dword threshold) {
+                counts.raw()[0] = 0;
+                internal::launch_cms_count_above_kernel(q, sycl::event{}, estimates.get(), n_batch, threshold, counts.get()).wait();
+                return counts.raw()[0];
+            };
+            dword low = 1, high = ~0u;
+            if (count_above(low) < k) {
+                high = low;
+            }
+            while (low < high) {
+                dword mid = low + (high - low) / 2 + 1;
+                if (count_above(mid) >= k) {
+                    low = mid;
+                } else {
+                    high = mid - 1;
+                }
+            }
+            const dword threshold = low;
+            const dword n_above = threshold == ~0u ? 0 : count_above(threshold + 1);
+            const dword capacity = std::max(k, n_above) + k;
+
+            auto out = usm_unique_ptr<heavy_hitter, alloc::device>(capacity, q);
+            counts.raw()[0] = 0;
+            counts.raw()[1] = 0;
+            internal::launch_cms_select_kernel(q, sycl::event{}, estimates.get(), n_batch, threshold, n_above, capacity, out.get(), counts.get()).wait();
+            std::vector<heavy_hitter> result(n_above + std::min(counts.raw()[1], capacity - n_above));
+            q.memcpy(result.data(), out.raw(), sizeof(heavy_hitter) * result.size()).wait();
+
+            std::sort(result.begin(), result.end(), [](const heavy_hitter &a, const heavy_hitter &b) {
+                return a.count != b.count ? a.count > b.count : a.index < b.index;
+            });
+            result.resize(std::min<size_t>(result.size(), k));
+            return result;
+        }
+
+        /**
+         * Adds the counts of another sketch with the same dimensions and seed.
+         * Throws `std::invalid_argument` if they differ.
+         */
+        void merge(const count_min_sketch &other) {
+            if (other.width_ != width_ || other.depth_ != depth_ || other.seed_ != seed_) {
+                throw std::invalid_argument("count_min_sketch: merging a sketch of other dimensions or seed");
+            }
+            for (size_t i = 0; i < other.runners_.size(); ++i) {
+                std::vector<dword> counters(size());
+                sycl::queue q = other.runners_[i].q;
+                q.memcpy(counters.data(), other.counters_[i].raw(), size() * sizeof(dword)).wait();
+                accumulate(counters.data());
+            }
+        }
+
+        /**
+         * The `depth * width` counters, row after row, summed over the runners.
+         */
+        [[nodiscard]] std::vector<dword> counters() {
+            gather();
+            std::vector<dword> counters(size());
+            runners_[0].q.memcpy(counters.data(), counters_[0].raw(), counters_[0].alloc_size()).wait();
+            return counters;
+        }
+    };
+
+}
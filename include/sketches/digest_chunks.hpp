@@ -0,0 +1,47 @@
+#pragma once
+
+#include "../internal/common.hpp"
+#include "../tools/sycl_queue_helpers.hpp"
+
+#include <algorithm>
+
+namespace hash::internal {
+
+    constexpr size_t SKETCH_CHUNK_BYTES = 64 << 20; // Device scratch memory used per chunk, input copy and digests
+
+    /**
+     * Hashes the items chunk by chunk in a device scratch buffer and hands each chunk of digests to `consume`, so the
+     * digests never go back to the host and never need to be all in memory at once.
+     * Inputs in host memory are copied chunk by chunk. The call blocks until the last chunk is consumed.
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     * @param key key of `dispatch_hash` (the seed bytes for the seeded methods)
+     * @param consume `sycl::event(sycl::event e, device_accessible_ptr<byte> digests, dword first, dword n)` submits the
+     * work on the digests of the items `first` to `first + n - 1` after `e`, and returns the event of its last kernel.
+     */
+    template<method M, int n_outbit = 0, typename Func>
+    inline void hash_in_chunks(sycl::queue &q, const byte *in, dword inlen, dword n_batch, const byte *key, dword keylen, Func &&consume) {
+        if (n_batch == 0) return;
+        constexpr dword digest_size = get_block_size<M, n_outbit>();
+        const bool in_place = is_ptr_usable(in, q);
+        const size_t chunk = std::clamp<size_t>(SKETCH_CHUNK_BYTES / (digest_size + (in_place ? 0 : inlen)), 1, n_batch);
+        auto digests = usm_unique_ptr<byte, alloc::device>(digest_size * chunk, q);
+        auto device_in = usm_unique_ptr<byte, alloc::device>(in_place ? 1 : std::max<size_t>(1, inlen * chunk), q);
+
+        sycl::event e{};
+        for (size_t first = 0; first < n_batch; first += chunk) {
+            auto n = (dword) std::min<size_t>(chunk, n_batch - first);
+            const byte *chunk_in = in + first * inlen;
+            if (!in_place) {
+                if (inlen) {
+                    e = memcpy_with_dependency(q, device_in.raw(), chunk_in, inlen * n, e);
+                }
+                chunk_in = device_in.raw();
+            }
+            e = dispatch_hash<M, n_outbit>(q, e, device_accessible_ptr<byte>(chunk_in), device_accessible_ptr<byte>(digests.raw()), inlen, n, key, keylen);
+            e = consume(e, device_accessible_ptr<byte>(digests.raw()), (dword) first, n);
+        }
+        e.wait();
+    }
+
+}
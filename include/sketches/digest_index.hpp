@@ -0,0 +1,222 @@
+#pragma once
+
+#include "digest_chunks.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hash {
+    namespace internal {
+        class digest_index_insert_kernel;
+
+        class digest_index_lookup_kernel;
+
+        class digest_index_rehash_kernel;
+
+        /**
+         * Inserts the fingerprints of a chunk of digests that are not in the table yet, and appends the indices
+         * `first + i` of the inserted ones to `out`, `out_count` being their number.
+         * @param slots `capacity` words, a power of two, 0 marking the empty slots
+         */
+        sycl::event
+        launch_digest_index_insert_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword first, dword n, device_accessible_ptr<qword> slots,
+                                          qword capacity, device_accessible_ptr<dword> out, device_accessible_ptr<dword> out_count);
+
+        /**
+         * Appends to `out` the indices `first + i` of the digests whose fingerprint is not in the table.
+         */
+        sycl::event
+        launch_digest_index_lookup_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword first, dword n, device_accessible_ptr<qword> slots,
+                                          qword capacity, device_accessible_ptr<dword> out, device_accessible_ptr<dword> out_count);
+
+        /**
+         * Inserts the fingerprints of a table in a bigger, zeroed, one.
+         */
+        sycl::event
+        launch_digest_index_rehash_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> slots, qword capacity, device_accessible_ptr<qword> new_slots, qword new_capacity);
+    }
+
+    constexpr double DIGEST_INDEX_MAX_LOAD = 0.5; // Linear probing degrades quickly above
+    constexpr char DIGEST_INDEX_MAGIC[8] = {'S', 'Y', 'C', 'L', 'H', 'I', 'D', 'X'};
+    constexpr qword DIGEST_INDEX_VERSION = 1;
+
+    /**
+     * Set of digests living in device memory, for deduplication: an open addressing table with linear probing of 64-bit
+     * fingerprints, the first 8 bytes of the digests. Two digests sharing them are taken for the same one, with
+     * probability n^2 / 2^65 for n random digests.
+     * Batches are hashed with `M` by the usual kernels, chunk by chunk, and only the indices of the new or unknown items
+     * come back to the host. The table doubles when it gets half full.
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     */
+    template<method M, int n_outbit = 0>
+    class digest_index {
+    private:
+        sycl::queue q_;
+        std::vector<byte> key_;
+        qword capacity_;
+        qword size_ = 0;
+        usm_unique_ptr<qword, alloc::device> slots_;
+
+        static qword capacity_for(qword n_items) {
+            qword capacity = 64;
+            while ((double) capacity * DIGEST_INDEX_MAX_LOAD < (double) n_items) capacity <<= 1;
+            return capacity;
+        }
+
+        /**
+         * Grows the table until `n_items` fit under the maximal load.
+         */
+        void reserve(qword n_items) {
+            qword capacity = capacity_for(n_items);
+            if (capacity <= capacity_) return;
+            auto slots = usm_unique_ptr<qword, alloc::device>(capacity, q_);
+            auto e = q_.memset(slots.raw(), 0, slots.alloc_size());
+            internal::launch_digest_index_rehash_kernel(q_, e, slots_.get(), capacity_, slots.get(), capacity).wait();
+            slots_ = std::move(slots);
+            capacity_ = capacity;
+        }
+
+        /**
+         * Runs `launch` on the digests of the batch, chunk by chunk, and returns the indices it appended, sorted.
+         */
+        template<typename Func>
+        std::vector<dword> collect(const byte *in, dword inlen, dword n_batch, Func &&launch) {
+            if (n_batch == 0) return {};
+            auto out = usm_unique_ptr<dword, alloc::device>(n_batch, q_);
+            auto out_count = usm_unique_ptr<dword, alloc::device>(1, q_);
+            q_.memset(out_count.raw(), 0, sizeof(dword)).wait();
+            internal::hash_in_chunks<M, n_outbit>(q_, in, inlen, n_batch, key_.data(), (dword) key_.size(), [&](sycl::event e, device_accessible_ptr<byte> digests, dword first, dword n) {
+                return launch(e, digests, first, n, out.get(), out_count.get());
+            });
+            dword count;
+            q_.memcpy(&count, out_count.raw(), sizeof(dword)).wait();
+            std::vector<dword> indices(count);
+            q_.memcpy(indices.data(), out.raw(), sizeof(dword) * count).wait();
+            std::sort(indices.begin(), indices.end());
+            return indices;
+        }
+
+    public:
+        /**
+         * @param expected_items the table is sized to hold them without growing
+         * @param key key of the hash method if it needs one, or the seed bytes of a seeded method
+         */
+        explicit digest_index(sycl::queue q, qword expected_items = 1 << 20, const byte *key = nullptr, dword keylen = 0) :
+                q_(std::move(q)),
+                key_(key, key + keylen),
+                capacity_(capacity_for(expected_items)),
+                slots_(capacity_, q_) {
+            clear();
+        }
+
+        /**
+         * Number of digests in the index.
+         */
+        [[nodiscard]] inline qword size() const noexcept { return size_; }
+
+        [[nodiscard]] inline qword capacity() const noexcept { return capacity_; }
+
+        void clear() {
+            q_.memset(slots_.raw(), 0, slots_.alloc_size()).wait();
+            size_ = 0;
+        }
+
+        /**
+         * Inserts the digests of `n_batch` items of `inlen` bytes that are not in the index yet.
+         * @param in host or device memory
+         * @return indices of the inserted items, in increasing order. Of several items sharing a digest, one is inserted.
+         */
+        std::vector<dword> insert(const byte *in, dword inlen, dword n_batch) {
+            reserve(size_ + n_batch);
+            auto inserted = collect(in, inlen, n_batch, [&](sycl::event e, device_accessible_ptr<byte> digests, dword first, dword n, device_accessible_ptr<dword> out,
+                                                            device_accessible_ptr<dword> out_count) {
+                return internal::launch_digest_index_insert_kernel(q_, e, digests, get_block_size<M, n_outbit>(), first, n, slots_.get(), capacity_, out, out_count);
+            });
+            size_ += inserted.size();
+            return inserted;
+        }
+
+        /**
+         * Looks up `n_batch` items of `inlen` bytes.
+         * @param in host or device memory
+         * @return indices of the items whose digest is not in the index, in increasing order
+         */
+        std::vector<dword> lookup(const byte *in, dword inlen, dword n_batch) {
+            return collect(in, inlen, n_batch, [&](sycl::event e, device_accessible_ptr<byte> digests, dword first, dword n, device_accessible_ptr<dword> out,
+                                                   device_accessible_ptr<dword> out_count) {
+                return internal::launch_digest_index_lookup_kernel(q_, e, digests, get_block_size<M, n_outbit>(), first, n, slots_.get(), capacity_, out, out_count);
+            });
+        }
+
+        /**
+         * Writes the index to a file: a header naming the method, then the table as it is in memory. The key is not
+         * saved. Throws `std::runtime_error` when the file cannot be written.
+         */
+        void save(const std::string &path) {
+            std::ofstream file(path, std::ios::binary | std::ios::trunc);
+            const qword header[] = {DIGEST_INDEX_VERSION, (qword) M, (qword) n_outbit, capacity_, size_};
+            file.write(DIGEST_INDEX_MAGIC, sizeof(DIGEST_INDEX_MAGIC));
+            file.write((const char *) header, sizeof(header));
+            std::vector<qword> chunk(std::min<qword>(capacity_, internal::SKETCH_CHUNK_BYTES / sizeof(qword)));
+            for (qword first = 0; first < capacity_ && file; first += chunk.size()) {
+                qword n = std::min<qword>(chunk.size(), capacity_ - first);
+                q_.memcpy(chunk.data(), slots_.raw() + first, sizeof(qword) * n).wait();
+                file.write((const char *) chunk.data(), (std::streamsize) (sizeof(qword) * n));
+            }
+            if (!file.flush()) {
+                throw std::runtime_error("digest_index: cannot write " + path);
+            }
+        }
+
+        /**
+         * Replaces the content of the index by the one saved in a file. Throws `std::runtime_error` when the file
+         * cannot be read, was saved by an index of another method, or its table is not one the index could have
+         * saved: a wrong length, or more occupied slots than the maximal load allows, which would make probes endless.
+         */
+        void load(const std::string &path) {
+            std::ifstream file(path, std::ios::binary);
+            char magic[sizeof(DIGEST_INDEX_MAGIC)];
+            qword header[5];
+            file.read(magic, sizeof(magic));
+            file.read((char *) header, sizeof(header));
+            if (!file || std::memcmp(magic, DIGEST_INDEX_MAGIC, sizeof(magic)) != 0 || header[0] != DIGEST_INDEX_VERSION) {
+                throw std::runtime_error("digest_index: " + path + " is not a digest index");
+            }
+            if (header[1] != (qword) M || header[2] != (qword) n_outbit) {
+                throw std::runtime_error("digest_index: " + path + " was saved for another hash method");
+            }
+            const qword capacity = header[3], size = header[4];
+            const auto table_start = file.tellg();
+            file.seekg(0, std::ios::end);
+            const auto table_bytes = (qword) (file.tellg() - table_start);
+            file.seekg(table_start);
+            if (capacity < 64 || (capacity & (capacity - 1)) != 0 || (double) size > (double) capacity * DIGEST_INDEX_MAX_LOAD
+                || table_bytes / sizeof(qword) != capacity || table_bytes % sizeof(qword) != 0) {
+                throw std::runtime_error("digest_index: " + path + " is corrupted");
+            }
+            auto slots = usm_unique_ptr<qword, alloc::device>(capacity, q_);
+            std::vector<qword> chunk(std::min<qword>(capacity, internal::SKETCH_CHUNK_BYTES / sizeof(qword)));
+            qword occupied = 0;
+            for (qword first = 0; first < capacity; first += chunk.size()) {
+                qword n = std::min<qword>(chunk.size(), capacity - first);
+                if (!file.read((char *) chunk.data(), (std::streamsize) (sizeof(qword) * n))) {
+                    throw std::runtime_error("digest_index: " + path + " is truncated");
+                }
+                occupied += (qword) std::count_if(chunk.begin(), chunk.begin() + (std::ptrdiff_t) n, [](qword slot) { return slot != 0; });
+                q_.memcpy(slots.raw() + first, chunk.data(), sizeof(qword) * n).wait();
+            }
+            if (occupied != size) {
+                throw std::runtime_error("digest_index: " + path + " is corrupted");
+            }
+            slots_ = std::move(slots);
+            capacity_ = capacity;
+            size_ = size;
+        }
+    };
+
+}
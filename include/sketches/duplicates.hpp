@@ -0,0 +1,193 @@
+#pragma once
+
+#include "digest_chunks.hpp"
+#include "scan.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace hash {
+    namespace internal {
+        class dedup_keys_kernel;
+
+        class radix_histogram_kernel;
+
+        class radix_scatter_kernel;
+
+        class dedup_run_heads_kernel;
+
+        class dedup_run_starts_kernel;
+
+        class dedup_leaders_kernel;
+
+        class dedup_group_sizes_kernel;
+
+        class dedup_emit_kernel;
+
+        constexpr dword RADIX_BITS = 8;
+        constexpr dword RADIX_BUCKETS = 1u << RADIX_BITS;
+        constexpr size_t RADIX_MAX_THREADS = 1024; // Each work-item has a column of RADIX_BUCKETS counters
+
+        /**
+         * Copies a chunk of digests to `digests`, and sets the sort key of item `first + i` to the first 8 bytes of its
+         * digest read as a big endian word, so keys sort like digests, and its value to `first + i`.
+         */
+        sycl::event
+        launch_dedup_keys_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> chunk, dword digest_size, dword first, dword n, device_accessible_ptr<byte> digests,
+                                 device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values);
+
+        /**
+         * Number of work-items of the radix sort passes: each one sorts a contiguous segment of the pairs.
+         */
+        dword get_radix_threads(sycl::queue &q, dword n);
+
+        /**
+         * Counts the digits `(key >> shift) % RADIX_BUCKETS` of each segment in `counts[digit * n_threads + thread]`.
+         */
+        sycl::event launch_radix_histogram_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, dword n, dword shift, device_accessible_ptr<qword> counts);
+
+        /**
+         * Stable scatter of the pairs in the order of their digits, `counts` holding the scanned histogram.
+         */
+        sycl::event
+        launch_radix_scatter_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values, dword n, dword shift, device_accessible_ptr<qword> counts,
+                                    device_accessible_ptr<qword> out_keys, device_accessible_ptr<dword> out_values);
+
+        /**
+         * `heads[i]` is 1 when the sorted key `i` starts a run of equal keys.
+         */
+        sycl::event launch_dedup_run_heads_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, dword n, device_accessible_ptr<qword> heads);
+
+        /**
+         * `run_starts[r]`: first position of run `r`, `run_ids` holding the scanned heads.
+         */
+        sycl::event
+        launch_dedup_run_starts_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, dword n, device_accessible_ptr<qword> run_ids, device_accessible_ptr<dword> run_starts);
+
+        /**
+         * `leaders[i]`: first position of the run of `i` whose full digest equals the digest of `i`. Keys only hold a
+         * prefix of the digests, so different digests may share a run. Also counts the members of each group in `sizes`,
+         * which must be zeroed.
+         */
+        sycl::event
+        launch_dedup_leaders_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values, dword n, device_accessible_ptr<qword> run_ids,
+                                    device_accessible_ptr<dword> run_starts, device_accessible_ptr<byte> digests, dword digest_size, device_accessible_ptr<dword> leaders,
+                                    device_accessible_ptr<dword> sizes);
+
+        /**
+         * For the leaders of groups with duplicates: their size in `members` and 1 in `groups`, 0 elsewhere.
+         */
+        sycl::event
+        launch_dedup_group_sizes_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> leaders, device_accessible_ptr<dword> sizes, dword n, device_accessible_ptr<qword> members,
+                                        device_accessible_ptr<qword> groups);
+
+        /**
+         * Writes the indices of each group with duplicates from `indices[members[leader]]`, and the start of group `g`
+         * in `group_offsets[g]`, `members` and `groups` being scanned. `cursors` must be zeroed.
+         */
+        sycl::event
+        launch_dedup_emit_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> values, device_accessible_ptr<dword> leaders, device_accessible_ptr<dword> sizes, dword n,
+                                 device_accessible_ptr<qword> members, device_accessible_ptr<qword> groups, device_accessible_ptr<dword> cursors, device_accessible_ptr<dword> indices,
+                                 device_accessible_ptr<qword> group_offsets);
+
+        /**
+         * LSD radix sort of `n` (key, value) pairs in device memory, stable. `tmp_keys` and `tmp_values` hold `n` pairs.
+         */
+        inline void radix_sort_pairs(sycl::queue &q, device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values, dword n, device_accessible_ptr<qword> tmp_keys,
+                                     device_accessible_ptr<dword> tmp_values) {
+            const dword n_threads = get_radix_threads(q, n);
+            auto counts = usm_unique_ptr<qword, alloc::device>((size_t) RADIX_BUCKETS * n_threads, q);
+            auto bounds = usm_unique_ptr<qword, alloc::device>(RADIX_BUCKETS + 1, q);
+            sycl::event e{};
+            for (dword shift = 0; shift < 64; shift += RADIX_BITS) {
+                e = launch_radix_histogram_kernel(q, e, keys, n, shift, counts.get());
+                e = launch_exclusive_scan_kernel(q, e, counts.get(), counts.alloc_count(), n_threads, bounds.get());
+                e = launch_radix_scatter_kernel(q, e, keys, values, n, shift, counts.get(), tmp_keys, tmp_values);
+                std::swap(keys, tmp_keys);
+                std::swap(values, tmp_values);
+            }
+            e.wait();
+        }
+    }
+
+    /**
+     * Groups of items with identical digests: group `g` is made of the items `indices[offsets[g]]` to
+     * `indices[offsets[g + 1] - 1]`, in increasing order.
+     */
+    struct duplicate_groups {
+        std::vector<qword> offsets;
+        std::vector<dword> indices;
+
+        [[nodiscard]] inline size_t size() const noexcept { return offsets.size() - 1; }
+    };
+
+    /**
+     * Hashes `n_batch` items of `inlen` bytes with `M` and finds the items sharing a digest, for content addressed
+     * deduplication. The (digest prefix, index) pairs are radix sorted on the device and the full digests compared
+     * there, only the groups of duplicates come back to the host. The groups are in the order of their digest prefixes.
+     * @tparam M Hash method
+     * @tparam n_outbit Number of bits to output, if applicable
+     * @param in host or device memory
+     * @param key key of the hash method if it needs one, or the seed bytes of a seeded method
+     */
+    template<method M, int n_outbit = 0>
+    duplicate_groups find_duplicates(sycl::queue &q, const byte *in, dword inlen, dword n_batch, const byte *key = nullptr, dword keylen = 0) {
+        duplicate_groups result{{0}, {}};
+        if (n_batch < 2) return result;
+        constexpr dword digest_size = get_block_size<M, n_outbit>();
+        auto digests = usm_unique_ptr<byte, alloc::device>((size_t) digest_size * n_batch, q);
+        auto keys = usm_unique_ptr<qword, alloc::device>(n_batch, q);
+        auto values = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+        internal::hash_in_chunks<M, n_outbit>(q, in, inlen, n_batch, key, keylen, [&](sycl::event e, device_accessible_ptr<byte> chunk, dword first, dword n) {
+            return internal::launch_dedup_keys_kernel(q, e, chunk, digest_size, first, n, digests.get(), keys.get(), values.get());
+        });
+
+        {
+            auto tmp_keys = usm_unique_ptr<qword, alloc::device>(n_batch, q);
+            auto tmp_values = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+            internal::radix_sort_pairs(q, keys.get(), values.get(), n_batch, tmp_keys.get(), tmp_values.get());
+        }
+
+        auto run_ids = usm_unique_ptr<qword, alloc::device>(n_batch, q);
+        auto run_starts = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+        auto leaders = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+        auto sizes = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+        auto cursors = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+        auto members = usm_unique_ptr<qword, alloc::device>(n_batch, q);
+        auto groups = usm_unique_ptr<qword, alloc::device>(n_batch, q);
+        auto bounds = usm_unique_ptr<qword, alloc::device>(n_batch + 1, q);
+        auto device_totals = usm_unique_ptr<qword, alloc::device>(4, q);
+        q.memset(sizes.raw(), 0, sizes.alloc_size()).wait();
+        q.memset(cursors.raw(), 0, cursors.alloc_size()).wait();
+
+        auto e = internal::launch_dedup_run_heads_kernel(q, sycl::event{}, keys.get(), n_batch, run_ids.get());
+        e = internal::launch_exclusive_scan_kernel(q, e, run_ids.get(), n_batch, 1, bounds.get());
+        e = internal::launch_dedup_run_starts_kernel(q, e, keys.get(), n_batch, run_ids.get(), run_starts.get());
+        e = internal::launch_dedup_leaders_kernel(q, e, keys.get(), values.get(), n_batch, run_ids.get(), run_starts.get(), digests.get(), digest_size, leaders.get(), sizes.get());
+        e = internal::launch_dedup_group_sizes_kernel(q, e, leaders.get(), sizes.get(), n_batch, members.get(), groups.get());
+
+        /* Number of items in the groups, then number of groups: the second bound of each scan */
+        qword totals[4];
+        e = internal::launch_exclusive_scan_kernel(q, e, members.get(), n_batch, n_batch, device_totals.get());
+        e = internal::launch_exclusive_scan_kernel(q, e, groups.get(), n_batch, n_batch, device_accessible_ptr<qword>(device_totals.raw() + 2));
+        memcpy_with_dependency(q, totals, device_totals.raw(), sizeof(totals), e).wait();
+        const qword n_members = totals[1];
+        const qword n_groups = totals[3];
+        if (n_groups == 0) return result;
+
+        auto indices = usm_unique_ptr<dword, alloc::device>(n_members, q);
+        auto group_offsets = usm_unique_ptr<qword, alloc::device>(n_groups, q);
+        internal::launch_dedup_emit_kernel(q, sycl::event{}, values.get(), leaders.get(), sizes.get(), n_batch, members.get(), groups.get(), cursors.get(), indices.get(), group_offsets.get()).wait();
+
+        result.offsets.resize(n_groups + 1);
+        result.indices.resize(n_members);
+        q.memcpy(result.offsets.data(), group_offsets.raw(), group_offsets.alloc_size()).wait();
+        q.memcpy(result.indices.data(), indices.raw(), indices.alloc_size()).wait();
+        result.offsets.back() = n_members;
+        for (size_t g = 0; g < result.size(); ++g) {
+            std::sort(result.indices.begin() + (long) result.offsets[g], result.indices.begin() + (long) result.offsets[g + 1]);
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,173 @@
+#pragma once
+
+#include "../internal/common.hpp"
+#include "sketch_method.hpp"
+#include "staging.hpp"
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace hash {
+    namespace internal {
+        template<method M>
+        class hll_local_kernel;
+
+        template<method M>
+        class hll_global_kernel;
+
+        class hll_pack_kernel;
+
+        /**
+         * Hashes the items with `sketch_method` and raises their registers. When the `2^precision` registers fit in local
+         * memory, each work-group updates its own copy there and merges it in `registers` at the end, otherwise every
+         * update is a global atomic.
+         * @param registers `2^precision` dwords in device memory
+         */
+        sycl::event
+        launch_hll_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, dword precision,
+                          device_accessible_ptr<dword> registers);
+
+        /**
+         * Narrows the registers to bytes before they are copied to the host.
+         */
+        sycl::event launch_hll_pack_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> registers, dword n_registers, device_accessible_ptr<byte> packed);
+    }
+
+    constexpr dword HLL_MIN_PRECISION = 4;
+    constexpr dword HLL_MAX_PRECISION = 18;
+
+    /**
+     * Cardinality estimated from HyperLogLog registers, with the linear counting correction for small cardinalities.
+     * The hashes are 64-bit so there is no large range correction.
+     */
+    inline double hyperloglog_estimate(const std::vector<byte> &registers) {
+        const auto m = (double) registers.size();
+        double alpha;
+        switch (registers.size()) {
+            case 16:
+                alpha = 0.673;
+                break;
+            case 32:
+                alpha = 0.697;
+                break;
+            case 64:
+                alpha = 0.709;
+                break;
+            default:
+                alpha = 0.7213 / (1 + 1.079 / m);
+        }
+        double sum = 0;
+        size_t zeros = 0;
+        for (auto r: registers) {
+            sum += std::ldexp(1.0, -(int) r);
+            zeros += r == 0;
+        }
+        double estimate = alpha * m * m / sum;
+        if (estimate <= 2.5 * m && zeros != 0) {
+            return m * std::log(m / (double) zeros);
+        }
+        return estimate;
+    }
+
+    /**
+     * HyperLogLog sketch of the items hashed with `M`. The items are split between the runners like in `hasher`, each
+     * runner updating its own sketch in device memory. Only the registers, one byte each, come back to the host where
+     * the runners' sketches are merged.
+     * @tparam M Hash method, see `is_sketch_method`
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    class hyperloglog {
+    private:
+        runners runners_;
+        dword precision_;
+        qword seed_;
+        std::vector<usm_unique_ptr<dword, alloc::device>> registers_;
+        std::vector<byte> merged_ /** Registers merged from other sketches */;
+
+    public:
+        /**
+         * @param precision the sketch has 2^precision registers, the standard error is 1.04 / sqrt(2^precision)
+         * @param seed Seed of `M`
+         */
+        explicit hyperloglog(runners v, dword precision = 12, qword seed = 0) :
+                runners_(std::move(v)),
+                precision_(std::clamp(precision, HLL_MIN_PRECISION, HLL_MAX_PRECISION)),
+                seed_(seed),
+                merged_((size_t) 1 << precision_) {
+            registers_.reserve(runners_.size());
+            for (auto &runner: runners_) {
+                registers_.emplace_back(merged_.size(), runner.q);
+            }
+            clear();
+        }
+
+        [[nodiscard]] inline dword precision() const noexcept { return precision_; }
+
+        void clear() {
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                runners_[i].q.memset(registers_[i].raw(), 0, registers_[i].alloc_size()).wait();
+            }
+            std::fill(merged_.begin(), merged_.end(), 0);
+        }
+
+        /**
+         * Adds `n_batch` items of `inlen` bytes.
+         * @param in host or device memory
+         */
+        void add(const byte *in, dword inlen, dword n_batch) {
+            auto offsets = internal::get_batch_offsets(runners_, n_batch);
+            std::vector<internal::staged_buffer<const byte>> inputs;
+            std::vector<sycl::event> events;
+            inputs.reserve(runners_.size());
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                auto n = (dword) (offsets[i + 1] - offsets[i]);
+                inputs.emplace_back(runners_[i].q, in + offsets[i] * inlen, (size_t) n * inlen);
+                if (n) {
+                    events.emplace_back(internal::launch_hll_kernel(runners_[i].q, sycl::event{}, M, device_accessible_ptr<byte>(inputs.back().get()), inlen, n, seed_, precision_,
+                                                                    registers_[i].get()));
+                }
+            }
+            for (auto &e: events) {
+                e.wait();
+            }
+        }
+
+        /**
+         * Merges another sketch of the same precision and seed, the result estimates the cardinality of the union.
+         * Throws `std::invalid_argument` if they differ.
+         */
+        void merge(const hyperloglog &other) {
+            if (other.precision_ != precision_ || other.seed_ != seed_) {
+                throw std::invalid_argument("hyperloglog: merging a sketch of another precision or seed");
+            }
+            auto other_registers = other.registers();
+            for (size_t i = 0; i < merged_.size(); ++i) {
+                merged_[i] = std::max(merged_[i], other_registers[i]);
+            }
+        }
+
+        /**
+         * Registers of the sketch, the maximum over the runners and the merged sketches.
+         */
+        [[nodiscard]] std::vector<byte> registers() const {
+            std::vector<byte> result = merged_;
+            std::vector<byte> runner_registers(merged_.size());
+            for (size_t i = 0; i < runners_.size(); ++i) {
+                sycl::queue q = runners_[i].q;
+                auto packed = usm_unique_ptr<byte, alloc::device>(merged_.size(), q);
+                auto e = internal::launch_hll_pack_kernel(q, sycl::event{}, registers_[i].get(), (dword) merged_.size(), packed.get());
+                memcpy_with_dependency(q, runner_registers.data(), packed.raw(), merged_.size(), e).wait();
+                for (size_t j = 0; j < result.size(); ++j) {
+                    result[j] = std::max(result[j], runner_registers[j]);
+                }
+            }
+            return result;
+        }
+
+        [[nodiscard]] double estimate() const {
+            return hyperloglog_estimate(registers());
+        }
+    };
+
+}
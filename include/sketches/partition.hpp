@@ -0,0 +1,188 @@
+#pragma once
+
+#include "../internal/common.hpp"
+#include "scan.hpp"
+#include "sketch_method.hpp"
+#include "signatures.hpp"
+#include "staging.hpp"
+
+#include <stdexcept>
+
+namespace hash {
+    namespace internal {
+        template<method M>
+        class partition_local_histogram_kernel;
+
+        template<method M>
+        class partition_global_histogram_kernel;
+
+        class partition_local_scatter_kernel;
+
+        class partition_global_scatter_kernel;
+
+        class partition_lengths_kernel;
+
+        class partition_gather_kernel;
+
+        /**
+         * Number of work-groups of the histogram and scatter kernels for `n_batch` records. Both kernels give the
+         * records to the work-groups the same way.
+         */
+        dword get_partition_groups(sycl::queue &q, dword n_batch);
+
+        /**
+         * Hashes each record with `sketch_method` and writes its partition `h % n_partitions` in `ids`. Each work-group
+         * counts its records per partition in local memory, if the counters fit, and writes them in
+         * `counts[p * n_groups + group]`, which must be zeroed.
+         * @param offsets `n_batch + 1` offsets of ragged records in `indata`, or null for records of `inlen` bytes
+         */
+        sycl::event
+        launch_partition_histogram_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> offsets, dword inlen,
+                                          dword n_batch, qword seed, dword n_partitions, device_accessible_ptr<dword> ids, device_accessible_ptr<qword> counts);
+
+        /**
+         * Places each record after the ones of the previous partitions and of the previous work-groups in its partition,
+         * `counts` holding the scanned histogram. Writes either the records of `inlen` bytes to `records`, or their
+         * indices to `indices`, the other pointer being null.
+         */
+        sycl::event
+        launch_partition_scatter_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> ids, dword n_batch, dword n_partitions, device_accessible_ptr<qword> counts,
+                                        device_accessible_ptr<byte> indata, dword inlen, device_accessible_ptr<byte> records, device_accessible_ptr<dword> indices);
+
+        /**
+         * `lengths[i]`: length of the ragged record `indices[i]`.
+         */
+        sycl::event
+        launch_partition_lengths_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> offsets, device_accessible_ptr<dword> indices, dword n_batch, device_accessible_ptr<qword> lengths);
+
+        /**
+         * Copies the ragged record `indices[i]` at `out_offsets[i]` in `out`.
+         */
+        sycl::event
+        launch_partition_gather_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> offsets, device_accessible_ptr<dword> indices, dword n_batch,
+                                       device_accessible_ptr<byte> out, device_accessible_ptr<qword> out_offsets);
+
+        /**
+         * Throws `std::invalid_argument` if there are no partitions to split the records in.
+         */
+        inline void check_n_partitions(dword n_partitions) {
+            if (n_partitions == 0) {
+                throw std::invalid_argument("partition: the number of partitions must be at least 1");
+            }
+        }
+
+        /**
+         * Histogram, prefix sum and scatter of records in device memory, see `launch_partition_histogram_kernel`.
+         * @param bounds `n_partitions + 1` words receiving the first record of each partition and `n_batch`
+         */
+        inline void partition_on_device(sycl::queue &q, method sketch_method, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> offsets, dword inlen, dword n_batch,
+                                        dword n_partitions, qword seed, device_accessible_ptr<byte> records, device_accessible_ptr<dword> indices, device_accessible_ptr<qword> bounds) {
+            if (n_batch == 0) {
+                q.memset(bounds, 0, sizeof(qword) * (n_partitions + 1)).wait();
+                return;
+            }
+            const dword n_groups = get_partition_groups(q, n_batch);
+            auto ids = usm_unique_ptr<dword, alloc::device>(n_batch, q);
+            auto counts = usm_unique_ptr<qword, alloc::device>((size_t) n_partitions * n_groups, q);
+            auto e = q.memset(counts.raw(), 0, counts.alloc_size());
+            e = launch_partition_histogram_kernel(q, e, sketch_method, indata, offsets, inlen, n_batch, seed, n_partitions, ids.get(), counts.get());
+            e = launch_exclusive_scan_kernel(q, e, counts.get(), counts.alloc_count(), n_groups, bounds);
+            launch_partition_scatter_kernel(q, e, ids.get(), n_batch, n_partitions, counts.get(), indata, inlen, records, indices).wait();
+        }
+    }
+
+    /**
+     * Splits `n_batch` records of `inlen` bytes in `n_partitions` partitions: record `i` goes to partition
+     * `h % n_partitions`, `h` being its 64-bit hash by `M` with `seed`. The partitions are contiguous and in order, the
+     * order of the records inside a partition is unspecified. Throws `std::invalid_argument` if `n_partitions` is 0.
+     * @tparam M Hash method, see `is_sketch_method`
+     * @param indices `n_batch` words in host or device memory receiving the indices of the records, partition after
+     * partition
+     * @param partition_offsets `n_partitions + 1` words in host or device memory, partition `p` is made of
+     * `indices[partition_offsets[p]]` to `indices[partition_offsets[p + 1] - 1]`
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    inline void partition_indices(sycl::queue &q, const byte *in, dword inlen, dword n_batch, dword n_partitions, dword *indices, qword *partition_offsets, qword seed = 0) {
+        internal::check_n_partitions(n_partitions);
+        internal::staged_buffer<const byte> staged_in(q, in, (size_t) n_batch * inlen);
+        internal::staged_buffer<dword> out(q, indices, n_batch, false);
+        internal::staged_buffer<qword> bounds(q, partition_offsets, n_partitions + 1, false);
+        internal::partition_on_device(q, M, device_accessible_ptr<byte>(staged_in.get()), device_accessible_ptr<qword>((qword *) nullptr), inlen, n_batch, n_partitions, seed,
+                                      device_accessible_ptr<byte>((byte *) nullptr), device_accessible_ptr<dword>(out.get()), device_accessible_ptr<qword>(bounds.get()));
+        out.copy_back(q);
+        bounds.copy_back(q);
+    }
+
+    /**
+     * Like `partition_indices`, but the records themselves are written to `out`, `n_batch * inlen` bytes in host or
+     * device memory.
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    inline void partition_records(sycl::queue &q, const byte *in, dword inlen, dword n_batch, dword n_partitions, byte *out, qword *partition_offsets, qword seed = 0) {
+        internal::check_n_partitions(n_partitions);
+        internal::staged_buffer<const byte> staged_in(q, in, (size_t) n_batch * inlen);
+        internal::staged_buffer<byte> records(q, out, (size_t) n_batch * inlen, false);
+        internal::staged_buffer<qword> bounds(q, partition_offsets, n_partitions + 1, false);
+        internal::partition_on_device(q, M, device_accessible_ptr<byte>(staged_in.get()), device_accessible_ptr<qword>((qword *) nullptr), inlen, n_batch, n_partitions, seed,
+                                      device_accessible_ptr<byte>(records.get()), device_accessible_ptr<dword>((dword *) nullptr), device_accessible_ptr<qword>(bounds.get()));
+        records.copy_back(q);
+        bounds.copy_back(q);
+    }
+
+    /**
+     * `partition_indices` for ragged records, each one hashed whole.
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    inline void partition_indices(sycl::queue &q, const ragged_documents &records, dword n_partitions, dword *indices, qword *partition_offsets, qword seed = 0) {
+        internal::check_n_partitions(n_partitions);
+        internal::staged_buffer<const qword> offsets(q, records.offsets, records.n_docs + 1);
+        qword data_len;
+        q.memcpy(&data_len, offsets.get() + records.n_docs, sizeof(qword)).wait();
+        internal::staged_buffer<const byte> data(q, records.data, data_len);
+        internal::staged_buffer<dword> out(q, indices, records.n_docs, false);
+        internal::staged_buffer<qword> bounds(q, partition_offsets, n_partitions + 1, false);
+        internal::partition_on_device(q, M, device_accessible_ptr<byte>(data.get()), device_accessible_ptr<qword>(offsets.get()), 0, records.n_docs, n_partitions, seed,
+                                      device_accessible_ptr<byte>((byte *) nullptr), device_accessible_ptr<dword>(out.get()), device_accessible_ptr<qword>(bounds.get()));
+        out.copy_back(q);
+        bounds.copy_back(q);
+    }
+
+    /**
+     * Partitions ragged records and writes them, partition after partition, as ragged records `{out_data, out_offsets}`.
+     * Record `i` of the output starts at `out_offsets[i]`, and partition `p` is made of the records
+     * `partition_offsets[p]` to `partition_offsets[p + 1] - 1`.
+     * @param out_data As many bytes as the records, host or device memory
+     * @param out_offsets `n_docs + 1` words in host or device memory, starting at 0
+     * @param partition_offsets `n_partitions + 1` words in host or device memory
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    inline void partition_records(sycl::queue &q, const ragged_documents &records, dword n_partitions, byte *out_data, qword *out_offsets, qword *partition_offsets, qword seed = 0) {
+        internal::check_n_partitions(n_partitions);
+        const dword n_batch = records.n_docs;
+        internal::staged_buffer<const qword> offsets(q, records.offsets, n_batch + 1);
+        qword first, data_len;
+        q.memcpy(&first, offsets.get(), sizeof(qword)).wait();
+        q.memcpy(&data_len, offsets.get() + n_batch, sizeof(qword)).wait();
+        internal::staged_buffer<const byte> data(q, records.data, data_len);
+        internal::staged_buffer<byte> out(q, out_data, data_len - first, false);
+        internal::staged_buffer<qword> staged_out_offsets(q, out_offsets, n_batch + 1, false);
+        internal::staged_buffer<qword> bounds(q, partition_offsets, n_partitions + 1, false);
+        auto indices = usm_unique_ptr<dword, alloc::device>(std::max<dword>(1, n_batch), q);
+        auto lengths = usm_unique_ptr<qword, alloc::device>(std::max<dword>(1, n_batch), q);
+
+        internal::partition_on_device(q, M, device_accessible_ptr<byte>(data.get()), device_accessible_ptr<qword>(offsets.get()), 0, n_batch, n_partitions, seed,
+                                      device_accessible_ptr<byte>((byte *) nullptr), indices.get(), device_accessible_ptr<qword>(bounds.get()));
+        if (n_batch) {
+            auto e = internal::launch_partition_lengths_kernel(q, sycl::event{}, device_accessible_ptr<qword>(offsets.get()), indices.get(), n_batch, lengths.get());
+            e = internal::launch_exclusive_scan_kernel(q, e, lengths.get(), n_batch, 1, device_accessible_ptr<qword>(staged_out_offsets.get()));
+            internal::launch_partition_gather_kernel(q, e, device_accessible_ptr<byte>(data.get()), device_accessible_ptr<qword>(offsets.get()), indices.get(), n_batch,
+                                                     device_accessible_ptr<byte>(out.get()), device_accessible_ptr<qword>(staged_out_offsets.get())).wait();
+        } else {
+            q.memset(staged_out_offsets.get(), 0, sizeof(qword)).wait();
+        }
+        out.copy_back(q);
+        staged_out_offsets.copy_back(q);
+        bounds.copy_back(q);
+    }
+
+}
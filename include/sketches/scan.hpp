@@ -0,0 +1,14 @@
+#pragma once
+
+#include "../internal/common.hpp"
+
+namespace hash::internal {
+    class exclusive_scan_kernel;
+
+    /**
+     * Exclusive prefix sum of `n` values, in place, by a single work-group. Also writes `bounds[i] = values[i * stride]`
+     * and the total in `bounds[n / stride]`, `n` being a multiple of `stride`.
+     */
+    sycl::event launch_exclusive_scan_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> values, size_t n, size_t stride, device_accessible_ptr<qword> bounds);
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../internal/common.hpp"
+#include "sketch_method.hpp"
+#include "staging.hpp"
+
+#include <stdexcept>
+
+namespace hash {
+    namespace internal {
+        template<method M>
+        class minhash_kernel;
+
+        template<method M>
+        class simhash_kernel;
+
+        /**
+         * One work-item per document: its shingles are hashed with `shingle_method` and the `k` minima are kept in
+         * the signature itself, so the shingle hashes are never stored.
+         */
+        sycl::event
+        launch_minhash_kernel(sycl::queue &q, sycl::event e, method shingle_method, device_accessible_ptr<byte> data, device_accessible_ptr<qword> offsets, dword n_docs, dword shingle_len, qword seed,
+                              dword k, device_accessible_ptr<qword> signatures);
+
+        sycl::event
+        launch_simhash_kernel(sycl::queue &q, sycl::event e, method shingle_method, device_accessible_ptr<byte> data, device_accessible_ptr<qword> offsets, dword n_docs, dword shingle_len, qword seed,
+                              device_accessible_ptr<qword> signatures);
+    }
+
+    /**
+     * The i-th MinHash function applied to the hash of a shingle: output i of a SplitMix64 generator seeded with it.
+     */
+    inline constexpr qword minhash_permutation(qword h, dword i) {
+        qword z = h + (qword) (i + 1) * 0x9e3779b97f4a7c15;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * Ragged documents: document `i` is made of the bytes `data[offsets[i]]` to `data[offsets[i + 1] - 1]`.
+     * A document has `len - shingle_len + 1` shingles of `shingle_len` consecutive bytes, a shorter one is a single
+     * shingle. An empty document has none.
+     */
+    struct ragged_documents {
+        const byte *data /** Host or device memory */;
+        const qword *offsets /** `n_docs + 1` offsets, host or device memory */;
+        dword n_docs;
+    };
+
+    namespace internal {
+        /**
+         * Throws `std::invalid_argument` for shingles of 0 bytes, which would make every signature the same.
+         */
+        inline void check_shingle_len(dword shingle_len) {
+            if (shingle_len == 0) {
+                throw std::invalid_argument("signatures: the shingles must be at least 1 byte long");
+            }
+        }
+
+        template<typename Launch>
+        inline void compute_signatures(sycl::queue &q, const ragged_documents &docs, qword *signatures, size_t signature_words, Launch &&launch) {
+            if (docs.n_docs == 0) return;
+            staged_buffer<const qword> offsets(q, docs.offsets, docs.n_docs + 1);
+            qword data_len;
+            q.memcpy(&data_len, offsets.get() + docs.n_docs, sizeof(qword)).wait();
+            staged_buffer<const byte> data(q, docs.data, data_len);
+            staged_buffer<qword> out(q, signatures, signature_words, false);
+            launch(device_accessible_ptr<byte>(data.get()), device_accessible_ptr<qword>(offsets.get()), device_accessible_ptr<qword>(out.get())).wait();
+            out.copy_back(q);
+        }
+    }
+
+    /**
+     * Computes the MinHash signature of each document: for each of the `k` functions `minhash_permutation(h, i)`, the
+     * minimum over the hashes `h` of its shingles. An empty document has all its minima at ~0. Throws
+     * `std::invalid_argument` if `shingle_len` is 0.
+     * @tparam M Method hashing the shingles, see `is_sketch_method`
+     * @param signatures `k * n_docs` words in host or device memory, `k` per document
+     * @param seed Seed of `M`, see `is_sketch_method`
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    inline void compute_minhash(sycl::queue &q, const ragged_documents &docs, dword shingle_len, dword k, qword *signatures, qword seed = 0) {
+        internal::check_shingle_len(shingle_len);
+        internal::compute_signatures(q, docs, signatures, (size_t) k * docs.n_docs, [&](auto data, auto offsets, auto out) {
+            return internal::launch_minhash_kernel(q, sycl::event{}, M, data, offsets, docs.n_docs, shingle_len, seed, k, out);
+        });
+    }
+
+    /**
+     * Computes the 64-bit SimHash of each document: bit b is set when most of its shingle hashes have bit b set. Throws
+     * `std::invalid_argument` if `shingle_len` is 0.
+     * @tparam M Method hashing the shingles, see `is_sketch_method`
+     * @param signatures `n_docs` words in host or device memory
+     * @param seed Seed of `M`, see `is_sketch_method`
+     */
+    template<method M, typename = std::enable_if_t<is_sketch_method<M>()>>
+    inline void compute_simhash(sycl::queue &q, const ragged_documents &docs, dword shingle_len, qword *signatures, qword seed = 0) {
+        internal::check_shingle_len(shingle_len);
+        internal::compute_signatures(q, docs, signatures, docs.n_docs, [&](auto data, auto offsets, auto out) {
+            return internal::launch_simhash_kernel(q, sycl::event{}, M, data, offsets, docs.n_docs, shingle_len, seed, out);
+        });
+    }
+
+}
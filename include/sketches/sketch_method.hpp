@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../internal/config.hpp"
+
+namespace hash {
+
+    /**
+     * Methods the sketch kernels can run on each item themselves, without writing the digests out. Their digest is read
+     * as a 64-bit value (`murmur3` gives `h1`), see `src/sketches/sketch_hash.hpp`. `murmur3` only takes the low
+     * 32 bits of the seeds, seeds differing in their high bits alone give the same hashes.
+     */
+    template<method M>
+    inline constexpr bool is_sketch_method() {
+        return M == method::xxhash64 || M == method::xxh3 || M == method::murmur3;
+    }
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../tools/sycl_queue_helpers.hpp"
+#include "../tools/usm_smart_ptr.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace hash::internal {
+    using namespace usm_smart_ptr;
+
+    /**
+     * A user buffer as seen by the device: the buffer itself when the queue can access it, otherwise a device copy that
+     * is filled from it (inputs) and/or written back to it (outputs).
+     */
+    template<typename T>
+    class staged_buffer {
+    private:
+        T *user_;
+        size_t count_;
+        bool in_place_;
+        usm_unique_ptr<std::remove_const_t<T>, alloc::device> copy_;
+
+    public:
+        /**
+         * @param copy_in whether the device needs the current content of the buffer
+         */
+        staged_buffer(sycl::queue &q, T *user, size_t count, bool copy_in = true) :
+                user_(user),
+                count_(count),
+                in_place_(is_ptr_usable(user, q)),
+                copy_(in_place_ ? 1 : std::max<size_t>(1, count), q) {
+            if (!in_place_ && copy_in && count_) {
+                q.memcpy(copy_.raw(), user_, sizeof(T) * count_).wait();
+            }
+        }
+
+        [[nodiscard]] inline T *get() const noexcept { return in_place_ ? user_ : copy_.raw(); }
+
+        /**
+         * Writes the device copy back to the user buffer, if there is one.
+         */
+        void copy_back(sycl::queue &q) const {
+            if (!in_place_ && count_) {
+                q.memcpy((void *) user_, copy_.raw(), sizeof(T) * count_).wait();
+            }
+        }
+    };
+
+}
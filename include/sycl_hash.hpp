@@ -3,3 +3,12 @@
 #include "internal/config.hpp"
 #include "internal/sync_api.hpp"
 #include "internal/async_api.hpp"
+#include "sketches/bloom_filter.hpp"
+#include "sketches/signatures.hpp"
+#include "sketches/hyperloglog.hpp"
+#include "sketches/count_min.hpp"
+#include "sketches/partition.hpp"
+#include "sketches/duplicates.hpp"
+#include "sketches/digest_index.hpp"
+#include "sketches/chunking.hpp"
+#include "io/file_hashing.hpp"
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <sycl/sycl.hpp>
+#include "../internal/config.hpp"
+#include "pointer_cache.hpp"
+
+namespace hash {
+
+    /**
+     * Registers existing host memory, such as a mapped file, with the runtime for as long as the object lives.
+     * On CPU and host devices the kernels read it in place, so it is hashed without a staging copy and `is_ptr_usable`
+     * accepts it. On other devices it still needs a copy: the memory is pinned to speed that copy up when the
+     * implementation supports it (DPC++ `prepare_for_device_copy`), and left as it is otherwise.
+     */
+    class host_registration {
+    private:
+        const void *ptr_;
+        size_t size_;
+        sycl::context context_;
+        bool in_place_;
+        bool pinned_ = false;
+
+    public:
+        host_registration(const void *ptr, size_t size, const sycl::queue &q) :
+                ptr_(ptr),
+                size_(size),
+                context_(q.get_context()),
+                in_place_(q.get_device().is_cpu() || q.get_device().is_host()) {
+            if (!ptr_ || !size_) {
+                return;
+            }
+            if (in_place_) {
+                internal::pointer_cache::instance().add(ptr_, size_, sycl::usm::alloc::unknown, std::nullopt);
+                return;
+            }
+#ifdef SYCL_EXT_ONEAPI_COPY_OPTIMIZE
+            try {
+                sycl::ext::oneapi::experimental::prepare_for_device_copy(ptr_, size_, context_);
+                pinned_ = true;
+            } catch (const sycl::exception &) {}
+#endif
+        }
+
+        host_registration(const host_registration &) = delete;
+
+        host_registration &operator=(const host_registration &) = delete;
+
+        ~host_registration() {
+            if (!ptr_ || !size_) {
+                return;
+            }
+            if (in_place_) {
+                internal::pointer_cache::instance().remove(ptr_, size_);
+            }
+#ifdef SYCL_EXT_ONEAPI_COPY_OPTIMIZE
+            if (pinned_) {
+                sycl::ext::oneapi::experimental::release_from_device_copy(ptr_, context_);
+            }
+#endif
+        }
+
+        /**
+         * Whether the kernels of the queue can read the memory without a copy.
+         */
+        [[nodiscard]] inline bool in_place() const noexcept { return in_place_; }
+
+        /**
+         * Whether the memory was pinned for faster copies.
+         */
+        [[nodiscard]] inline bool pinned() const noexcept { return pinned_; }
+    };
+
+}
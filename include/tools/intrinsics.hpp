@@ -36,6 +36,10 @@ namespace sbb {
         T new_val = (T(byte_in) & 0xFF) << (idx * 8);
         return (word & select_mask) + new_val;
     }
+
+    static inline constexpr uint32_t byte_swap(const uint32_t &word) {
+        return (word >> 24) | ((word >> 8) & 0x0000FF00) | ((word << 8) & 0x00FF0000) | (word << 24);
+    }
 }
 
 
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <sycl/sycl.hpp>
+#include "../internal/config.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace hash {
+
+    namespace internal {
+        /**
+         * What is known of a range of memory registered in the `pointer_cache`.
+         */
+        struct pointer_info {
+            const byte *begin;
+            const byte *end;
+            sycl::usm::alloc kind; /** USM kind, `alloc::unknown` for pageable host memory */
+            std::optional<sycl::context> context; /** Context of a USM allocation, none for pageable host memory */
+        };
+
+        /**
+         * Memory ranges whose kind is known: the USM allocations of this library and of the users that registered
+         * theirs, in an interval map, and the pageable host memory registered with `host_registration`, in a short
+         * list. With IMPLICIT_MEMORY_COPY, `is_ptr_usable` looks pointers up here before asking the runtime.
+         */
+        class pointer_cache {
+        private:
+            mutable std::shared_mutex mutex_;
+            std::multimap<const byte *, pointer_info> allocations_; // Whole allocations do not overlap, only the same one registered twice shares a start
+            std::vector<pointer_info> host_ranges_; // Few at a time, they may overlap and be as large as a mapped file
+
+        public:
+            static pointer_cache &instance() {
+                static pointer_cache cache;
+                return cache;
+            }
+
+            void add(const void *ptr, size_t size, sycl::usm::alloc kind, std::optional<sycl::context> context) {
+                if (!ptr || !size) return;
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                pointer_info info{(const byte *) ptr, (const byte *) ptr + size, kind, std::move(context)};
+                if (info.context) {
+                    allocations_.emplace(info.begin, std::move(info));
+                } else {
+                    host_ranges_.emplace_back(std::move(info));
+                }
+            }
+
+            /**
+             * Removes the range of a pageable memory registration.
+             */
+            void remove(const void *ptr, size_t size) {
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                auto it = std::find_if(host_ranges_.begin(), host_ranges_.end(), [&](const pointer_info &info) {
+                    return info.begin == (const byte *) ptr && info.end == (const byte *) ptr + size;
+                });
+                if (it != host_ranges_.end()) {
+                    host_ranges_.erase(it);
+                }
+            }
+
+            /**
+             * Removes the USM allocation starting at `ptr`, before it is freed.
+             */
+            void remove(const void *ptr) {
+                if (!ptr) return;
+                std::unique_lock<std::shared_mutex> lock(mutex_);
+                auto it = allocations_.find((const byte *) ptr);
+                if (it != allocations_.end()) {
+                    allocations_.erase(it);
+                }
+            }
+
+            /**
+             * @return the registered range containing `ptr`, preferring a USM allocation
+             */
+            [[nodiscard]] std::optional<pointer_info> find(const void *ptr) const {
+                const auto *p = (const byte *) ptr;
+                std::shared_lock<std::shared_mutex> lock(mutex_);
+                /* Only the allocations starting at the last start before p can contain it */
+                auto it = allocations_.upper_bound(p);
+                if (it != allocations_.begin()) {
+                    const byte *begin = std::prev(it)->first;
+                    for (; it != allocations_.begin() && std::prev(it)->first == begin; --it) {
+                        if (std::prev(it)->second.end > p) {
+                            return std::prev(it)->second;
+                        }
+                    }
+                }
+                for (const auto &info: host_ranges_) {
+                    if (info.begin <= p && info.end > p) {
+                        return info;
+                    }
+                }
+                return std::nullopt;
+            }
+        };
+    }
+
+    /**
+     * Registers a whole USM allocation made by the user, so that checking the pointers in it is a lookup instead of a
+     * call to the runtime. Allocations of this library are registered by `usm_unique_ptr` and `usm_shared_ptr`.
+     * Throws `std::invalid_argument` if the memory is not a USM allocation of the context of the queue.
+     */
+    inline void register_usm_allocation(const void *ptr, size_t size, const sycl::queue &q) {
+        const sycl::usm::alloc kind = sycl::get_pointer_type(ptr, q.get_context());
+        if (kind == sycl::usm::alloc::unknown) {
+            throw std::invalid_argument("Not a USM allocation of the context of the queue");
+        }
+        internal::pointer_cache::instance().add(ptr, size, kind, q.get_context());
+    }
+
+    /**
+     * To be called before freeing an allocation registered with `register_usm_allocation`.
+     */
+    inline void unregister_usm_allocation(const void *ptr) {
+        internal::pointer_cache::instance().remove(ptr);
+    }
+
+}
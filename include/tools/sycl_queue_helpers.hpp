@@ -3,6 +3,7 @@
 #include <sycl/sycl.hpp>
 #include <iostream>
 #include "../internal/common.hpp"
+#include "host_registration.hpp"
 
 #ifdef USING_COMPUTECPP
 class queue_kernel_tester;
@@ -98,6 +99,16 @@ inline bool valid_pointer(T *p) {
     return msync(base, sizeof(T), MS_ASYNC) == 0;
 }
 
+/**
+ * Whether the kernels of a device should use memory of a USM kind in place.
+ */
+inline bool usm_kind_usable(sycl::usm::alloc kind, const sycl::device &device) {
+    return kind == sycl::usm::alloc::shared // Shared memory is ok
+           || kind == sycl::usm::alloc::device // Device memory is ok
+           || (kind == sycl::usm::alloc::host && device.is_cpu()) // We discard host allocated memory because of poor performance unless on the CPU
+            ;
+}
+
 #endif
 
 
@@ -106,7 +117,15 @@ inline bool is_ptr_usable([[maybe_unused]] const T *ptr, [[maybe_unused]] const
 #ifndef IMPLICIT_MEMORY_COPY
     return false; // If we're not doing implicit memory copies, this test should always fail
 #else
-    if (q.get_device().is_host()) {
+    const sycl::device device = q.get_device();
+    if (auto info = hash::internal::pointer_cache::instance().find(ptr)) {
+        if (!info->context) {
+            return device.is_cpu() || device.is_host(); // Registered with hash::host_registration
+        }
+        return device.is_host() || (*info->context == q.get_context() && usm_kind_usable(info->kind, device));
+    }
+
+    if (device.is_host()) {
         return valid_pointer(ptr);
     }
 
@@ -130,10 +149,7 @@ inline bool is_ptr_usable([[maybe_unused]] const T *ptr, [[maybe_unused]] const
                     break;
             }
         }
-        return alloc_type == sycl::usm::alloc::shared // Shared memory is ok
-               || alloc_type == sycl::usm::alloc::device // Device memory is ok
-               || (alloc_type == sycl::usm::alloc::host && q.get_device().is_cpu()) // We discard host allocated memory because of poor performance unless on the CPU
-                ;
+        return usm_kind_usable(alloc_type, device);
     } catch (...) {
         if constexpr (debug) {
             std::cerr << "Not allocated on:" << q.get_device().get_info<sycl::info::device::name>() << '\n';
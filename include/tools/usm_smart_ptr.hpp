@@ -14,6 +14,7 @@ namespace cl::sycl::usm {
 
 
 #include "missing_implementations.hpp"
+#include "pointer_cache.hpp"
 
 
 namespace usm_smart_ptr {
@@ -77,6 +78,16 @@ namespace usm_smart_ptr {
     };
 
 
+/**
+ * Allocates USM memory registered in the pointer cache, so that `is_ptr_usable` finds it without asking the runtime.
+ */
+    template<typename T>
+    inline T *usm_malloc_registered(size_t count, const sycl::queue &q, sycl::usm::alloc location) {
+        T *ptr = sycl::malloc<T>(count, q, location);
+        hash::internal::pointer_cache::instance().add(ptr, count * sizeof(T), location, q.get_context());
+        return ptr;
+    }
+
 /**
  * SYCL USM Deleter. The std::unique_ptr deleter takes only the pointer
  * to delete as an argument so that's the only work-around.
@@ -88,8 +99,10 @@ namespace usm_smart_ptr {
         explicit usm_deleter(const sycl::queue &q) : q_(q) {}
 
         void operator()(T *ptr) const noexcept {
-            if (ptr)
+            if (ptr) {
+                hash::internal::pointer_cache::instance().remove(ptr);
                 sycl::free(ptr, q_);
+            }
         }
     };
 
@@ -103,7 +116,7 @@ namespace usm_smart_ptr {
         size_t count_;
     public:
         usm_unique_ptr(size_t count, sycl::queue q)
-                : std::unique_ptr<T, usm_deleter<T>>(sycl::malloc<T>(count, q, location), usm_deleter<T>{q}) { count_ = count; }
+                : std::unique_ptr<T, usm_deleter<T>>(usm_malloc_registered<T>(count, q, location), usm_deleter<T>{q}) { count_ = count; }
 
         explicit usm_unique_ptr(sycl::queue q) :
                 usm_unique_ptr(1, q) { count_ = 1; }
@@ -134,7 +147,7 @@ namespace usm_smart_ptr {
         size_t count_;
 
     public:
-        usm_shared_ptr(size_t count, sycl::queue q) : std::shared_ptr<T>(sycl::malloc<T>(count, q, location), usm_deleter<T>{q}) { count_ = count; }
+        usm_shared_ptr(size_t count, sycl::queue q) : std::shared_ptr<T>(usm_malloc_registered<T>(count, q, location), usm_deleter<T>{q}) { count_ = count; }
 
         explicit usm_shared_ptr(sycl::queue q) :
                 usm_shared_ptr(1, q) { count_ = 1; }
@@ -83,3 +83,31 @@ void run_benchmark(sycl::queue q, size_t input_block_size, size_t n_blocs, size_
     auto gflops = benchmark_one_queue<M, args...>(q, input_block_size, n_blocs, n_iters);
     std::cout << "\nGB hashed per sec: " << gflops << "\n\n";
 }
+
+
+/**
+ * Runs a method that reads a lookup table (md2, sha256) with every table placement.
+ * The fastest one should be the default returned by `hash::internal::resolve_table_placement` for that kind of device.
+ */
+template<hash::method M>
+void benchmark_table_placements(sycl::queue q, size_t input_block_size, size_t n_blocs, size_t n_iters) {
+    std::cout << "Table placements for " << hash::get_name<M>() << " on:" << q.get_device().get_info<sycl::info::device::name>() << ":\n";
+    auto all_input_data = usm_unique_ptr<byte, alloc::device>(input_block_size * n_blocs, q);
+    auto all_output_hashes = usm_unique_ptr<byte, alloc::device>(hash::get_block_size<M>() * n_blocs, q);
+    const std::pair<hash::table_placement, const char *> placements[] = {
+            {hash::table_placement::private_memory,  "private"},
+            {hash::table_placement::local_memory,    "local"},
+            {hash::table_placement::constant_memory, "constant"}};
+
+    for (const auto &[placement, name]: placements) {
+        hash::internal::dispatch_hash<M, 0>(q, sycl::event{}, all_input_data.get(), all_output_hashes.get(), input_block_size, n_blocs, nullptr, 0, placement).wait();/* Preheat */
+        auto before = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < n_iters; ++i) {
+            hash::internal::dispatch_hash<M, 0>(q, sycl::event{}, all_input_data.get(), all_output_hashes.get(), input_block_size, n_blocs, nullptr, 0, placement).wait();
+        }
+        auto after = std::chrono::steady_clock::now();
+        auto time = std::chrono::duration<double, std::milli>(after - before).count();
+        std::cout << std::setw(10) << name << ": " << (double) n_iters / time * (double) (input_block_size * n_blocs) / 1e6 << " GB/s\n";
+    }
+    std::cout << '\n';
+}
@@ -7,7 +7,9 @@
 
 using namespace usm_smart_ptr;
 
-static const qword GLOBAL_BLAKE2B_IVS[8]
+using qword4 = sycl::vec<qword, 4>;
+
+static constexpr qword GLOBAL_BLAKE2B_IVS[8]
         = {0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b,
            0xa54ff53a5f1d36f1, 0x510e527fade682d1, 0x9b05688c2b3e6c1f,
            0x1f83d9abfb41bd6b, 0x5be0cd19137e2179};
@@ -32,7 +34,8 @@ static inline void blake2b_init(blake2b_ctx *ctx, const byte *key, dword keylen,
     ctx->chain[6] = GLOBAL_BLAKE2B_IVS[6];
     ctx->chain[7] = GLOBAL_BLAKE2B_IVS[7];
 
-    ctx->pos = BLAKE2B_BLOCK_LENGTH;
+    /* The key, padded to a block, is the first block of the message. Without key there is no such block. */
+    ctx->pos = keylen ? BLAKE2B_BLOCK_LENGTH : 0;
 }
 
 
@@ -83,23 +86,23 @@ static inline void blake2b_init_state(blake2b_ctx *ctx) {
     ctx->state[15] = ivs[7];
 }
 
-static inline void blake2b_compress(blake2b_ctx *ctx, const byte *in, dword inoffset) {
+static constexpr byte BLAKE2B_SIGMAS[12][16] =
+        {{0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15},
+         {14, 10, 4,  8,  9,  15, 13, 6,  1,  12, 0,  2,  11, 7,  5,  3},
+         {11, 8,  12, 0,  5,  2,  15, 13, 10, 14, 3,  6,  7,  1,  9,  4},
+         {7,  9,  3,  1,  13, 12, 11, 14, 2,  6,  5,  10, 4,  0,  15, 8},
+         {9,  0,  5,  7,  2,  4,  10, 15, 14, 1,  11, 12, 6,  8,  3,  13},
+         {2,  12, 6,  10, 0,  11, 8,  3,  4,  13, 7,  5,  15, 14, 1,  9},
+         {12, 5,  1,  15, 14, 13, 4,  10, 0,  7,  6,  3,  9,  2,  8,  11},
+         {13, 11, 7,  14, 12, 1,  3,  9,  5,  0,  15, 4,  8,  6,  2,  10},
+         {6,  15, 14, 9,  11, 3,  0,  8,  12, 2,  13, 7,  1,  4,  10, 5},
+         {10, 2,  8,  4,  7,  6,  1,  5,  15, 11, 9,  14, 3,  12, 13, 0},
+         {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15},
+         {14, 10, 4,  8,  9,  15, 13, 6,  1,  12, 0,  2,  11, 7,  5,  3}};
+
+static inline void blake2b_compress_scalar(blake2b_ctx *ctx, const byte *in, dword inoffset) {
     blake2b_init_state(ctx);
 
-    static const byte sigmas[12][16] =
-            {{0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15},
-             {14, 10, 4,  8,  9,  15, 13, 6,  1,  12, 0,  2,  11, 7,  5,  3},
-             {11, 8,  12, 0,  5,  2,  15, 13, 10, 14, 3,  6,  7,  1,  9,  4},
-             {7,  9,  3,  1,  13, 12, 11, 14, 2,  6,  5,  10, 4,  0,  15, 8},
-             {9,  0,  5,  7,  2,  4,  10, 15, 14, 1,  11, 12, 6,  8,  3,  13},
-             {2,  12, 6,  10, 0,  11, 8,  3,  4,  13, 7,  5,  15, 14, 1,  9},
-             {12, 5,  1,  15, 14, 13, 4,  10, 0,  7,  6,  3,  9,  2,  8,  11},
-             {13, 11, 7,  14, 12, 1,  3,  9,  5,  0,  15, 4,  8,  6,  2,  10},
-             {6,  15, 14, 9,  11, 3,  0,  8,  12, 2,  13, 7,  1,  4,  10, 5},
-             {10, 2,  8,  4,  7,  6,  1,  5,  15, 11, 9,  14, 3,  12, 13, 0},
-             {0,  1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14, 15},
-             {14, 10, 4,  8,  9,  15, 13, 6,  1,  12, 0,  2,  11, 7,  5,  3}};
-
     qword m[16];
 #pragma unroll
     for (dword j = 0; j < 16; j++) {
@@ -107,7 +110,7 @@ static inline void blake2b_compress(blake2b_ctx *ctx, const byte *in, dword inof
     }
 
 #pragma unroll
-    for (auto sigma: sigmas) {
+    for (auto sigma: BLAKE2B_SIGMAS) {
         blake2b_G({ctx, m[sigma[0]], m[sigma[1]], 0, 4, 8, 12});
         blake2b_G({ctx, m[sigma[2]], m[sigma[3]], 1, 5, 9, 13});
         blake2b_G({ctx, m[sigma[4]], m[sigma[5]], 2, 6, 10, 14});
@@ -123,6 +126,72 @@ static inline void blake2b_compress(blake2b_ctx *ctx, const byte *in, dword inof
         ctx->chain[offset] = ctx->chain[offset] ^ ctx->state[offset] ^ ctx->state[offset + 8];
 }
 
+
+static inline qword4 blake2b_ROTR64(qword4 a, byte b) { return (a >> (qword) b) | (a << (qword) (64 - b)); }
+
+/**
+ * Runs the G function on the four columns (or, once diagonalised, the four diagonals) of the state at once.
+ * Each argument holds one row of the 4x4 state matrix.
+ */
+static inline void blake2b_G_rows(qword4 &a, qword4 &b, qword4 &c, qword4 &d, const qword4 &m1, const qword4 &m2) {
+    a = a + b + m1;
+    d = blake2b_ROTR64(d ^ a, 32);
+    c = c + d;
+    b = blake2b_ROTR64(b ^ c, 24);
+    a = a + b + m2;
+    d = blake2b_ROTR64(d ^ a, 16);
+    c = c + d;
+    b = blake2b_ROTR64(b ^ c, 63);
+}
+
+/**
+ * Same as blake2b_compress_scalar but the state is kept in four 256-bit rows. After the column step, rows b, c and d
+ * are rotated so that the diagonals line up as columns, which lets the diagonal step run with the same vector code.
+ * This is what gets a single message to use the SIMD units of a CPU.
+ */
+static inline void blake2b_compress_rows(blake2b_ctx *ctx, const byte *in, dword inoffset) {
+    qword m[16];
+#pragma unroll
+    for (dword j = 0; j < 16; j++) {
+        m[j] = blake2b_leuint64(in + inoffset + (j << 3));
+    }
+
+    qword4 a{ctx->chain[0], ctx->chain[1], ctx->chain[2], ctx->chain[3]};
+    qword4 b{ctx->chain[4], ctx->chain[5], ctx->chain[6], ctx->chain[7]};
+    qword4 c{GLOBAL_BLAKE2B_IVS[0], GLOBAL_BLAKE2B_IVS[1], GLOBAL_BLAKE2B_IVS[2], GLOBAL_BLAKE2B_IVS[3]};
+    qword4 d{ctx->t0 ^ GLOBAL_BLAKE2B_IVS[4], ctx->t1 ^ GLOBAL_BLAKE2B_IVS[5], ctx->f0 ^ GLOBAL_BLAKE2B_IVS[6], GLOBAL_BLAKE2B_IVS[7]};
+
+#pragma unroll
+    for (auto sigma: BLAKE2B_SIGMAS) {
+        blake2b_G_rows(a, b, c, d, qword4{m[sigma[0]], m[sigma[2]], m[sigma[4]], m[sigma[6]]}, qword4{m[sigma[1]], m[sigma[3]], m[sigma[5]], m[sigma[7]]});
+        b = b.template swizzle<1, 2, 3, 0>();
+        c = c.template swizzle<2, 3, 0, 1>();
+        d = d.template swizzle<3, 0, 1, 2>();
+        blake2b_G_rows(a, b, c, d, qword4{m[sigma[8]], m[sigma[10]], m[sigma[12]], m[sigma[14]]}, qword4{m[sigma[9]], m[sigma[11]], m[sigma[13]], m[sigma[15]]});
+        b = b.template swizzle<3, 0, 1, 2>();
+        c = c.template swizzle<2, 3, 0, 1>();
+        d = d.template swizzle<1, 2, 3, 0>();
+    }
+
+    a ^= c;
+    b ^= d;
+#pragma unroll
+    for (dword offset = 0; offset < 4; offset++) {
+        ctx->chain[offset] ^= a[offset];
+        ctx->chain[offset + 4] ^= b[offset];
+    }
+}
+
+template<bool row_vectorized>
+static inline void blake2b_compress(blake2b_ctx *ctx, const byte *in, dword inoffset) {
+    if constexpr (row_vectorized) {
+        blake2b_compress_rows(ctx, in, inoffset);
+    } else {
+        blake2b_compress_scalar(ctx, in, inoffset);
+    }
+}
+
+template<bool row_vectorized>
 static inline void blake2b_update(blake2b_ctx *ctx, const byte *in, qword inlen) {
     if (inlen == 0)
         return;
@@ -136,7 +205,7 @@ static inline void blake2b_update(blake2b_ctx *ctx, const byte *in, qword inlen)
             memcpy(ctx->buff + ctx->pos, in, start);
             ctx->t0 += BLAKE2B_BLOCK_LENGTH;
             if (ctx->t0 == 0) ctx->t1++;
-            blake2b_compress(ctx, ctx->buff, 0);
+            blake2b_compress<row_vectorized>(ctx, ctx->buff, 0);
             ctx->pos = 0;
             memset(ctx->buff, 0, BLAKE2B_BLOCK_LENGTH);
         } else {
@@ -152,20 +221,21 @@ static inline void blake2b_update(blake2b_ctx *ctx, const byte *in, qword inlen)
         if (ctx->t0 == 0)
             ctx->t1++;
 
-        blake2b_compress(ctx, in, in_index);
+        blake2b_compress<row_vectorized>(ctx, in, in_index);
     }
 
     memcpy(ctx->buff, in + in_index, inlen - (size_t) in_index);
     ctx->pos += (inlen - (size_t) in_index);
 }
 
+template<bool row_vectorized>
 static inline void blake2b_final(blake2b_ctx *ctx, byte *out) {
     ctx->f0 = 0xFFFFFFFFFFFFFFFFL;
     ctx->t0 += ctx->pos;
     if (ctx->pos > 0 && ctx->t0 == 0)
         ctx->t1++;
 
-    blake2b_compress(ctx, ctx->buff, 0);
+    blake2b_compress<row_vectorized>(ctx, ctx->buff, 0);
     memset(ctx->buff, 0, BLAKE2B_BLOCK_LENGTH);
     memset(ctx->state, 0, BLAKE2B_STATE_LENGTH);
 
@@ -179,23 +249,33 @@ static inline void blake2b_final(blake2b_ctx *ctx, byte *out) {
     }
 }
 
-static inline void kernel_blake2b_hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, dword block_size, dword thread,
+template<bool row_vectorized>
+static inline void kernel_blake2b_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword block_size, dword thread,
                                        const blake2b_ctx *ctx) {
 
     if (thread >= n_batch) {
         return;
     }
-    const byte *in = indata + thread * inlen;
-    byte *out = outdata + thread * block_size;
+    const byte *in = indata.record(thread, inlen);
+    byte out[BLAKE2B_CHAIN_LENGTH];
     auto local_ctx = *ctx;
     //if not precomputed CTX, call cuda_blake2b_init() with key
-    blake2b_update(&local_ctx, in, inlen);
-    blake2b_final(&local_ctx, out);
+    blake2b_update<row_vectorized>(&local_ctx, in, inlen);
+    blake2b_final<row_vectorized>(&local_ctx, out);
+    outdata.store(out, block_size, thread, n_batch);
 }
 
 
 namespace hash::internal {
 
+    bool use_blake2b_row_vectorized(const sycl::queue &q, dword inlen, dword n_batch) {
+        if (!q.get_device().is_cpu() || inlen < BLAKE2B_ROW_VECTORIZED_MIN_INLEN) {
+            return false;
+        }
+        /* With enough items every core already gets its own message, the scalar kernel is then as good. */
+        return n_batch < q.get_device().get_info<sycl::info::device::max_compute_units>();
+    }
+
     usm_shared_ptr<blake2b_ctx, alloc::device> get_blake2b_ctx(sycl::queue &q, const byte *key, dword keylen, dword n_outbit) {
         auto ctxt_device = usm_shared_ptr<blake2b_ctx, alloc::device>(1, q);
         blake2b_ctx ctx = {};
@@ -206,24 +286,34 @@ namespace hash::internal {
 
 
     sycl::event
-    launch_blake2b_kernel(sycl::queue &item, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, dword n_outbit, const byte *,
+    launch_blake2b_kernel(sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, dword n_outbit, const byte *,
                           dword, const device_accessible_ptr<blake2b_ctx> ctx) {
         const dword block_size = n_outbit >> 3;
         //  assert(keylen <= 128); // we must define keylen at host
         auto config = get_kernel_sizes(item, n_batch);
+        if (use_blake2b_row_vectorized(item, inlen, n_batch)) {
+            return item.submit([&](sycl::handler &cgh) {
+                cgh.depends_on(e);
+                cgh.parallel_for<class blake2b_vectorized_kernel>(
+                        sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                        [=](sycl::nd_item<1> item) {
+                            kernel_blake2b_hash<true>(indata, inlen, outdata, n_batch, block_size, item.get_global_linear_id(), ctx);
+                        });
+            });
+        }
         return item.submit([&](sycl::handler &cgh) {
             cgh.depends_on(e);
             cgh.parallel_for<class blake2b_kernel>(
                     sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
                     [=](sycl::nd_item<1> item) {
-                        kernel_blake2b_hash(indata, inlen, outdata, n_batch, block_size, item.get_global_linear_id(), ctx);
+                        kernel_blake2b_hash<false>(indata, inlen, outdata, n_batch, block_size, item.get_global_linear_id(), ctx);
                     });
         });
     }
 
 
     sycl::event
-    launch_blake2b_kernel(sycl::queue &item, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, dword n_outbit, const byte *key,
+    launch_blake2b_kernel(sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, dword n_outbit, const byte *key,
                           dword keylen) {
         auto ptr = get_blake2b_ctx(item, key, keylen, n_outbit);
         launch_blake2b_kernel(item, std::move(e), indata, outdata, inlen, n_batch, n_outbit, key, keylen, ptr.get()).wait();
@@ -0,0 +1,84 @@
+/**
+ * Reflected CRCs (CRC32C, CRC64-NVME) with tables computed at compile time.
+ * The byte-wise update needs one table of 256 entries, slice-by-8 needs eight and consumes 8 bytes per step.
+ */
+
+#pragma once
+
+#include <array>
+#include <internal/config.hpp>
+
+#include <cstring>
+
+template<typename T>
+using crc_table = std::array<T, 256>;
+
+template<typename T>
+using crc_slice_tables = std::array<crc_table<T>, 8>;
+
+/**
+ * @tparam poly the reflected polynomial
+ */
+template<typename T, T poly>
+constexpr crc_slice_tables<T> make_crc_slice_tables() {
+    crc_slice_tables<T> tables{};
+    for (dword i = 0; i < 256; ++i) {
+        T crc = i;
+        for (dword bit = 0; bit < 8; ++bit) {
+            crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (dword k = 1; k < 8; ++k) {
+        for (dword i = 0; i < 256; ++i) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+        }
+    }
+    return tables;
+}
+
+/**
+ * @param table 256 entries, in private, local or constant memory
+ */
+template<typename T, typename Table>
+static inline T crc_update_bytewise(T crc, const byte *p, qword len, const Table &table) {
+    for (qword i = 0; i < len; ++i) {
+        crc = (crc >> 8) ^ table[(crc ^ p[i]) & 0xff];
+    }
+    return crc;
+}
+
+/**
+ * Slice-by-8: the CRC is xored with 8 input bytes that are then looked up in the 8 tables at once.
+ */
+template<typename T>
+static inline T crc_update_sliced(T crc, const byte *p, qword len, const crc_slice_tables<T> &tables) {
+    qword i = 0;
+    for (; i + 8 <= len; i += 8) {
+        qword v;
+        memcpy(&v, p + i, sizeof(qword));
+        v ^= crc;
+        crc = tables[7][v & 0xff] ^ tables[6][(v >> 8) & 0xff] ^ tables[5][(v >> 16) & 0xff] ^ tables[4][(v >> 24) & 0xff] ^
+              tables[3][(v >> 32) & 0xff] ^ tables[2][(v >> 40) & 0xff] ^ tables[1][(v >> 48) & 0xff] ^ tables[0][v >> 56];
+    }
+    return crc_update_bytewise(crc, p + i, len - i, tables[0]);
+}
+
+/**
+ * Writes the CRC most significant byte first.
+ */
+template<typename T>
+static inline void crc_store(T crc, byte *out) {
+#pragma unroll
+    for (dword i = 0; i < sizeof(T); ++i) {
+        out[i] = (byte) (crc >> (8 * (sizeof(T) - 1 - i)));
+    }
+}
+
+
+/**************************** VARIABLES *****************************/
+static constexpr crc_slice_tables<dword> CRC32C_TABLES = make_crc_slice_tables<dword, 0x82f63b78>();
+static constexpr crc_table<dword> CRC32C_TABLE = CRC32C_TABLES[0];
+
+static constexpr crc_slice_tables<qword> CRC64NVME_TABLES = make_crc_slice_tables<qword, 0x9a6c9329ac4bc9b5>();
+static constexpr crc_table<qword> CRC64NVME_TABLE = CRC64NVME_TABLES[0];
@@ -0,0 +1,94 @@
+/**
+ * MurmurHash3 x64 128-bit, following the reference implementation https://github.com/aappleby/smhasher
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+
+#include <cstring>
+
+/**************************** VARIABLES *****************************/
+constexpr qword MURMUR3_C1 = 0x87c37b91114253d5;
+constexpr qword MURMUR3_C2 = 0x4cf5ad432745937f;
+
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+static inline qword murmur3_rotl64(qword x, dword r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline qword murmur3_fmix64(qword k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccd;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53;
+    k ^= k >> 33;
+    return k;
+}
+
+static inline qword murmur3_mix_k1(qword k1) {
+    k1 *= MURMUR3_C1;
+    k1 = murmur3_rotl64(k1, 31);
+    return k1 * MURMUR3_C2;
+}
+
+static inline qword murmur3_mix_k2(qword k2) {
+    k2 *= MURMUR3_C2;
+    k2 = murmur3_rotl64(k2, 33);
+    return k2 * MURMUR3_C1;
+}
+
+/**
+ * @param seed the reference takes a 32-bit seed
+ * @param out h1 and h2, the digest is their little endian bytes one after the other
+ */
+static inline void murmur3_x64_128(const byte *input, qword len, dword seed, qword out[2]) {
+    qword h1 = seed;
+    qword h2 = seed;
+    const qword n_blocks = len / 16;
+
+    for (qword i = 0; i < n_blocks; ++i) {
+        qword k1, k2;
+        memcpy(&k1, input + 16 * i, sizeof(qword));
+        memcpy(&k2, input + 16 * i + 8, sizeof(qword));
+
+        h1 ^= murmur3_mix_k1(k1);
+        h1 = murmur3_rotl64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+
+        h2 ^= murmur3_mix_k2(k2);
+        h2 = murmur3_rotl64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const byte *tail = input + 16 * n_blocks;
+    const dword tail_len = len & 15;
+    qword k1 = 0;
+    qword k2 = 0;
+    for (dword i = 8; i < tail_len; ++i) {
+        k2 ^= (qword) tail[i] << (8 * (i - 8));
+    }
+    for (dword i = 0; i < tail_len && i < 8; ++i) {
+        k1 ^= (qword) tail[i] << (8 * i);
+    }
+    if (tail_len > 8) {
+        h2 ^= murmur3_mix_k2(k2);
+    }
+    if (tail_len > 0) {
+        h1 ^= murmur3_mix_k1(k1);
+    }
+
+    h1 ^= len;
+    h2 ^= len;
+    h1 += h2;
+    h2 += h1;
+    h1 = murmur3_fmix64(h1);
+    h2 = murmur3_fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    out[0] = h1;
+    out[1] = h2;
+}
@@ -0,0 +1,108 @@
+/**
+ * RIPEMD-160 compression function, only used on fixed size messages (hash160) so there is no streaming context.
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+
+/**************************** VARIABLES *****************************/
+static constexpr dword RIPEMD160_IV[5] = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0};
+
+static constexpr dword RIPEMD160_K_LEFT[5] = {0x00000000, 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xa953fd4e};
+static constexpr dword RIPEMD160_K_RIGHT[5] = {0x50a28be6, 0x5c4dd124, 0x6d703ef3, 0x7a6d76e9, 0x00000000};
+
+/* Message word selection */
+static constexpr byte RIPEMD160_R_LEFT[80] =
+        {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+         7, 4, 13, 1, 10, 6, 15, 3, 12, 0, 9, 5, 2, 14, 11, 8,
+         3, 10, 14, 4, 9, 15, 8, 1, 2, 7, 0, 6, 13, 11, 5, 12,
+         1, 9, 11, 10, 0, 8, 12, 4, 13, 3, 7, 15, 14, 5, 6, 2,
+         4, 0, 5, 9, 7, 12, 2, 10, 14, 1, 3, 8, 11, 6, 15, 13};
+
+static constexpr byte RIPEMD160_R_RIGHT[80] =
+        {5, 14, 7, 0, 9, 2, 11, 4, 13, 6, 15, 8, 1, 10, 3, 12,
+         6, 11, 3, 7, 0, 13, 5, 10, 14, 15, 8, 12, 4, 9, 1, 2,
+         15, 5, 1, 3, 7, 14, 6, 9, 11, 8, 12, 2, 10, 0, 4, 13,
+         8, 6, 4, 1, 3, 11, 15, 0, 5, 12, 2, 13, 9, 7, 10, 14,
+         12, 15, 10, 4, 1, 5, 8, 7, 6, 2, 13, 14, 0, 3, 9, 11};
+
+/* Rotation amounts */
+static constexpr byte RIPEMD160_S_LEFT[80] =
+        {11, 14, 15, 12, 5, 8, 7, 9, 11, 13, 14, 15, 6, 7, 9, 8,
+         7, 6, 8, 13, 11, 9, 7, 15, 7, 12, 15, 9, 11, 7, 13, 12,
+         11, 13, 6, 7, 14, 9, 13, 15, 14, 8, 13, 6, 5, 12, 7, 5,
+         11, 12, 14, 15, 14, 15, 9, 8, 9, 14, 5, 6, 8, 6, 5, 12,
+         9, 15, 5, 11, 6, 8, 13, 12, 5, 12, 13, 14, 11, 8, 5, 6};
+
+static constexpr byte RIPEMD160_S_RIGHT[80] =
+        {8, 9, 9, 11, 13, 15, 15, 5, 7, 7, 8, 11, 14, 14, 12, 6,
+         9, 13, 15, 7, 12, 8, 9, 11, 7, 7, 12, 7, 6, 15, 13, 11,
+         9, 7, 15, 11, 8, 6, 6, 14, 12, 13, 5, 14, 13, 13, 7, 5,
+         15, 5, 8, 11, 14, 14, 6, 14, 6, 9, 12, 9, 12, 5, 15, 8,
+         8, 5, 12, 9, 12, 5, 14, 6, 8, 13, 6, 5, 15, 13, 11, 11};
+
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+static inline dword ripemd160_rotl(dword x, dword n) {
+    return (x << n) | (x >> (32 - n));
+}
+
+/**
+ * Boolean function of the round `j` (0 to 79). The right line uses them in the reverse order.
+ */
+static inline dword ripemd160_f(dword j, dword x, dword y, dword z) {
+    if (j < 16) {
+        return x ^ y ^ z;
+    } else if (j < 32) {
+        return (x & y) | (~x & z);
+    } else if (j < 48) {
+        return (x | ~y) ^ z;
+    } else if (j < 64) {
+        return (x & z) | (y & ~z);
+    } else {
+        return x ^ (y | ~z);
+    }
+}
+
+/**
+ * Compresses one block given as 16 little endian words.
+ */
+static inline void ripemd160_transform_words(dword state[5], const dword *words) {
+    dword al = state[0], bl = state[1], cl = state[2], dl = state[3], el = state[4];
+    dword ar = al, br = bl, cr = cl, dr = dl, er = el;
+
+#pragma unroll
+    for (dword j = 0; j < 80; ++j) {
+        dword t = ripemd160_rotl(al + ripemd160_f(j, bl, cl, dl) + words[RIPEMD160_R_LEFT[j]] + RIPEMD160_K_LEFT[j / 16], RIPEMD160_S_LEFT[j]) + el;
+        al = el;
+        el = dl;
+        dl = ripemd160_rotl(cl, 10);
+        cl = bl;
+        bl = t;
+
+        t = ripemd160_rotl(ar + ripemd160_f(79 - j, br, cr, dr) + words[RIPEMD160_R_RIGHT[j]] + RIPEMD160_K_RIGHT[j / 16], RIPEMD160_S_RIGHT[j]) + er;
+        ar = er;
+        er = dr;
+        dr = ripemd160_rotl(cr, 10);
+        cr = br;
+        br = t;
+    }
+
+    dword t = state[1] + cl + dr;
+    state[1] = state[2] + dl + er;
+    state[2] = state[3] + el + ar;
+    state[3] = state[4] + al + br;
+    state[4] = state[0] + bl + cr;
+    state[0] = t;
+}
+
+static inline void ripemd160_store_digest(const dword state[5], byte *hash) {
+#pragma unroll
+    for (dword i = 0; i < 5; ++i) {
+        hash[4 * i] = state[i];
+        hash[4 * i + 1] = state[i] >> 8;
+        hash[4 * i + 2] = state[i] >> 16;
+        hash[4 * i + 3] = state[i] >> 24;
+    }
+}
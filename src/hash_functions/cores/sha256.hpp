@@ -0,0 +1,209 @@
+/**
+ * SHA-256 compression and streaming functions shared by the kernels built on top of SHA-256 (sha256, sha256d, hash160).
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+#include <internal/fixed_length.hpp>
+
+#include <cstring>
+
+/**************************** DATA TYPES ****************************/
+struct sha256_ctx {
+    byte data[64];
+    qword bitlen = 0;
+    dword datalen = 0;
+    dword state[8]{};
+
+    sha256_ctx() {
+        state[0] = 0x6a09e667;
+        state[1] = 0xbb67ae85;
+        state[2] = 0x3c6ef372;
+        state[3] = 0xa54ff53a;
+        state[4] = 0x510e527f;
+        state[5] = 0x9b05688c;
+        state[6] = 0x1f83d9ab;
+        state[7] = 0x5be0cd19;
+    }
+};
+
+/****************************** MACROS ******************************/
+#ifndef ROTLEFT
+#define ROTLEFT(a, b) (((a) << (b)) | ((a) >> (32-(b))))
+#endif
+
+#define ROTRIGHT(a, b) (((a) >> (b)) | ((a) << (32-(b))))
+
+#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define EP0(x) (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
+#define EP1(x) (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
+#define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
+#define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
+
+/**************************** VARIABLES *****************************/
+static constexpr dword SHA256_CONSTS[64] =
+        {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+         0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+         0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+         0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+         0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+         0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+         0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+         0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+         0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+         0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+         0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+/**
+ * Compresses one block given as 16 big endian words.
+ * @param consts the round constants, in private, local or constant memory
+ */
+template<typename K>
+static void sha256_transform_words(dword state[8], const dword *words, const K &consts) {
+    dword a, b, c, d, e, f, g, h, t1, t2, m[64];
+
+#ifdef __NVPTX__
+#pragma unroll
+#endif
+    for (int i = 0; i < 16; ++i) {
+        m[i] = words[i];
+    }
+
+#ifdef __NVPTX__
+#pragma unroll
+#endif
+    for (int i = 16; i < 64; ++i) {
+        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
+    }
+
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
+    f = state[5];
+    g = state[6];
+    h = state[7];
+
+#ifdef __NVPTX__
+#pragma unroll
+#endif
+    for (int i = 0; i < 64; ++i) {
+        t1 = h + EP1(e) + CH(e, f, g) + consts[i] + m[i];
+        t2 = EP0(a) + MAJ(a, b, c);
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+template<typename K>
+static void sha256_transform(sha256_ctx *ctx, const byte *data, const K &consts) {
+    dword words[16];
+    hash::internal::md_load_block<true>(data, words);
+    sha256_transform_words(ctx->state, words, consts);
+}
+
+static inline void sha256_store_digest(const dword state[8], byte *hash) {
+    // Since this implementation uses little endian byte ordering and SHA uses big endian,
+    // reverse all the bytes when copying the final state to the output hash.
+#pragma unroll
+    for (dword i = 0; i < 4; ++i) {
+        hash[i] = (state[0] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 4] = (state[1] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 8] = (state[2] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 12] = (state[3] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 16] = (state[4] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 20] = (state[5] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 24] = (state[6] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 28] = (state[7] >> (24 - i * 8)) & 0x000000ff;
+    }
+}
+
+
+template<typename K>
+static void sha256_update(sha256_ctx *ctx, const byte *data, size_t len, const K &consts) {
+    size_t i = 0;
+    // Complete a partially filled buffer first.
+    if (ctx->datalen != 0) {
+        for (; i < len && ctx->datalen < 64; ++i) {
+            ctx->data[ctx->datalen++] = data[i];
+        }
+        if (ctx->datalen < 64) {
+            return;
+        }
+        sha256_transform(ctx, ctx->data, consts);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
+
+    // Full blocks are transformed straight from the input.
+    for (; i + 64 <= len; i += 64) {
+        sha256_transform(ctx, data + i, consts);
+        ctx->bitlen += 512;
+    }
+
+    // Only the tail is buffered.
+    for (; i < len; ++i) {
+        ctx->data[ctx->datalen++] = data[i];
+    }
+}
+
+/**
+ * Pads the message and transforms the last block(s), the digest is left in `ctx->state`.
+ */
+template<typename K>
+static void sha256_pad(sha256_ctx *ctx, const K &consts) {
+    dword i = ctx->datalen;
+    // Pad whatever data is left in the buffer.
+    if (ctx->datalen < 56) {
+        ctx->data[i++] = 0x80;
+        while (i < 56) {
+            ctx->data[i++] = 0x00;
+        }
+
+    } else {
+        ctx->data[i++] = 0x80;
+        while (i < 64) {
+            ctx->data[i++] = 0x00;
+        }
+        sha256_transform(ctx, ctx->data, consts);
+        std::memset(ctx->data, 0, 56);
+    }
+
+    // Append to the padding the total message's length in bits and transform.
+    ctx->bitlen += ctx->datalen * 8;
+    ctx->data[63] = ctx->bitlen;
+    ctx->data[62] = ctx->bitlen >> 8;
+    ctx->data[61] = ctx->bitlen >> 16;
+    ctx->data[60] = ctx->bitlen >> 24;
+    ctx->data[59] = ctx->bitlen >> 32;
+    ctx->data[58] = ctx->bitlen >> 40;
+    ctx->data[57] = ctx->bitlen >> 48;
+    ctx->data[56] = ctx->bitlen >> 56;
+    sha256_transform(ctx, ctx->data, consts);
+}
+
+template<typename K>
+static void sha256_final(sha256_ctx *ctx, byte *hash, const K &consts) {
+    sha256_pad(ctx, consts);
+    sha256_store_digest(ctx->state, hash);
+}
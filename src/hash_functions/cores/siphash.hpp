@@ -0,0 +1,127 @@
+/**
+ * SipHash-2-4 and HalfSipHash-2-4, following the reference implementation https://github.com/veorq/SipHash
+ * Both output their smallest digest: 64 bits for SipHash, 32 bits for HalfSipHash.
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+
+#include <cstring>
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+static inline qword siphash_rotl(qword x, dword b) {
+    return (x << b) | (x >> (64 - b));
+}
+
+static inline dword halfsiphash_rotl(dword x, dword b) {
+    return (x << b) | (x >> (32 - b));
+}
+
+static inline void siphash_round(qword &v0, qword &v1, qword &v2, qword &v3) {
+    v0 += v1;
+    v1 = siphash_rotl(v1, 13);
+    v1 ^= v0;
+    v0 = siphash_rotl(v0, 32);
+    v2 += v3;
+    v3 = siphash_rotl(v3, 16);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = siphash_rotl(v3, 21);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = siphash_rotl(v1, 17);
+    v1 ^= v2;
+    v2 = siphash_rotl(v2, 32);
+}
+
+static inline void halfsiphash_round(dword &v0, dword &v1, dword &v2, dword &v3) {
+    v0 += v1;
+    v1 = halfsiphash_rotl(v1, 5);
+    v1 ^= v0;
+    v0 = halfsiphash_rotl(v0, 16);
+    v2 += v3;
+    v3 = halfsiphash_rotl(v3, 8);
+    v3 ^= v2;
+    v0 += v3;
+    v3 = halfsiphash_rotl(v3, 7);
+    v3 ^= v0;
+    v2 += v1;
+    v1 = halfsiphash_rotl(v1, 13);
+    v1 ^= v2;
+    v2 = halfsiphash_rotl(v2, 16);
+}
+
+/**
+ * @param k0 k1 the 128-bit key as two little endian words
+ */
+static inline qword siphash24(const byte *input, qword len, qword k0, qword k1) {
+    qword v0 = k0 ^ 0x736f6d6570736575;
+    qword v1 = k1 ^ 0x646f72616e646f6d;
+    qword v2 = k0 ^ 0x6c7967656e657261;
+    qword v3 = k1 ^ 0x7465646279746573;
+
+    const qword n_words = len / 8;
+    for (qword i = 0; i < n_words; ++i) {
+        qword m;
+        memcpy(&m, input + 8 * i, sizeof(qword));
+        v3 ^= m;
+        siphash_round(v0, v1, v2, v3);
+        siphash_round(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    qword b = len << 56;
+    const byte *tail = input + 8 * n_words;
+    for (dword i = 0; i < (len & 7); ++i) {
+        b |= (qword) tail[i] << (8 * i);
+    }
+    v3 ^= b;
+    siphash_round(v0, v1, v2, v3);
+    siphash_round(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xff;
+#pragma unroll
+    for (dword i = 0; i < 4; ++i) {
+        siphash_round(v0, v1, v2, v3);
+    }
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
+/**
+ * @param k0 k1 the 64-bit key as two little endian words
+ */
+static inline dword halfsiphash24(const byte *input, qword len, dword k0, dword k1) {
+    dword v0 = k0;
+    dword v1 = k1;
+    dword v2 = k0 ^ 0x6c796765;
+    dword v3 = k1 ^ 0x74656462;
+
+    const qword n_words = len / 4;
+    for (qword i = 0; i < n_words; ++i) {
+        dword m;
+        memcpy(&m, input + 4 * i, sizeof(dword));
+        v3 ^= m;
+        halfsiphash_round(v0, v1, v2, v3);
+        halfsiphash_round(v0, v1, v2, v3);
+        v0 ^= m;
+    }
+
+    dword b = (dword) len << 24;
+    const byte *tail = input + 4 * n_words;
+    for (dword i = 0; i < (len & 3); ++i) {
+        b |= (dword) tail[i] << (8 * i);
+    }
+    v3 ^= b;
+    halfsiphash_round(v0, v1, v2, v3);
+    halfsiphash_round(v0, v1, v2, v3);
+    v0 ^= b;
+
+    v2 ^= 0xff;
+#pragma unroll
+    for (dword i = 0; i < 4; ++i) {
+        halfsiphash_round(v0, v1, v2, v3);
+    }
+    return v1 ^ v3;
+}
@@ -0,0 +1,313 @@
+/**
+ * XXH64 and XXH3 (64-bit) one-shot functions, following the reference implementation https://github.com/Cyan4973/xxHash
+ * They are used by the xxhash64 and xxh3 kernels and by the kernels that need a fast 64-bit hash of their items.
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+
+#include <cstring>
+
+/**************************** VARIABLES *****************************/
+constexpr dword XXH_PRIME32_1 = 0x9e3779b1;
+constexpr dword XXH_PRIME32_2 = 0x85ebca77;
+constexpr dword XXH_PRIME32_3 = 0xc2b2ae3d;
+
+constexpr qword XXH_PRIME64_1 = 0x9e3779b185ebca87;
+constexpr qword XXH_PRIME64_2 = 0xc2b2ae3d27d4eb4f;
+constexpr qword XXH_PRIME64_3 = 0x165667b19e3779f9;
+constexpr qword XXH_PRIME64_4 = 0x85ebca77c2b2ae63;
+constexpr qword XXH_PRIME64_5 = 0x27d4eb2f165667c5;
+
+constexpr qword XXH3_PRIME_MX1 = 0x165667919e3779f9;
+constexpr qword XXH3_PRIME_MX2 = 0x9fb21c651e98df25;
+
+constexpr dword XXH3_SECRET_SIZE = 192;
+constexpr dword XXH3_STRIPE_LEN = 64;
+constexpr dword XXH3_SECRET_CONSUME_RATE = 8;
+constexpr dword XXH3_STRIPES_PER_BLOCK = (XXH3_SECRET_SIZE - XXH3_STRIPE_LEN) / XXH3_SECRET_CONSUME_RATE;
+constexpr dword XXH3_BLOCK_LEN = XXH3_STRIPE_LEN * XXH3_STRIPES_PER_BLOCK;
+
+static constexpr byte XXH3_SECRET[XXH3_SECRET_SIZE] =
+        {0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+         0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+         0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+         0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+         0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+         0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+         0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+         0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+         0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+         0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+         0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+         0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e};
+
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+static inline qword xxh_read64(const byte *p) {
+    qword v;
+    memcpy(&v, p, sizeof(qword));
+    return v;
+}
+
+static inline dword xxh_read32(const byte *p) {
+    dword v;
+    memcpy(&v, p, sizeof(dword));
+    return v;
+}
+
+static inline qword xxh_rotl64(qword x, dword r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline dword xxh_swap32(dword x) {
+    return (x >> 24) | ((x >> 8) & 0x0000ff00) | ((x << 8) & 0x00ff0000) | (x << 24);
+}
+
+static inline qword xxh_swap64(qword x) {
+    return ((qword) xxh_swap32((dword) x) << 32) | xxh_swap32((dword) (x >> 32));
+}
+
+/**
+ * Low and high halves of the 128-bit product, xored.
+ */
+static inline qword xxh_mul128_fold64(qword lhs, qword rhs) {
+    return (lhs * rhs) ^ sycl::mul_hi(lhs, rhs);
+}
+
+/**
+ * Writes a 64-bit hash in the canonical (big endian) representation.
+ */
+static inline void xxh_store_canonical(qword h, byte *out) {
+#pragma unroll
+    for (dword i = 0; i < 8; ++i) {
+        out[i] = (byte) (h >> (56 - 8 * i));
+    }
+}
+
+/******************************* XXH64 ******************************/
+static inline qword xxh64_round(qword acc, qword input) {
+    acc += input * XXH_PRIME64_2;
+    acc = xxh_rotl64(acc, 31);
+    return acc * XXH_PRIME64_1;
+}
+
+static inline qword xxh64_merge_round(qword acc, qword val) {
+    acc ^= xxh64_round(0, val);
+    return acc * XXH_PRIME64_1 + XXH_PRIME64_4;
+}
+
+static inline qword xxh64_avalanche(qword h) {
+    h ^= h >> 33;
+    h *= XXH_PRIME64_2;
+    h ^= h >> 29;
+    h *= XXH_PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline qword xxh64(const byte *input, qword len, qword seed) {
+    const byte *p = input;
+    const byte *const end = input + len;
+    qword h;
+
+    if (len >= 32) {
+        qword v1 = seed + XXH_PRIME64_1 + XXH_PRIME64_2;
+        qword v2 = seed + XXH_PRIME64_2;
+        qword v3 = seed;
+        qword v4 = seed - XXH_PRIME64_1;
+        const byte *const limit = end - 32;
+        do {
+            v1 = xxh64_round(v1, xxh_read64(p));
+            v2 = xxh64_round(v2, xxh_read64(p + 8));
+            v3 = xxh64_round(v3, xxh_read64(p + 16));
+            v4 = xxh64_round(v4, xxh_read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = xxh_rotl64(v1, 1) + xxh_rotl64(v2, 7) + xxh_rotl64(v3, 12) + xxh_rotl64(v4, 18);
+        h = xxh64_merge_round(h, v1);
+        h = xxh64_merge_round(h, v2);
+        h = xxh64_merge_round(h, v3);
+        h = xxh64_merge_round(h, v4);
+    } else {
+        h = seed + XXH_PRIME64_5;
+    }
+
+    h += len;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh64_round(0, xxh_read64(p));
+        h = xxh_rotl64(h, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+    if (p + 4 <= end) {
+        h ^= (qword) xxh_read32(p) * XXH_PRIME64_1;
+        h = xxh_rotl64(h, 23) * XXH_PRIME64_2 + XXH_PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * XXH_PRIME64_5;
+        h = xxh_rotl64(h, 11) * XXH_PRIME64_1;
+    }
+    return xxh64_avalanche(h);
+}
+
+/******************************* XXH3 *******************************/
+static inline qword xxh3_avalanche(qword h) {
+    h ^= h >> 37;
+    h *= XXH3_PRIME_MX1;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline qword xxh3_rrmxmx(qword h, qword len) {
+    h ^= xxh_rotl64(h, 49) ^ xxh_rotl64(h, 24);
+    h *= XXH3_PRIME_MX2;
+    h ^= (h >> 35) + len;
+    h *= XXH3_PRIME_MX2;
+    return h ^ (h >> 28);
+}
+
+static inline qword xxh3_mix16B(const byte *input, const byte *secret, qword seed) {
+    return xxh_mul128_fold64(xxh_read64(input) ^ (xxh_read64(secret) + seed), xxh_read64(input + 8) ^ (xxh_read64(secret + 8) - seed));
+}
+
+static inline qword xxh3_len_0to16(const byte *input, qword len, qword seed) {
+    const byte *secret = XXH3_SECRET;
+    if (len > 8) {
+        qword bitflip1 = (xxh_read64(secret + 24) ^ xxh_read64(secret + 32)) + seed;
+        qword bitflip2 = (xxh_read64(secret + 40) ^ xxh_read64(secret + 48)) - seed;
+        qword input_lo = xxh_read64(input) ^ bitflip1;
+        qword input_hi = xxh_read64(input + len - 8) ^ bitflip2;
+        qword acc = len + xxh_swap64(input_lo) + input_hi + xxh_mul128_fold64(input_lo, input_hi);
+        return xxh3_avalanche(acc);
+    } else if (len >= 4) {
+        seed ^= (qword) xxh_swap32((dword) seed) << 32;
+        qword input1 = xxh_read32(input);
+        qword input2 = xxh_read32(input + len - 4);
+        qword bitflip = (xxh_read64(secret + 8) ^ xxh_read64(secret + 16)) - seed;
+        qword keyed = (input2 + (input1 << 32)) ^ bitflip;
+        return xxh3_rrmxmx(keyed, len);
+    } else if (len > 0) {
+        dword combined = ((dword) input[0] << 16) | ((dword) input[len >> 1] << 24) | (dword) input[len - 1] | ((dword) len << 8);
+        qword bitflip = (xxh_read32(secret) ^ xxh_read32(secret + 4)) + seed;
+        return xxh64_avalanche((qword) combined ^ bitflip);
+    } else {
+        return xxh64_avalanche(seed ^ (xxh_read64(secret + 56) ^ xxh_read64(secret + 64)));
+    }
+}
+
+static inline qword xxh3_len_17to128(const byte *input, qword len, qword seed) {
+    const byte *secret = XXH3_SECRET;
+    qword acc = len * XXH_PRIME64_1;
+    if (len > 32) {
+        if (len > 64) {
+            if (len > 96) {
+                acc += xxh3_mix16B(input + 48, secret + 96, seed);
+                acc += xxh3_mix16B(input + len - 64, secret + 112, seed);
+            }
+            acc += xxh3_mix16B(input + 32, secret + 64, seed);
+            acc += xxh3_mix16B(input + len - 48, secret + 80, seed);
+        }
+        acc += xxh3_mix16B(input + 16, secret + 32, seed);
+        acc += xxh3_mix16B(input + len - 32, secret + 48, seed);
+    }
+    acc += xxh3_mix16B(input, secret, seed);
+    acc += xxh3_mix16B(input + len - 16, secret + 16, seed);
+    return xxh3_avalanche(acc);
+}
+
+static inline qword xxh3_len_129to240(const byte *input, qword len, qword seed) {
+    constexpr dword midsize_start_offset = 3;
+    constexpr dword midsize_last_offset = 17;
+    constexpr dword secret_size_min = 136;
+    const byte *secret = XXH3_SECRET;
+    qword acc = len * XXH_PRIME64_1;
+    const dword n_rounds = (dword) len / 16;
+#pragma unroll
+    for (dword i = 0; i < 8; ++i) {
+        acc += xxh3_mix16B(input + 16 * i, secret + 16 * i, seed);
+    }
+    acc = xxh3_avalanche(acc);
+    for (dword i = 8; i < n_rounds; ++i) {
+        acc += xxh3_mix16B(input + 16 * i, secret + 16 * (i - 8) + midsize_start_offset, seed);
+    }
+    acc += xxh3_mix16B(input + len - 16, secret + secret_size_min - midsize_last_offset, seed);
+    return xxh3_avalanche(acc);
+}
+
+static inline void xxh3_accumulate_512(qword acc[8], const byte *input, const byte *secret) {
+#pragma unroll
+    for (dword i = 0; i < 8; ++i) {
+        qword data_val = xxh_read64(input + 8 * i);
+        qword data_key = data_val ^ xxh_read64(secret + 8 * i);
+        acc[i ^ 1] += data_val;
+        acc[i] += (data_key & 0xffffffff) * (data_key >> 32);
+    }
+}
+
+static inline void xxh3_scramble(qword acc[8], const byte *secret) {
+#pragma unroll
+    for (dword i = 0; i < 8; ++i) {
+        qword a = acc[i];
+        a ^= a >> 47;
+        a ^= xxh_read64(secret + 8 * i);
+        acc[i] = a * XXH_PRIME32_1;
+    }
+}
+
+/**
+ * Inputs longer than 240 bytes: 8 accumulators consume the input by stripes of 64 bytes.
+ * A non zero seed derives a custom secret, kept in private memory.
+ */
+static inline qword xxh3_hash_long(const byte *input, qword len, qword seed) {
+    byte custom_secret[XXH3_SECRET_SIZE];
+    const byte *secret = XXH3_SECRET;
+    if (seed != 0) {
+        for (dword i = 0; i < XXH3_SECRET_SIZE; i += 16) {
+            qword lo = xxh_read64(XXH3_SECRET + i) + seed;
+            qword hi = xxh_read64(XXH3_SECRET + i + 8) - seed;
+            memcpy(custom_secret + i, &lo, sizeof(qword));
+            memcpy(custom_secret + i + 8, &hi, sizeof(qword));
+        }
+        secret = custom_secret;
+    }
+
+    qword acc[8] = {XXH_PRIME32_3, XXH_PRIME64_1, XXH_PRIME64_2, XXH_PRIME64_3, XXH_PRIME64_4, XXH_PRIME32_2, XXH_PRIME64_5, XXH_PRIME32_1};
+    const qword n_blocks = (len - 1) / XXH3_BLOCK_LEN;
+    for (qword n = 0; n < n_blocks; ++n) {
+        for (dword s = 0; s < XXH3_STRIPES_PER_BLOCK; ++s) {
+            xxh3_accumulate_512(acc, input + n * XXH3_BLOCK_LEN + s * XXH3_STRIPE_LEN, secret + s * XXH3_SECRET_CONSUME_RATE);
+        }
+        xxh3_scramble(acc, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN);
+    }
+
+    const qword n_stripes = ((len - 1) - n_blocks * XXH3_BLOCK_LEN) / XXH3_STRIPE_LEN;
+    for (qword s = 0; s < n_stripes; ++s) {
+        xxh3_accumulate_512(acc, input + n_blocks * XXH3_BLOCK_LEN + s * XXH3_STRIPE_LEN, secret + s * XXH3_SECRET_CONSUME_RATE);
+    }
+    constexpr dword secret_lastacc_start = 7;
+    xxh3_accumulate_512(acc, input + len - XXH3_STRIPE_LEN, secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - secret_lastacc_start);
+
+    constexpr dword secret_mergeaccs_start = 11;
+    qword result = len * XXH_PRIME64_1;
+#pragma unroll
+    for (dword i = 0; i < 4; ++i) {
+        const byte *s = secret + secret_mergeaccs_start + 16 * i;
+        result += xxh_mul128_fold64(acc[2 * i] ^ xxh_read64(s), acc[2 * i + 1] ^ xxh_read64(s + 8));
+    }
+    return xxh3_avalanche(result);
+}
+
+static inline qword xxh3_64(const byte *input, qword len, qword seed) {
+    if (len <= 16) {
+        return xxh3_len_0to16(input, len, seed);
+    } else if (len <= 128) {
+        return xxh3_len_17to128(input, len, seed);
+    } else if (len <= 240) {
+        return xxh3_len_129to240(input, len, seed);
+    } else {
+        return xxh3_hash_long(input, len, seed);
+    }
+}
@@ -0,0 +1,50 @@
+#include <hash_functions/crc64nvme.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "cores/crc.hpp"
+
+using namespace usm_smart_ptr;
+
+static inline void kernel_crc64nvme_sliced(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    qword crc = crc_update_sliced<qword>(0xffffffffffffffff, in, inlen, CRC64NVME_TABLES);
+    byte out[CRC64NVME_BLOCK_SIZE];
+    crc_store<qword>(~crc, out);
+    outdata.store(out, CRC64NVME_BLOCK_SIZE, thread, n_batch);
+}
+
+template<typename Table>
+static inline void kernel_crc64nvme_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, const Table &table) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    qword crc = crc_update_bytewise<qword>(0xffffffffffffffff, in, inlen, table);
+    byte out[CRC64NVME_BLOCK_SIZE];
+    crc_store<qword>(~crc, out);
+    outdata.store(out, CRC64NVME_BLOCK_SIZE, thread, n_batch);
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_crc64nvme_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement) {
+        if (placement == table_placement::automatic && q.get_device().is_cpu()) {
+            auto config = get_kernel_sizes(q, n_batch);
+            return q.submit([&](sycl::handler &cgh) {
+                cgh.depends_on(e);
+                cgh.parallel_for<crc64nvme_sliced_kernel>(
+                        sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                        [=](sycl::nd_item<1> item) {
+                            kernel_crc64nvme_sliced(indata, inlen, outdata, n_batch, item.get_global_linear_id());
+                        });
+            });
+        }
+        return launch_with_table<crc64nvme_kernel, CRC64NVME_TABLE>(q, std::move(e), placement, n_batch, [=](dword thread, const auto &table) {
+            kernel_crc64nvme_hash(indata, inlen, outdata, n_batch, thread, table);
+        });
+    }
+
+}
@@ -0,0 +1,49 @@
+#include <hash_functions/halfsiphash.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "cores/siphash.hpp"
+
+#include <stdexcept>
+
+using namespace usm_smart_ptr;
+
+static inline void kernel_halfsiphash_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, dword k0, dword k1, dword n_buckets) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    dword h = halfsiphash24(in, inlen, k0, k1);
+    if (n_buckets) {
+        dword bucket = (dword) (h % n_buckets);
+        memcpy(outdata.base() + thread * sizeof(dword), &bucket, sizeof(dword));
+    } else {
+        byte out[HALFSIPHASH_BLOCK_SIZE];
+        memcpy(out, &h, HALFSIPHASH_BLOCK_SIZE);
+        outdata.store(out, HALFSIPHASH_BLOCK_SIZE, thread, n_batch);
+    }
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_halfsiphash_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, const byte *key, dword keylen,
+                         dword n_buckets) {
+        if (!key || keylen != HALFSIPHASH_KEY_SIZE) {
+            throw std::invalid_argument("halfsiphash: the key must be HALFSIPHASH_KEY_SIZE bytes");
+        }
+        dword k0 = 0, k1 = 0;
+        for (dword i = 0; i < sizeof(dword); ++i) {
+            k0 |= (dword) key[i] << (8 * i);
+            k1 |= (dword) key[sizeof(dword) + i] << (8 * i);
+        }
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<class halfsiphash_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        kernel_halfsiphash_hash(indata, inlen, outdata, n_batch, item.get_global_linear_id(), k0, k1, n_buckets);
+                    });
+        });
+    }
+
+}
@@ -0,0 +1,42 @@
+#include <hash_functions/hash160.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include <tools/intrinsics.hpp>
+#include "cores/sha256.hpp"
+#include "cores/ripemd160.hpp"
+
+using namespace usm_smart_ptr;
+
+/**
+ * RIPEMD-160 reads little endian words: the words of the SHA-256 digest are the byte swapped state words.
+ * The 32 bytes message fits in one block with a constant padding (0x80 then 256 bits of length).
+ */
+template<typename K>
+static inline void kernel_hash160_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, const K &consts) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    byte out[HASH160_BLOCK_SIZE];
+    sha256_ctx ctx{};
+    sha256_update(&ctx, in, inlen, consts);
+    sha256_pad(&ctx, consts);
+
+    const dword words[16] = {sbb::byte_swap(ctx.state[0]), sbb::byte_swap(ctx.state[1]), sbb::byte_swap(ctx.state[2]), sbb::byte_swap(ctx.state[3]),
+                             sbb::byte_swap(ctx.state[4]), sbb::byte_swap(ctx.state[5]), sbb::byte_swap(ctx.state[6]), sbb::byte_swap(ctx.state[7]),
+                             0x80, 0, 0, 0, 0, 0, 256, 0};
+    dword state[5] = {RIPEMD160_IV[0], RIPEMD160_IV[1], RIPEMD160_IV[2], RIPEMD160_IV[3], RIPEMD160_IV[4]};
+    ripemd160_transform_words(state, words);
+    ripemd160_store_digest(state, out);
+    outdata.store(out, HASH160_BLOCK_SIZE, thread, n_batch);
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_hash160_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement) {
+        return launch_with_table<hash160_kernel, SHA256_CONSTS>(q, std::move(e), placement, n_batch, [=](dword thread, const auto &consts) {
+            kernel_hash160_hash(indata, inlen, outdata, n_batch, thread, consts);
+        });
+    }
+
+}
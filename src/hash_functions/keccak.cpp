@@ -3,10 +3,11 @@
 
 using namespace usm_smart_ptr;
 
+/**
+ * Only the state is kept: the input is absorbed from global memory and the digest is squeezed straight to the output.
+ */
 struct keccak_ctx_t {
-    qword bits_in_queue = 0;
     qword state[KECCAK_STATE_SIZE]{};
-    byte q[KECCAK_Q_SIZE]{};
 };
 
 static inline qword keccak_leuint64(const void *in) {
@@ -15,17 +16,6 @@ static inline qword keccak_leuint64(const void *in) {
     return a;
 }
 
-
-template<qword rate_bits>
-static inline void keccak_extract(keccak_ctx_t *ctx) {
-    constexpr qword len = rate_bits >> 6;
-#pragma unroll len
-    for (qword i = 0; i < len; i++) {
-        qword a = ctx->state[i];
-        memcpy(ctx->q + (i * sizeof(qword)), &a, sizeof(qword));
-    }
-}
-
 static inline qword keccak_ROTL64(qword a, qword b) {
     return (a << b) | (a >> (64 - b));
 }
@@ -170,118 +160,76 @@ static inline void keccak_absorb(keccak_ctx_t *ctx, const byte *in) {
     keccak_permutations(ctx);
 }
 
+/**
+ * Absorbs all the full blocks of the input.
+ * @return the number of bytes absorbed
+ */
 template<qword digest_bit_len>
-static inline void keccak_pad(keccak_ctx_t *ctx) {
-    constexpr dword rate_bits = 1600 - ((digest_bit_len) << 1);
-    constexpr dword absorb_round = rate_bits >> 6;
-
-    ctx->q[ctx->bits_in_queue >> 3] |= (1L << (ctx->bits_in_queue & 7));
-
-    if (++(ctx->bits_in_queue) == rate_bits) {
-        keccak_absorb<absorb_round>(ctx, ctx->q);
-        ctx->bits_in_queue = 0;
-    }
-
-    {
-        qword full = ctx->bits_in_queue >> 6;
-        qword partial = ctx->bits_in_queue & 63;
-
-        qword offset = 0;
-        for (dword i = 0; i < full; ++i) {
-            ctx->state[i] ^= keccak_leuint64(ctx->q + offset);
-            offset += 8;
-        }
-
-        if (partial > 0) {
-            qword mask = (1L << partial) - 1;
-            ctx->state[full] ^= keccak_leuint64(ctx->q + offset) & mask;
-        }
-    }
-
-    ctx->state[(rate_bits - 1) >> 6] ^= 9223372036854775808ULL;/* 1 << 63 */
-    keccak_permutations(ctx);
-    keccak_extract<rate_bits>(ctx);
-    ctx->bits_in_queue = rate_bits;
-}
-
-template<qword digest_bit_len>
-static inline void keccak_update(keccak_ctx_t *ctx, const byte *in, qword inlen) {
+static inline qword keccak_update(keccak_ctx_t *ctx, const byte *in, qword inlen) {
     constexpr dword rate_bits = 1600 - ((digest_bit_len) << 1);
     constexpr dword absorb_round = rate_bits >> 6;
     constexpr qword rate_BYTEs = rate_bits >> 3;
 
-
-    qword BYTEs = ctx->bits_in_queue >> 3;
-    int64_t count = 0;
-    while (count < (int64_t) inlen) {
-        if (BYTEs == 0 && count <= ((int64_t) (inlen - rate_BYTEs))) {
-            do {
-                keccak_absorb<absorb_round>(ctx, in + count);
-                count += rate_BYTEs;
-            } while (count <= ((int64_t) (inlen - rate_BYTEs)));
-        } else {
-            qword partial = sycl::min(rate_BYTEs - BYTEs, inlen - (qword) count);
-            memcpy(ctx->q + BYTEs, in + count, partial);
-
-            BYTEs += partial;
-            count += (int64_t) partial;
-
-            if (BYTEs == rate_BYTEs) {
-                keccak_absorb<absorb_round>(ctx, ctx->q);
-                BYTEs = 0;
-            }
-        }
+    qword count = 0;
+    for (; count + rate_BYTEs <= inlen; count += rate_BYTEs) {
+        keccak_absorb<absorb_round>(ctx, in + count);
     }
-    ctx->bits_in_queue = BYTEs << 3;
+    return count;
 }
 
+/**
+ * XORs the tail of the message (less than a block) and the padding into the state lanes, runs the last permutation
+ * and squeezes the digest. The digest is always shorter than the rate, so a single squeeze is enough.
+ * Keccak pads with 0x01 and SHA-3 with 0x06 (domain bits 01 then 1), both end the block with 0x80.
+ */
 template<qword digest_bit_len>
-static inline void keccak_final(bool is_sha3, keccak_ctx_t *ctx, byte *out) {
+static inline void keccak_final(bool is_sha3, keccak_ctx_t *ctx, const byte *tail, qword tail_len, byte *out) {
     constexpr dword rate_bits = 1600 - ((digest_bit_len) << 1);
     constexpr dword absorb_round = rate_bits >> 6;
-    constexpr qword rate_BYTEs = rate_bits >> 3;
+    constexpr dword digest_BYTEs = digest_bit_len >> 3;
 
-
-    if (is_sha3) {
-        int mask = (1 << 2) - 1;
-        ctx->q[ctx->bits_in_queue >> 3] = (byte) (0x02 & mask);
-        ctx->bits_in_queue += 2;
+    const qword full = tail_len >> 3;
+    for (dword i = 0; i < full; ++i) {
+        ctx->state[i] ^= keccak_leuint64(tail + (i << 3));
     }
 
-    keccak_pad<digest_bit_len>(ctx);
-    qword i = 0;
-
-    while (i < digest_bit_len) {
-        if (ctx->bits_in_queue == 0) {
-            keccak_permutations(ctx);
-            keccak_extract<rate_bits>(ctx);
-            ctx->bits_in_queue = rate_bits;
-        }
+    qword last = 0;
+    for (qword i = full << 3; i < tail_len; ++i) {
+        last |= (qword) tail[i] << ((i & 7) << 3);
+    }
+    last |= (qword) (is_sha3 ? 0x06 : 0x01) << ((tail_len & 7) << 3);
+    ctx->state[full] ^= last;
+    ctx->state[absorb_round - 1] ^= 9223372036854775808ULL;/* 1 << 63 */
+    keccak_permutations(ctx);
 
-        qword partial_block = sycl::min(ctx->bits_in_queue, digest_bit_len - i);
-        memcpy(out + (i >> 3), ctx->q + (rate_BYTEs - (ctx->bits_in_queue >> 3)), partial_block >> 3);
-        ctx->bits_in_queue -= partial_block;
-        i += partial_block;
+#pragma unroll
+    for (dword i = 0; i < (digest_BYTEs >> 3); ++i) {
+        memcpy(out + (i << 3), ctx->state + i, sizeof(qword));
+    }
+#pragma unroll
+    for (dword i = digest_BYTEs & ~7u; i < digest_BYTEs; ++i) {
+        out[i] = (byte) (ctx->state[i >> 3] >> ((i & 7) << 3));
     }
 }
 
 template<qword digest_bit_len>
-static inline void kernel_keccak_hash(bool is_sha3, const byte *indata, dword inlen, byte *outdata, dword n_batch, dword thread) {
+static inline void kernel_keccak_hash(bool is_sha3, const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread) {
     if (thread >= n_batch) {
         return;
     }
-    const byte *in = indata + thread * inlen;
-    byte *out = outdata + thread * (digest_bit_len >> 3);
+    const byte *in = indata.record(thread, inlen);
+    byte out[digest_bit_len >> 3];
     keccak_ctx_t ctx{};
-    keccak_update<digest_bit_len>(&ctx, in, inlen);
-    keccak_final<digest_bit_len>(is_sha3, &ctx, out);
+    qword absorbed = keccak_update<digest_bit_len>(&ctx, in, inlen);
+    keccak_final<digest_bit_len>(is_sha3, &ctx, in + absorbed, inlen - absorbed, out);
+    outdata.store(out, digest_bit_len >> 3, thread, n_batch);
 }
 
 namespace hash::internal {
 
     template<dword n_outbit_>
     sycl::event
-    launch_keccak_kernel_template(bool is_sha3, sycl::queue &item, sycl::event e, const device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch) {
+    launch_keccak_kernel_template(bool is_sha3, sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch) {
         auto config = get_kernel_sizes(item, n_batch);
         return item.submit([&](sycl::handler &cgh) {
             cgh.depends_on(std::move(e));
@@ -294,7 +242,7 @@ namespace hash::internal {
     }
 
     sycl::event
-    launch_keccak_kernel(bool is_sha3, sycl::queue &item, sycl::event e, const device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch, dword n_outbit) {
+    launch_keccak_kernel(bool is_sha3, sycl::queue &item, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, dword n_outbit) {
         if (n_outbit == 128) {
             return launch_keccak_kernel_template<128>(is_sha3, item, std::move(e), indata, outdata, inlen, n_batch);
         } else if (n_outbit == 224) {
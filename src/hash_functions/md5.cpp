@@ -1,5 +1,6 @@
 #include <hash_functions/md5.hpp>
 #include <internal/determine_kernel_config.hpp>
+#include <internal/fixed_length.hpp>
 
 #include <cstring>
 
@@ -33,24 +34,16 @@ struct md5_ctx {
                             (a) = (b) + ROTLEFT(a,s); }
 
 /*********************** FUNCTION DEFINITIONS ***********************/
-static inline void md5_transform(md5_ctx *ctx, const byte *data) {
-    dword a, b, c, d, m[16];
-
-    // MD5 specifies big endian byte order, but this implementation assumes a little
-    // endian byte order CPU. Reverse all the bytes upon input, and re-reverse them
-    // on output (in md5_final()).
-#ifdef __NVPTX__
-#pragma unroll
-#endif
-    for (dword i = 0, j = 0; i < 16; ++i, j += 4) {
-        m[i] = (dword) ((data[j]) + (data[j + 1] << 8) + (data[j + 2] << 16) + (data[j + 3] << 24));
-        //m[i] = hash::upsample(data[j + 3], data[j + 2], data[j + 1], data[j]);
-    }
+/**
+ * Compresses one block given as 16 little endian words.
+ */
+static inline void md5_transform_words(dword state[4], const dword *m) {
+    dword a, b, c, d;
 
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
 
     FF(a, b, c, d, m[0], 7, 0xd76aa478)
     FF(d, a, b, c, m[1], 12, 0xe8c7b756)
@@ -120,22 +113,56 @@ static inline void md5_transform(md5_ctx *ctx, const byte *data) {
     II(c, d, a, b, m[2], 15, 0x2ad7d2bb)
     II(b, c, d, a, m[9], 21, 0xeb86d391)
 
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+static inline void md5_transform(md5_ctx *ctx, const byte *data) {
+    dword m[16];
+    // MD5 words are little endian, on the devices we target that's a plain load when the data is aligned.
+    hash::internal::md_load_block<false>(data, m);
+    md5_transform_words(ctx->state, m);
+}
+
+static inline void md5_store_digest(const dword state[4], byte *hash) {
+#ifdef __NVPTX__
+#pragma unroll
+#endif
+    for (dword i = 0; i < 4; ++i) {
+        hash[i] = (state[0] >> (i * 8)) & 0x000000ff;
+        hash[i + 4] = (state[1] >> (i * 8)) & 0x000000ff;
+        hash[i + 8] = (state[2] >> (i * 8)) & 0x000000ff;
+        hash[i + 12] = (state[3] >> (i * 8)) & 0x000000ff;
+    }
 }
 
 
 static inline void md5_update(md5_ctx *ctx, const byte *data, const size_t &len) {
-    for (size_t i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            md5_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
+    size_t i = 0;
+    // Complete a partially filled buffer first.
+    if (ctx->datalen != 0) {
+        for (; i < len && ctx->datalen < 64; ++i) {
+            ctx->data[ctx->datalen++] = data[i];
+        }
+        if (ctx->datalen < 64) {
+            return;
         }
+        md5_transform(ctx, ctx->data);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
+
+    // Full blocks are transformed straight from the input.
+    for (; i + 64 <= len; i += 64) {
+        md5_transform(ctx, data + i);
+        ctx->bitlen += 512;
+    }
+
+    // Only the tail is buffered.
+    for (; i < len; ++i) {
+        ctx->data[ctx->datalen++] = data[i];
     }
 }
 
@@ -166,35 +193,53 @@ static inline void md5_final(md5_ctx *ctx, byte *hash) {
     ctx->data[62] = ctx->bitlen >> 48;
     ctx->data[63] = ctx->bitlen >> 56;
     md5_transform(ctx, ctx->data);
-
-    // Since this implementation uses little endian byte ordering and MD uses big endian,
-    // reverse all the bytes when copying the final state to the output hash.
-
-#ifdef __NVPTX__
-#pragma unroll
-#endif
-    for (i = 0; i < 4; ++i) {
-        hash[i] = (ctx->state[0] >> (i * 8)) & 0x000000ff;
-        hash[i + 4] = (ctx->state[1] >> (i * 8)) & 0x000000ff;
-        hash[i + 8] = (ctx->state[2] >> (i * 8)) & 0x000000ff;
-        hash[i + 12] = (ctx->state[3] >> (i * 8)) & 0x000000ff;
-    }
+    md5_store_digest(ctx->state, hash);
 }
 
-static inline void kernel_md5_hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, dword thread) {
+static inline void kernel_md5_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread) {
     if (thread >= n_batch) {
         return;
     }
-    const byte *in = indata + thread * inlen;
-    byte *out = outdata + thread * MD5_BLOCK_SIZE;
+    const byte *in = indata.record(thread, inlen);
+    byte out[MD5_BLOCK_SIZE];
     md5_ctx ctx{};
     md5_update(&ctx, in, inlen);
     md5_final(&ctx, out);
+    outdata.store(out, MD5_BLOCK_SIZE, thread, n_batch);
+}
+
+/**
+ * Kernel for messages whose length is known at compile time. Full blocks are transformed from the input with a
+ * constant trip count, the padding of the tail is precomputed and its words are loaded straight into registers.
+ */
+template<dword inlen>
+static inline void kernel_md5_hash_fixed(const hash::record_input &indata, const hash::digest_output &outdata, dword n_batch, dword thread) {
+    using namespace hash::internal;
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    byte out[MD5_BLOCK_SIZE];
+    md5_ctx ctx{};
+    for (dword block = 0; block < md_full_blocks(inlen); ++block) {
+        dword words[MD_BLOCK_WORDS];
+        md_load_block<false>(in + block * MD_BLOCK_LENGTH, words);
+        md5_transform_words(ctx.state, words);
+    }
+
+    dword m[md_tail_blocks(inlen) * MD_BLOCK_WORDS];
+    md_load_padded_tail<inlen, false>(in, m);
+#pragma unroll
+    for (dword block = 0; block < md_tail_blocks(inlen); ++block) {
+        md5_transform_words(ctx.state, m + block * MD_BLOCK_WORDS);
+    }
+    md5_store_digest(ctx.state, out);
+    outdata.store(out, MD5_BLOCK_SIZE, thread, n_batch);
 }
 
 
 namespace hash::internal {
-    sycl::event launch_md5_kernel(sycl::queue &q, sycl::event e, const device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch) {
+    sycl::event launch_md5_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch) {
         auto config = get_kernel_sizes(q, n_batch);
         return q.submit([&](sycl::handler &cgh) {
             cgh.depends_on(e);
@@ -206,4 +251,19 @@ namespace hash::internal {
         });
     }
 
+    sycl::event launch_md5_fixed_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return fixed_input_lengths::visit(inlen, [&](auto len) {
+            constexpr dword inlen_ = decltype(len)::value;
+            return q.submit([&](sycl::handler &cgh) {
+                cgh.depends_on(e);
+                cgh.parallel_for<md5_fixed_kernel<inlen_>>(
+                        sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                        [=](sycl::nd_item<1> item) {
+                            kernel_md5_hash_fixed<inlen_>(indata, outdata, n_batch, item.get_global_linear_id());
+                        });
+            });
+        });
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include <hash_functions/murmur3.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "cores/murmur3.hpp"
+
+using namespace usm_smart_ptr;
+
+static inline void kernel_murmur3_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, qword seed) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    byte out[MURMUR3_BLOCK_SIZE];
+    qword h[2];
+    murmur3_x64_128(in, inlen, (dword) seed, h);
+    memcpy(out, h, MURMUR3_BLOCK_SIZE);
+    outdata.store(out, MURMUR3_BLOCK_SIZE, thread, n_batch);
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_murmur3_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, qword seed) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<class murmur3_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        kernel_murmur3_hash(indata, inlen, outdata, n_batch, item.get_global_linear_id(), seed);
+                    });
+        });
+    }
+
+}
@@ -1,6 +1,7 @@
 #include <hash_functions/sha1.hpp>
 #include <internal/determine_kernel_config.hpp>
 #include <internal/common.hpp>
+#include <internal/fixed_length.hpp>
 
 #include <cstring>
 
@@ -12,8 +13,6 @@ struct sha1_ctx {
     dword datalen = 0;
     qword bitlen = 0;
     dword state[5]{0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xc3d2e1f0};
-    dword k[4]{0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6};
-
 };
 
 /****************************** MACROS ******************************/
@@ -22,14 +21,18 @@ struct sha1_ctx {
 #endif
 
 /*********************** FUNCTION DEFINITIONS ***********************/
-void sha1_transform(sha1_ctx *ctx, const byte *data) {
+/**
+ * Compresses one block given as 16 big endian words.
+ */
+static inline void sha1_transform_words(dword state[5], const dword *words) {
+    constexpr dword k[4]{0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6};
     dword a, b, c, d, e, t, m[80];
 
 #ifdef __NVPTX__
 #pragma unroll
 #endif
-    for (int i = 0, j = 0; i < 16; ++i, j += 4) {
-        m[i] = hash::upsample(data[j], data[j + 1], data[j + 2], data[j + 3]);
+    for (int i = 0; i < 16; ++i) {
+        m[i] = words[i];
     }
 
 
@@ -41,17 +44,17 @@ void sha1_transform(sha1_ctx *ctx, const byte *data) {
         m[i] = (m[i] << 1) | (m[i] >> 31);
     }
 
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
-    e = ctx->state[4];
+    a = state[0];
+    b = state[1];
+    c = state[2];
+    d = state[3];
+    e = state[4];
 
 #ifdef __NVPTX__
 #pragma unroll
 #endif
     for (dword i = 0; i < 20; ++i) {
-        t = ROTLEFT(a, 5) + ((b & c) ^ (~b & d)) + e + ctx->k[0] + m[i];
+        t = ROTLEFT(a, 5) + ((b & c) ^ (~b & d)) + e + k[0] + m[i];
         e = d;
         d = c;
         c = ROTLEFT(b, 30);
@@ -62,7 +65,7 @@ void sha1_transform(sha1_ctx *ctx, const byte *data) {
 #pragma unroll
 #endif
     for (dword i = 20; i < 40; ++i) {
-        t = ROTLEFT(a, 5) + (b ^ c ^ d) + e + ctx->k[1] + m[i];
+        t = ROTLEFT(a, 5) + (b ^ c ^ d) + e + k[1] + m[i];
         e = d;
         d = c;
         c = ROTLEFT(b, 30);
@@ -74,7 +77,7 @@ void sha1_transform(sha1_ctx *ctx, const byte *data) {
 #pragma unroll
 #endif
     for (dword i = 40; i < 60; ++i) {
-        t = ROTLEFT(a, 5) + ((b & c) ^ (b & d) ^ (c & d)) + e + ctx->k[2] + m[i];
+        t = ROTLEFT(a, 5) + ((b & c) ^ (b & d) ^ (c & d)) + e + k[2] + m[i];
         e = d;
         d = c;
         c = ROTLEFT(b, 30);
@@ -86,7 +89,7 @@ void sha1_transform(sha1_ctx *ctx, const byte *data) {
 #pragma unroll
 #endif
     for (dword i = 60; i < 80; ++i) {
-        t = ROTLEFT(a, 5) + (b ^ c ^ d) + e + ctx->k[3] + m[i];
+        t = ROTLEFT(a, 5) + (b ^ c ^ d) + e + k[3] + m[i];
         e = d;
         d = c;
         c = ROTLEFT(b, 30);
@@ -94,22 +97,55 @@ void sha1_transform(sha1_ctx *ctx, const byte *data) {
         a = t;
     }
 
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
-    ctx->state[4] += e;
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void sha1_transform(sha1_ctx *ctx, const byte *data) {
+    dword words[16];
+    hash::internal::md_load_block<true>(data, words);
+    sha1_transform_words(ctx->state, words);
+}
+
+static inline void sha1_store_digest(const dword state[5], byte *hash) {
+    // Since this implementation uses little endian byte ordering and MD uses big endian,
+    // reverse all the bytes when copying the final state to the output hash.
+    for (dword i = 0; i < 4; ++i) {
+        hash[i] = (state[0] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 4] = (state[1] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 8] = (state[2] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 12] = (state[3] >> (24 - i * 8)) & 0x000000ff;
+        hash[i + 16] = (state[4] >> (24 - i * 8)) & 0x000000ff;
+    }
 }
 
 void sha1_update(sha1_ctx *ctx, const byte *data, size_t len) {
-    for (size_t i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha1_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
+    size_t i = 0;
+    // Complete a partially filled buffer first.
+    if (ctx->datalen != 0) {
+        for (; i < len && ctx->datalen < 64; ++i) {
+            ctx->data[ctx->datalen++] = data[i];
+        }
+        if (ctx->datalen < 64) {
+            return;
         }
+        sha1_transform(ctx, ctx->data);
+        ctx->bitlen += 512;
+        ctx->datalen = 0;
+    }
+
+    // Full blocks are transformed straight from the input.
+    for (; i + 64 <= len; i += 64) {
+        sha1_transform(ctx, data + i);
+        ctx->bitlen += 512;
+    }
+
+    // Only the tail is buffered.
+    for (; i < len; ++i) {
+        ctx->data[ctx->datalen++] = data[i];
     }
 }
 
@@ -140,32 +176,53 @@ void sha1_final(sha1_ctx *ctx, byte *hash) {
     ctx->data[57] = ctx->bitlen >> 48;
     ctx->data[56] = ctx->bitlen >> 56;
     sha1_transform(ctx, ctx->data);
-
-    // Since this implementation uses little endian byte ordering and MD uses big endian,
-    // reverse all the bytes when copying the final state to the output hash.
-    for (i = 0; i < 4; ++i) {
-        hash[i] = (ctx->state[0] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 4] = (ctx->state[1] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 8] = (ctx->state[2] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 12] = (ctx->state[3] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 16] = (ctx->state[4] >> (24 - i * 8)) & 0x000000ff;
-    }
+    sha1_store_digest(ctx->state, hash);
 }
 
-void kernel_sha1_hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, dword thread) {
+void kernel_sha1_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread) {
     if (thread >= n_batch) {
         return;
     }
-    const byte *in = indata + thread * inlen;
-    byte *out = outdata + thread * SHA1_BLOCK_SIZE;
+    const byte *in = indata.record(thread, inlen);
+    byte out[SHA1_BLOCK_SIZE];
     sha1_ctx ctx{};
     sha1_update(&ctx, in, inlen);
     sha1_final(&ctx, out);
+    outdata.store(out, SHA1_BLOCK_SIZE, thread, n_batch);
+}
+
+/**
+ * Kernel for messages whose length is known at compile time. Full blocks are transformed from the input with a
+ * constant trip count, the padding of the tail is precomputed and its words are loaded straight into registers.
+ */
+template<dword inlen>
+static inline void kernel_sha1_hash_fixed(const hash::record_input &indata, const hash::digest_output &outdata, dword n_batch, dword thread) {
+    using namespace hash::internal;
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    byte out[SHA1_BLOCK_SIZE];
+    sha1_ctx ctx{};
+    for (dword block = 0; block < md_full_blocks(inlen); ++block) {
+        dword words[MD_BLOCK_WORDS];
+        md_load_block<true>(in + block * MD_BLOCK_LENGTH, words);
+        sha1_transform_words(ctx.state, words);
+    }
+
+    dword m[md_tail_blocks(inlen) * MD_BLOCK_WORDS];
+    md_load_padded_tail<inlen, true>(in, m);
+#pragma unroll
+    for (dword block = 0; block < md_tail_blocks(inlen); ++block) {
+        sha1_transform_words(ctx.state, m + block * MD_BLOCK_WORDS);
+    }
+    sha1_store_digest(ctx.state, out);
+    outdata.store(out, SHA1_BLOCK_SIZE, thread, n_batch);
 }
 
 
 namespace hash::internal {
-    sycl::event launch_sha1_kernel(sycl::queue &q, sycl::event e, const device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch) {
+    sycl::event launch_sha1_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch) {
         auto config = get_kernel_sizes(q, n_batch);
         return q.submit([&](sycl::handler &cgh) {
             cgh.depends_on(e);
@@ -177,4 +234,19 @@ namespace hash::internal {
         });
     }
 
+    sycl::event launch_sha1_fixed_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return fixed_input_lengths::visit(inlen, [&](auto len) {
+            constexpr dword inlen_ = decltype(len)::value;
+            return q.submit([&](sycl::handler &cgh) {
+                cgh.depends_on(e);
+                cgh.parallel_for<sha1_fixed_kernel<inlen_>>(
+                        sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                        [=](sycl::nd_item<1> item) {
+                            kernel_sha1_hash_fixed<inlen_>(indata, outdata, n_batch, item.get_global_linear_id());
+                        });
+            });
+        });
+    }
+
 }
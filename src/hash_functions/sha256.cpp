@@ -1,195 +1,69 @@
 #include <hash_functions/sha256.hpp>
 #include <internal/determine_kernel_config.hpp>
 #include <internal/common.hpp>
-
-
-#include <cstring>
+#include <internal/fixed_length.hpp>
+#include "cores/sha256.hpp"
 
 using namespace usm_smart_ptr;
 
-/**************************** DATA TYPES ****************************/
-struct sha256_ctx {
-    byte data[64];
-    qword bitlen = 0;
-    dword datalen = 0;
-    dword state[8]{};
-
-    sha256_ctx() {
-        state[0] = 0x6a09e667;
-        state[1] = 0xbb67ae85;
-        state[2] = 0x3c6ef372;
-        state[3] = 0xa54ff53a;
-        state[4] = 0x510e527f;
-        state[5] = 0x9b05688c;
-        state[6] = 0x1f83d9ab;
-        state[7] = 0x5be0cd19;
-    }
-};
-
-/****************************** MACROS ******************************/
-#ifndef ROTLEFT
-#define ROTLEFT(a, b) (((a) << (b)) | ((a) >> (32-(b))))
-#endif
-
-#define ROTRIGHT(a, b) (((a) >> (b)) | ((a) << (32-(b))))
-
-#define CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
-#define MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
-#define EP0(x) (ROTRIGHT(x,2) ^ ROTRIGHT(x,13) ^ ROTRIGHT(x,22))
-#define EP1(x) (ROTRIGHT(x,6) ^ ROTRIGHT(x,11) ^ ROTRIGHT(x,25))
-#define SIG0(x) (ROTRIGHT(x,7) ^ ROTRIGHT(x,18) ^ ((x) >> 3))
-#define SIG1(x) (ROTRIGHT(x,17) ^ ROTRIGHT(x,19) ^ ((x) >> 10))
-
-/**************************** VARIABLES *****************************/
-
-
-/*********************** FUNCTION DEFINITIONS ***********************/
-static void sha256_transform(sha256_ctx *ctx, const byte *data) {
-    dword a, b, c, d, e, f, g, h, t1, t2, m[64];
-
-    static const dword consts[64] =
-            {0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
-             0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
-             0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
-             0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
-             0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
-             0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
-             0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
-             0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
-             0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
-             0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
-             0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
-
-#ifdef __NVPTX__
-#pragma unroll
-#endif
-    for (int i = 0, j = 0; i < 16; ++i, j += 4) {
-        m[i] = hash::upsample(data[j], data[j + 1], data[j + 2], data[j + 3]);
-    }
-
-#ifdef __NVPTX__
-#pragma unroll
-#endif
-    for (int i = 16; i < 64; ++i) {
-        m[i] = SIG1(m[i - 2]) + m[i - 7] + SIG0(m[i - 15]) + m[i - 16];
-    }
-
-    a = ctx->state[0];
-    b = ctx->state[1];
-    c = ctx->state[2];
-    d = ctx->state[3];
-    e = ctx->state[4];
-    f = ctx->state[5];
-    g = ctx->state[6];
-    h = ctx->state[7];
-
-#ifdef __NVPTX__
-#pragma unroll
-#endif
-    for (int i = 0; i < 64; ++i) {
-        t1 = h + EP1(e) + CH(e, f, g) + consts[i] + m[i];
-        t2 = EP0(a) + MAJ(a, b, c);
-        h = g;
-        g = f;
-        f = e;
-        e = d + t1;
-        d = c;
-        c = b;
-        b = a;
-        a = t1 + t2;
+template<typename K>
+static void kernel_sha256_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, const K &consts) {
+    if (thread >= n_batch) {
+        return;
     }
-
-    ctx->state[0] += a;
-    ctx->state[1] += b;
-    ctx->state[2] += c;
-    ctx->state[3] += d;
-    ctx->state[4] += e;
-    ctx->state[5] += f;
-    ctx->state[6] += g;
-    ctx->state[7] += h;
+    const byte *in = indata.record(thread, inlen);
+    byte out[SHA256_BLOCK_SIZE];
+    sha256_ctx ctx{};
+    sha256_update(&ctx, in, inlen, consts);
+    sha256_final(&ctx, out, consts);
+    outdata.store(out, SHA256_BLOCK_SIZE, thread, n_batch);
 }
 
-
-static void sha256_update(sha256_ctx *ctx, const byte *data, size_t len) {
-    for (dword i = 0; i < len; ++i) {
-        ctx->data[ctx->datalen] = data[i];
-        ctx->datalen++;
-        if (ctx->datalen == 64) {
-            sha256_transform(ctx, ctx->data);
-            ctx->bitlen += 512;
-            ctx->datalen = 0;
-        }
+/**
+ * Kernel for messages whose length is known at compile time. Full blocks are transformed from the input with a
+ * constant trip count, the padding of the tail is precomputed and its words are loaded straight into registers.
+ */
+template<dword inlen, typename K>
+static inline void kernel_sha256_hash_fixed(const hash::record_input &indata, const hash::digest_output &outdata, dword n_batch, dword thread, const K &consts) {
+    using namespace hash::internal;
+    if (thread >= n_batch) {
+        return;
     }
-}
-
-static void sha256_final(sha256_ctx *ctx, byte *hash) {
-    dword i = ctx->datalen;
-    // Pad whatever data is left in the buffer.
-    if (ctx->datalen < 56) {
-        ctx->data[i++] = 0x80;
-        while (i < 56) {
-            ctx->data[i++] = 0x00;
-        }
-
-    } else {
-        ctx->data[i++] = 0x80;
-        while (i < 64) {
-            ctx->data[i++] = 0x00;
-        }
-        sha256_transform(ctx, ctx->data);
-        std::memset(ctx->data, 0, 56);
+    const byte *in = indata.record(thread, inlen);
+    byte out[SHA256_BLOCK_SIZE];
+    sha256_ctx ctx{};
+    for (dword block = 0; block < md_full_blocks(inlen); ++block) {
+        dword words[MD_BLOCK_WORDS];
+        md_load_block<true>(in + block * MD_BLOCK_LENGTH, words);
+        sha256_transform_words(ctx.state, words, consts);
     }
 
-    // Append to the padding the total message's length in bits and transform.
-    ctx->bitlen += ctx->datalen * 8;
-    ctx->data[63] = ctx->bitlen;
-    ctx->data[62] = ctx->bitlen >> 8;
-    ctx->data[61] = ctx->bitlen >> 16;
-    ctx->data[60] = ctx->bitlen >> 24;
-    ctx->data[59] = ctx->bitlen >> 32;
-    ctx->data[58] = ctx->bitlen >> 40;
-    ctx->data[57] = ctx->bitlen >> 48;
-    ctx->data[56] = ctx->bitlen >> 56;
-    sha256_transform(ctx, ctx->data);
-
-    // Since this implementation uses little endian byte ordering and SHA uses big endian,
-    // reverse all the bytes when copying the final state to the output hash.
+    dword m[md_tail_blocks(inlen) * MD_BLOCK_WORDS];
+    md_load_padded_tail<inlen, true>(in, m);
 #pragma unroll
-    for (i = 0; i < 4; ++i) {
-        hash[i] = (ctx->state[0] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 4] = (ctx->state[1] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 8] = (ctx->state[2] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 12] = (ctx->state[3] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 16] = (ctx->state[4] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 20] = (ctx->state[5] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 24] = (ctx->state[6] >> (24 - i * 8)) & 0x000000ff;
-        hash[i + 28] = (ctx->state[7] >> (24 - i * 8)) & 0x000000ff;
+    for (dword block = 0; block < md_tail_blocks(inlen); ++block) {
+        sha256_transform_words(ctx.state, m + block * MD_BLOCK_WORDS, consts);
     }
-}
-
-static void kernel_sha256_hash(const byte *indata, dword inlen, byte *outdata, dword n_batch, dword thread) {
-    if (thread >= n_batch) {
-        return;
-    }
-    const byte *in = indata + thread * inlen;
-    byte *out = outdata + thread * SHA256_BLOCK_SIZE;
-    sha256_ctx ctx{};
-    sha256_update(&ctx, in, inlen);
-    sha256_final(&ctx, out);
+    sha256_store_digest(ctx.state, out);
+    outdata.store(out, SHA256_BLOCK_SIZE, thread, n_batch);
 }
 
 namespace hash::internal {
 
     sycl::event
-    launch_sha256_kernel(sycl::queue &q, sycl::event e, const device_accessible_ptr<byte> indata, device_accessible_ptr<byte> outdata, dword inlen, dword n_batch) {
-        auto config = get_kernel_sizes(q, n_batch);
-        return q.submit([&](sycl::handler &cgh) {
-            cgh.depends_on(e);
-            cgh.parallel_for<class sha256_kernel>(
-                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
-                    [=](sycl::nd_item<1> item) {
-                        kernel_sha256_hash(indata, inlen, outdata, n_batch, item.get_global_linear_id());
-                    });
+    launch_sha256_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement) {
+        return launch_with_table<sha256_kernel, SHA256_CONSTS>(q, std::move(e), placement, n_batch, [=](dword thread, const auto &consts) {
+            kernel_sha256_hash(indata, inlen, outdata, n_batch, thread, consts);
+        });
+    }
+
+    sycl::event
+    launch_sha256_fixed_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement) {
+        return fixed_input_lengths::visit(inlen, [&](auto len) {
+            constexpr dword inlen_ = decltype(len)::value;
+            return launch_with_table<sha256_fixed_kernel<inlen_>, SHA256_CONSTS>(q, e, placement, n_batch, [=](dword thread, const auto &consts) {
+                kernel_sha256_hash_fixed<inlen_>(indata, outdata, n_batch, thread, consts);
+            });
         });
     }
 
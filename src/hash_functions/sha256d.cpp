@@ -0,0 +1,40 @@
+#include <hash_functions/sha256d.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "cores/sha256.hpp"
+
+using namespace usm_smart_ptr;
+
+/**
+ * The second pass hashes the 32 bytes digest. Its big endian words are the state words of the first pass, so the
+ * block is built in registers and the padding (0x80 then 256 bits of length) is constant.
+ */
+template<typename K>
+static inline void kernel_sha256d_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, const K &consts) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    byte out[SHA256D_BLOCK_SIZE];
+    sha256_ctx first{};
+    sha256_update(&first, in, inlen, consts);
+    sha256_pad(&first, consts);
+
+    const dword words[16] = {first.state[0], first.state[1], first.state[2], first.state[3],
+                             first.state[4], first.state[5], first.state[6], first.state[7],
+                             0x80000000, 0, 0, 0, 0, 0, 0, 256};
+    sha256_ctx second{};
+    sha256_transform_words(second.state, words, consts);
+    sha256_store_digest(second.state, out);
+    outdata.store(out, SHA256D_BLOCK_SIZE, thread, n_batch);
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_sha256d_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, table_placement placement) {
+        return launch_with_table<sha256d_kernel, SHA256_CONSTS>(q, std::move(e), placement, n_batch, [=](dword thread, const auto &consts) {
+            kernel_sha256d_hash(indata, inlen, outdata, n_batch, thread, consts);
+        });
+    }
+
+}
@@ -0,0 +1,33 @@
+#include <hash_functions/xxh3.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "cores/xxhash.hpp"
+
+using namespace usm_smart_ptr;
+
+static inline void kernel_xxh3_hash(const hash::record_input &indata, dword inlen, const hash::digest_output &outdata, dword n_batch, dword thread, qword seed) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata.record(thread, inlen);
+    byte out[XXH3_BLOCK_SIZE];
+    qword h = xxh3_64(in, inlen, seed);
+    xxh_store_canonical(h, out);
+    outdata.store(out, XXH3_BLOCK_SIZE, thread, n_batch);
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_xxh3_kernel(sycl::queue &q, sycl::event e, record_input indata, digest_output outdata, dword inlen, dword n_batch, qword seed) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<class xxh3_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        kernel_xxh3_hash(indata, inlen, outdata, n_batch, item.get_global_linear_id(), seed);
+                    });
+        });
+    }
+
+}
@@ -0,0 +1,291 @@
+#include <io/file_reader.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static inline size_t round_up_to_alignment(size_t n) {
+    return std::max(hash::FILE_READ_ALIGNMENT, (n + hash::FILE_READ_ALIGNMENT - 1) / hash::FILE_READ_ALIGNMENT * hash::FILE_READ_ALIGNMENT);
+}
+
+/**
+ * File opened for reading, closed on destruction unless it is the standard input. Directories are refused.
+ */
+class opened_file {
+private:
+    const std::string &path_;
+
+public:
+    int fd;
+    struct stat st{};
+
+    opened_file(const std::string &path, int flags) : path_(path) {
+        if (path == "-") {
+            fd = STDIN_FILENO;
+        } else {
+            fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | flags);
+            /* File systems without direct I/O (tmpfs...) refuse O_DIRECT */
+            if (fd < 0 && errno == EINVAL && (flags & O_DIRECT)) {
+                fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | (flags & ~O_DIRECT));
+            }
+        }
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), path);
+        }
+        if (fstat(fd, &st) != 0) {
+            fail(errno);
+        }
+        if (S_ISDIR(st.st_mode)) {
+            fail(EISDIR);
+        }
+    }
+
+    opened_file(const opened_file &) = delete;
+
+    opened_file &operator=(const opened_file &) = delete;
+
+    ~opened_file() {
+        if (fd > STDIN_FILENO) ::close(fd);
+    }
+
+    [[noreturn]] void fail(int error) {
+        if (fd > STDIN_FILENO) ::close(fd);
+        fd = -1;
+        throw std::system_error(error, std::generic_category(), path_);
+    }
+
+    [[nodiscard]] bool is_regular() const { return S_ISREG(st.st_mode); }
+};
+
+namespace hash {
+
+    void file_contents::reset() noexcept {
+        if (storage_ == storage::mapped) {
+            munmap(data_, size_);
+        } else if (storage_ == storage::allocated) {
+            std::free(data_);
+        }
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+        storage_ = storage::view;
+    }
+
+    void file_contents::reserve(size_t capacity) {
+        capacity = round_up_to_alignment(capacity);
+        if (storage_ == storage::allocated && capacity <= capacity_) {
+            return;
+        }
+        auto *grown = (byte *) std::aligned_alloc(FILE_READ_ALIGNMENT, capacity);
+        if (!grown) {
+            throw std::bad_alloc();
+        }
+        const size_t size = size_;
+        if (size) {
+            std::memcpy(grown, data_, size);
+        }
+        reset();
+        data_ = grown;
+        size_ = size;
+        capacity_ = capacity;
+        storage_ = storage::allocated;
+    }
+
+    file_contents::file_contents(file_contents &&other) noexcept:
+            data_(std::exchange(other.data_, nullptr)),
+            size_(std::exchange(other.size_, 0)),
+            capacity_(std::exchange(other.capacity_, 0)),
+            storage_(std::exchange(other.storage_, storage::view)) {}
+
+    file_contents &file_contents::operator=(file_contents &&other) noexcept {
+        if (this != &other) {
+            reset();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+            storage_ = std::exchange(other.storage_, storage::view);
+        }
+        return *this;
+    }
+
+    file_contents file_contents::view(const byte *data, size_t size) {
+        file_contents contents;
+        contents.data_ = const_cast<byte *>(data);
+        contents.size_ = contents.capacity_ = size;
+        return contents;
+    }
+
+    file_contents file_contents::load(const std::string &path) {
+        opened_file file(path, 0);
+        file_contents contents;
+        if (file.is_regular() && file.st.st_size > 0) {
+            void *map = mmap(nullptr, (size_t) file.st.st_size, PROT_READ, MAP_PRIVATE, file.fd, 0);
+            if (map != MAP_FAILED) {
+                madvise(map, (size_t) file.st.st_size, MADV_SEQUENTIAL);
+                contents.data_ = (byte *) map;
+                contents.size_ = contents.capacity_ = (size_t) file.st.st_size;
+                contents.storage_ = storage::mapped;
+                return contents;
+            }
+        }
+
+        /* Plain reads, the size of non regular files being only known at the end */
+        contents.reserve(file.is_regular() ? (size_t) file.st.st_size : FILE_READ_CHUNK_BYTES);
+        for (;;) {
+            if (contents.size_ == contents.capacity_) {
+                contents.reserve(2 * contents.capacity_);
+            }
+            ssize_t n = ::read(file.fd, contents.data_ + contents.size_, std::min(FILE_READ_CHUNK_BYTES, contents.capacity_ - contents.size_));
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0) {
+                file.fail(errno);
+            }
+            if (n == 0) {
+                return contents;
+            }
+            contents.size_ += (size_t) n;
+        }
+    }
+
+    file_contents file_contents::read(const std::string &path) {
+        if (path == "-") {
+            return load(path);
+        }
+        opened_file file(path, O_DIRECT);
+        /* Files of procfs or sysfs report a size of 0 whatever they hold, they are read to their end */
+        if (!file.is_regular() || file.st.st_size == 0) {
+            return load(path);
+        }
+
+        /* Direct reads need aligned lengths and offsets: the buffer is rounded up, the last read stops at the end, which
+         * is kept even if the file grew since it was opened */
+        file_contents contents;
+        contents.reserve((size_t) file.st.st_size);
+        while (contents.size_ < contents.capacity_) {
+            ssize_t n = ::pread(file.fd, contents.data_ + contents.size_, std::min(FILE_READ_CHUNK_BYTES, contents.capacity_ - contents.size_), (off_t) contents.size_);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && errno == EINVAL && (fcntl(file.fd, F_GETFL) & O_DIRECT)) {
+                fcntl(file.fd, F_SETFL, fcntl(file.fd, F_GETFL) & ~O_DIRECT);
+                continue;
+            }
+            if (n < 0) {
+                file.fail(errno);
+            }
+            if (n == 0) {
+                break;
+            }
+            contents.size_ += (size_t) n;
+            if (contents.size_ >= (size_t) file.st.st_size) {
+                break;
+            }
+        }
+        return contents;
+    }
+
+
+    file_reader_pool::file_reader_pool(std::vector<std::string> paths, file_io io, size_t n_threads, size_t memory_budget) :
+            paths_(std::move(paths)),
+            budget_(memory_budget),
+            direct_(io != file_io::mapped) {
+        n_threads = std::clamp<size_t>(n_threads, 1, std::max<size_t>(1, paths_.size()));
+        for (size_t i = 0; i < n_threads; ++i) {
+            threads_.emplace_back([this]() { read_loop(); });
+        }
+    }
+
+    file_reader_pool::~file_reader_pool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        budget_cv_.notify_all();
+        for (auto &thread: threads_) {
+            thread.join();
+        }
+    }
+
+    void file_reader_pool::read_loop() {
+        for (;;) {
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (stopping_ || next_path_ == paths_.size()) {
+                    return;
+                }
+                index = next_path_++;
+            }
+
+            /* Non regular files reserve nothing, they are charged once read */
+            struct stat st{};
+            size_t reserved = stat(paths_[index].c_str(), &st) == 0 && S_ISREG(st.st_mode) ? (size_t) st.st_size : 0;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                budget_cv_.wait(lock, [&]() { return stopping_ || held_bytes_ == 0 || held_bytes_ + reserved <= budget_; });
+                if (stopping_) {
+                    return;
+                }
+                held_bytes_ += reserved;
+            }
+
+            loaded_file file{index, {}, {}};
+            try {
+                file.contents = direct_ ? file_contents::read(paths_[index]) : file_contents::load(paths_[index]);
+            } catch (const std::exception &e) {
+                file.error = e.what();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                held_bytes_ = held_bytes_ - reserved + file.contents.size();
+                ready_.emplace_back(std::move(file));
+            }
+            ready_cv_.notify_one();
+        }
+    }
+
+    bool file_reader_pool::next(loaded_file &file, bool wait) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (wait) {
+            ready_cv_.wait(lock, [&]() { return !ready_.empty() || handed_out_ == paths_.size(); });
+        }
+        if (ready_.empty()) {
+            return false;
+        }
+        file = std::move(ready_.front());
+        ready_.pop_front();
+        ++handed_out_;
+        return true;
+    }
+
+    void file_reader_pool::release(loaded_file &file) {
+        const size_t bytes = file.contents.size();
+        file.contents = {};
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            held_bytes_ -= std::min(bytes, held_bytes_);
+        }
+        budget_cv_.notify_all();
+    }
+
+    std::unique_ptr<file_source> make_file_source(std::vector<std::string> paths, const file_reader_options &options) {
+#ifdef USE_IO_URING
+        if (options.io == file_io::io_uring) {
+            if (auto reader = internal::make_uring_file_reader(paths, options)) {
+                return reader;
+            }
+        }
+#endif
+        return std::make_unique<file_reader_pool>(std::move(paths), options.io == file_io::mapped ? file_io::mapped : file_io::pread, options.n_readers, options.memory_budget);
+    }
+
+}
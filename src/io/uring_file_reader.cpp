@@ -0,0 +1,542 @@
+#include <io/file_reader.hpp>
+
+#ifdef USE_IO_URING
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/**
+ * Minimal io_uring through the raw system calls, liburing is not a dependency: one submitter, reads only.
+ */
+class io_ring {
+private:
+    int fd_ = -1;
+    void *sq_ring_ = MAP_FAILED;
+    size_t sq_ring_size_ = 0;
+    void *cq_ring_ = MAP_FAILED;
+    size_t cq_ring_size_ = 0;
+    io_uring_sqe *sqes_ = (io_uring_sqe *) MAP_FAILED;
+    size_t sqes_size_ = 0;
+
+    unsigned *sq_head_ = nullptr, *sq_tail_ = nullptr, *sq_array_ = nullptr, sq_mask_ = 0;
+    unsigned *cq_head_ = nullptr, *cq_tail_ = nullptr, cq_mask_ = 0;
+    io_uring_cqe *cqes_ = nullptr;
+    unsigned local_tail_ = 0;
+    unsigned to_submit_ = 0;
+
+    void close_ring() {
+        if (sqes_ != MAP_FAILED) munmap(sqes_, sqes_size_);
+        if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) munmap(cq_ring_, cq_ring_size_);
+        if (sq_ring_ != MAP_FAILED) munmap(sq_ring_, sq_ring_size_);
+        if (fd_ >= 0) ::close(fd_);
+        sqes_ = (io_uring_sqe *) MAP_FAILED;
+        cq_ring_ = sq_ring_ = MAP_FAILED;
+        fd_ = -1;
+    }
+
+    [[noreturn]] void fail(int error) {
+        close_ring();
+        throw std::system_error(error, std::generic_category(), "io_uring");
+    }
+
+public:
+    unsigned entries = 0;
+
+    explicit io_ring(unsigned depth) {
+        io_uring_params params{};
+        fd_ = (int) syscall(__NR_io_uring_setup, depth, &params);
+        if (fd_ < 0) {
+            fail(errno);
+        }
+        entries = params.sq_entries;
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+        sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED) {
+            fail(errno);
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP) {
+            cq_ring_ = sq_ring_;
+        } else {
+            cq_ring_ = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+            if (cq_ring_ == MAP_FAILED) {
+                fail(errno);
+            }
+        }
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = (io_uring_sqe *) mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES);
+        if (sqes_ == MAP_FAILED) {
+            fail(errno);
+        }
+
+        auto *sq = (byte *) sq_ring_, *cq = (byte *) cq_ring_;
+        sq_head_ = (unsigned *) (sq + params.sq_off.head);
+        sq_tail_ = (unsigned *) (sq + params.sq_off.tail);
+        sq_mask_ = *(unsigned *) (sq + params.sq_off.ring_mask);
+        sq_array_ = (unsigned *) (sq + params.sq_off.array);
+        cq_head_ = (unsigned *) (cq + params.cq_off.head);
+        cq_tail_ = (unsigned *) (cq + params.cq_off.tail);
+        cq_mask_ = *(unsigned *) (cq + params.cq_off.ring_mask);
+        cqes_ = (io_uring_cqe *) (cq + params.cq_off.cqes);
+        local_tail_ = *sq_tail_;
+    }
+
+    io_ring(const io_ring &) = delete;
+
+    io_ring &operator=(const io_ring &) = delete;
+
+    ~io_ring() { close_ring(); }
+
+    /**
+     * @return whether the buffers could be registered, they can be read into with IORING_OP_READ_FIXED
+     */
+    bool register_buffers(const iovec *buffers, unsigned count) {
+        return syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+    }
+
+    /**
+     * The caller never has more than `entries` requests in flight, so there always is a free entry.
+     */
+    io_uring_sqe *get_sqe() {
+        const unsigned index = local_tail_++ & sq_mask_;
+        sq_array_[index] = index;
+        ++to_submit_;
+        std::memset(&sqes_[index], 0, sizeof(io_uring_sqe));
+        return &sqes_[index];
+    }
+
+    /**
+     * Submits the new entries and waits for `wait_for` completions.
+     */
+    void submit_and_wait(unsigned wait_for) {
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        while (to_submit_ || wait_for) {
+            int submitted = (int) syscall(__NR_io_uring_enter, fd_, to_submit_, wait_for, wait_for ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+            if (submitted < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+                continue;
+            }
+            if (submitted < 0) {
+                throw std::system_error(errno, std::generic_category(), "io_uring_enter");
+            }
+            to_submit_ -= std::min<unsigned>(to_submit_, (unsigned) submitted);
+            wait_for = 0;
+        }
+    }
+
+    template<typename Func>
+    void for_each_completion(Func &&on_completion) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+            on_completion(cqe.user_data, cqe.res);
+        }
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+};
+
+namespace hash {
+
+    /**
+     * One thread keeps up to `queue_depth` reads in flight. Files up to `slot_bytes` are read whole into a slot of a
+     * registered arena, the others in chunks into their own aligned buffer within the memory budget. The arena,
+     * `n_slots * slot_bytes`, is allocated once and not counted in the budget. Files are opened with O_DIRECT when the
+     * file system allows it.
+     */
+    class uring_file_reader : public file_source {
+    private:
+        struct pending_file {
+            size_t index;
+            int fd;
+            size_t size; // Size when opened, the reads go up to its rounding to the alignment
+            size_t end; // First byte past the end found by the reads
+            size_t issued = 0;
+            dword outstanding = 0;
+            int slot = -1;
+            byte *data = nullptr;
+            file_contents contents;
+            int error = 0;
+        };
+
+        struct request {
+            pending_file *file;
+            size_t offset;
+            size_t length;
+            iovec iov;
+        };
+
+        const std::vector<std::string> paths_;
+        const size_t budget_;
+        const size_t slot_bytes_;
+        byte *arena_ = nullptr;
+        bool fixed_ = false;
+        io_ring ring_;
+        std::vector<request> requests_;
+        std::vector<dword> free_requests_;
+        std::map<size_t, pending_file> files_;
+
+        std::mutex mutex_;
+        std::condition_variable ready_cv_;
+        std::condition_variable release_cv_;
+        std::deque<loaded_file> ready_;
+        std::vector<int> free_slots_;
+        std::vector<int> slot_of_;
+        std::vector<size_t> charge_of_;
+        size_t next_path_ = 0;
+        size_t held_bytes_ = 0;
+        size_t handed_out_ = 0;
+        size_t releases_ = 0;
+        bool stopping_ = false;
+        std::thread thread_;
+
+        [[nodiscard]] static size_t aligned(size_t n) {
+            return (n + FILE_READ_ALIGNMENT - 1) / FILE_READ_ALIGNMENT * FILE_READ_ALIGNMENT;
+        }
+
+        void push_ready(loaded_file &&file) {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                ready_.emplace_back(std::move(file));
+            }
+            ready_cv_.notify_one();
+        }
+
+        /**
+         * Opens the next path. Unreadable and non regular files are handed out at once, as are regular files of size 0,
+         * read to their end since procfs and sysfs report that size for files with contents.
+         */
+        pending_file *open_next() {
+            const size_t index = next_path_++;
+            const std::string &path = paths_[index];
+            loaded_file file{index, {}, {}};
+            try {
+                int fd = path == "-" ? -1 : ::open(path.c_str(), O_RDONLY | O_CLOEXEC | O_DIRECT);
+                if (fd < 0 && errno == EINVAL) {
+                    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                }
+                struct stat st{};
+                if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+                    pending_file &pending = files_[index];
+                    pending.index = index;
+                    pending.fd = fd;
+                    pending.size = pending.end = (size_t) st.st_size;
+                    return &pending;
+                }
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                if (path != "-" && fd < 0) {
+                    throw std::system_error(errno, std::generic_category(), path);
+                }
+                file.contents = file_contents::load(path);
+                std::lock_guard<std::mutex> lock(mutex_);
+                held_bytes_ += charge_of_[index] = file.contents.size();
+            } catch (const std::exception &e) {
+                file.contents = {};
+                file.error = e.what();
+            }
+            push_ready(std::move(file));
+            return nullptr;
+        }
+
+        /**
+         * Gives an opened file a slot or a buffer, if there is memory left for it.
+         */
+        bool admit(pending_file &file) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (aligned(file.size) <= slot_bytes_) {
+                if (free_slots_.empty()) {
+                    return false;
+                }
+                file.slot = free_slots_.back();
+                free_slots_.pop_back();
+                file.data = arena_ + (size_t) file.slot * slot_bytes_;
+                return true;
+            }
+            if (held_bytes_ != 0 && held_bytes_ + file.size > budget_) {
+                return false;
+            }
+            try {
+                file.contents.reserve(file.size);
+            } catch (const std::bad_alloc &) {
+                file.error = ENOMEM;
+            }
+            file.data = file.contents.data_;
+            held_bytes_ += file.size;
+            return true;
+        }
+
+        void submit_read(dword id) {
+            request &r = requests_[id];
+            io_uring_sqe *sqe = ring_.get_sqe();
+            sqe->fd = r.file->fd;
+            sqe->off = r.offset;
+            sqe->user_data = id;
+            if (fixed_ && r.file->slot >= 0) {
+                sqe->opcode = IORING_OP_READ_FIXED;
+                sqe->addr = (qword) (r.file->data + r.offset);
+                sqe->len = (dword) r.length;
+                sqe->buf_index = (unsigned short) r.file->slot;
+            } else {
+                r.iov = {r.file->data + r.offset, r.length};
+                sqe->opcode = IORING_OP_READV;
+                sqe->addr = (qword) &r.iov;
+                sqe->len = 1;
+            }
+        }
+
+        /**
+         * Issues the next chunk of a file.
+         * @return whether the whole file is issued
+         */
+        bool issue_chunk(pending_file &file) {
+            const size_t length = std::min(FILE_READ_CHUNK_BYTES, aligned(file.size) - file.issued);
+            const dword id = free_requests_.back();
+            free_requests_.pop_back();
+            requests_[id] = {&file, file.issued, length, {}};
+            file.issued += length;
+            ++file.outstanding;
+            submit_read(id);
+            return file.issued >= aligned(file.size);
+        }
+
+        void finish(pending_file &file) {
+            ::close(file.fd);
+            loaded_file loaded{file.index, {}, {}};
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (file.error) {
+                    if (file.slot >= 0) {
+                        free_slots_.push_back(file.slot);
+                    } else {
+                        held_bytes_ -= file.size;
+                    }
+                    loaded.error = std::system_error(file.error, std::generic_category(), paths_[file.index]).what();
+                } else if (file.slot >= 0) {
+                    slot_of_[file.index] = file.slot;
+                    loaded.contents = file_contents::view(file.data, std::min(file.size, file.end));
+                } else {
+                    charge_of_[file.index] = file.size;
+                    file.contents.size_ = std::min(file.size, file.end);
+                    loaded.contents = std::move(file.contents);
+                }
+            }
+            files_.erase(file.index);
+            push_ready(std::move(loaded));
+        }
+
+        void complete(dword id, int res) {
+            request &r = requests_[id];
+            pending_file &file = *r.file;
+            if (res == -EINTR || res == -EAGAIN) {
+                submit_read(id);
+                return;
+            }
+            if (res == -EINVAL && (fcntl(file.fd, F_GETFL) & O_DIRECT)) {
+                /* Direct I/O refused for this file after all, read it through the page cache */
+                fcntl(file.fd, F_SETFL, fcntl(file.fd, F_GETFL) & ~O_DIRECT);
+                submit_read(id);
+                return;
+            }
+            if (res < 0) {
+                file.error = -res;
+            } else if (res == 0) {
+                file.end = std::min(file.end, r.offset);
+            } else if ((size_t) res < r.length && r.offset + (size_t) res < file.size) {
+                /* Short read before the end: read the rest */
+                r.offset += (size_t) res;
+                r.length -= (size_t) res;
+                submit_read(id);
+                return;
+            } else if ((size_t) res < r.length) {
+                file.end = std::min(file.end, r.offset + (size_t) res);
+            }
+            free_requests_.push_back(id);
+            if (--file.outstanding == 0 && file.issued >= aligned(file.size)) {
+                finish(file);
+            }
+        }
+
+        void ring_loop() {
+            std::deque<pending_file *> issuing;
+            pending_file *waiting = nullptr; // Opened, waiting for memory
+            size_t in_flight = 0;
+            for (;;) {
+                bool stopping;
+                size_t releases;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    stopping = stopping_;
+                    releases = releases_;
+                }
+                while (!stopping && !free_requests_.empty()) {
+                    if (!issuing.empty() && issuing.front()->error) {
+                        /* A read failed, the remaining chunks are dropped */
+                        pending_file &file = *issuing.front();
+                        issuing.pop_front();
+                        file.issued = aligned(file.size);
+                        if (file.outstanding == 0) {
+                            finish(file);
+                        }
+                        continue;
+                    }
+                    if (!issuing.empty()) {
+                        if (issue_chunk(*issuing.front())) {
+                            issuing.pop_front();
+                        }
+                        ++in_flight;
+                        continue;
+                    }
+                    if (!waiting) {
+                        if (next_path_ == paths_.size()) break;
+                        waiting = open_next();
+                        continue;
+                    }
+                    if (!admit(*waiting)) break;
+                    if (waiting->error) {
+                        finish(*waiting);
+                    } else {
+                        issuing.push_back(waiting);
+                    }
+                    waiting = nullptr;
+                }
+
+                if (in_flight == 0) {
+                    if (stopping || (!waiting && next_path_ == paths_.size())) {
+                        break;
+                    }
+                    /* Everything read is held by the consumer */
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    release_cv_.wait(lock, [&]() { return stopping_ || releases_ != releases; });
+                    continue;
+                }
+                ring_.submit_and_wait(1);
+                ring_.for_each_completion([&](qword id, int res) {
+                    const size_t free_before = free_requests_.size();
+                    complete((dword) id, res);
+                    in_flight -= free_requests_.size() - free_before;
+                });
+            }
+            for (auto &[index, file]: files_) {
+                ::close(file.fd);
+            }
+            files_.clear();
+        }
+
+    public:
+        uring_file_reader(const std::vector<std::string> &paths, const file_reader_options &options) :
+                paths_(paths),
+                budget_(options.memory_budget),
+                slot_bytes_(std::clamp(aligned(options.slot_bytes), FILE_READ_ALIGNMENT, FILE_READ_CHUNK_BYTES)),
+                ring_(std::clamp<dword>(options.queue_depth, 1, 4096)),
+                slot_of_(paths.size(), -1),
+                charge_of_(paths.size(), 0) {
+            const dword n_slots = std::clamp<dword>(options.n_slots, 1, 1 << 14);
+            arena_ = (byte *) std::aligned_alloc(FILE_READ_ALIGNMENT, n_slots * slot_bytes_);
+            if (!arena_) {
+                throw std::bad_alloc();
+            }
+            std::vector<iovec> slots(n_slots);
+            for (dword i = 0; i < n_slots; ++i) {
+                slots[i] = {arena_ + (size_t) i * slot_bytes_, slot_bytes_};
+                free_slots_.push_back((int) (n_slots - 1 - i));
+            }
+            /* Registration pins the arena, it fails under a low RLIMIT_MEMLOCK: the slots are then read with READV */
+            fixed_ = ring_.register_buffers(slots.data(), n_slots);
+            requests_.resize(std::min<size_t>(options.queue_depth ? options.queue_depth : 1, ring_.entries));
+            for (dword i = 0; i < requests_.size(); ++i) {
+                free_requests_.push_back(i);
+            }
+            thread_ = std::thread([this]() {
+                try {
+                    ring_loop();
+                } catch (const std::exception &e) {
+                    /* The ring failed: the files not handed out yet are reported with the error */
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    for (size_t index = 0; index < paths_.size(); ++index) {
+                        if (files_.count(index) || index >= next_path_) {
+                            ready_.push_back({index, {}, paths_[index] + ": " + e.what()});
+                        }
+                    }
+                    for (auto &[index, file]: files_) {
+                        ::close(file.fd);
+                    }
+                    next_path_ = paths_.size();
+                }
+                ready_cv_.notify_all();
+            });
+        }
+
+        uring_file_reader(const uring_file_reader &) = delete;
+
+        uring_file_reader &operator=(const uring_file_reader &) = delete;
+
+        ~uring_file_reader() override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                stopping_ = true;
+            }
+            release_cv_.notify_all();
+            thread_.join();
+            ready_.clear();
+            std::free(arena_);
+        }
+
+        bool next(loaded_file &file, bool wait) override {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (wait) {
+                ready_cv_.wait(lock, [&]() { return !ready_.empty() || handed_out_ == paths_.size(); });
+            }
+            if (ready_.empty()) {
+                return false;
+            }
+            file = std::move(ready_.front());
+            ready_.pop_front();
+            ++handed_out_;
+            return true;
+        }
+
+        void release(loaded_file &file) override {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (slot_of_[file.index] >= 0) {
+                    free_slots_.push_back(std::exchange(slot_of_[file.index], -1));
+                } else {
+                    held_bytes_ -= std::min(std::exchange(charge_of_[file.index], 0), held_bytes_);
+                }
+                file.contents = {};
+                ++releases_;
+            }
+            release_cv_.notify_all();
+        }
+    };
+
+    namespace internal {
+        std::unique_ptr<file_source> make_uring_file_reader(const std::vector<std::string> &paths, const file_reader_options &options) {
+            try {
+                return std::make_unique<uring_file_reader>(paths, options);
+            } catch (const std::exception &) {
+                return nullptr;
+            }
+        }
+    }
+
+}
+
+#endif
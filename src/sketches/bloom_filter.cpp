@@ -0,0 +1,71 @@
+#include <sketches/bloom_filter.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "digest_words.hpp"
+
+using namespace usm_smart_ptr;
+
+using global_atomic_dword = sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+
+static inline void kernel_bloom_insert(const byte *digests, dword digest_size, dword n_items, dword *bits, qword n_bits, dword n_hashes, dword thread) {
+    if (thread >= n_items) {
+        return;
+    }
+    qword h1, h2;
+    digest_to_pair(digests + thread * digest_size, digest_size, h1, h2);
+    for (dword i = 0; i < n_hashes; ++i) {
+        qword bit = (h1 + i * h2) % n_bits;
+        dword mask = 1u << (bit % 32);
+        global_atomic_dword word(bits[bit / 32]);
+        /* Most bits end up set: reading first avoids contended read-modify-writes */
+        if (!(word.load() & mask)) {
+            word.fetch_or(mask);
+        }
+    }
+}
+
+static inline void kernel_bloom_query(const byte *digests, dword digest_size, dword n_items, const dword *bits, qword n_bits, dword n_hashes, dword *bitmap, dword first, dword thread) {
+    if (thread >= n_items) {
+        return;
+    }
+    qword h1, h2;
+    digest_to_pair(digests + thread * digest_size, digest_size, h1, h2);
+    for (dword i = 0; i < n_hashes; ++i) {
+        qword bit = (h1 + i * h2) % n_bits;
+        if (!(bits[bit / 32] & (1u << (bit % 32)))) {
+            return;
+        }
+    }
+    dword item = first + thread;
+    global_atomic_dword(bitmap[item / 32]).fetch_or(1u << (item % 32));
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_bloom_insert_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword n_items, device_accessible_ptr<dword> bits, qword n_bits, dword n_hashes) {
+        auto config = get_kernel_sizes(q, n_items);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<bloom_insert_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        kernel_bloom_insert(digests, digest_size, n_items, bits, n_bits, n_hashes, item.get_global_linear_id());
+                    });
+        });
+    }
+
+    sycl::event
+    launch_bloom_query_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword n_items, device_accessible_ptr<dword> bits, qword n_bits, dword n_hashes,
+                              device_accessible_ptr<dword> bitmap, dword first) {
+        auto config = get_kernel_sizes(q, n_items);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<bloom_query_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        kernel_bloom_query(digests, digest_size, n_items, bits, n_bits, n_hashes, bitmap, first, item.get_global_linear_id());
+                    });
+        });
+    }
+
+}
@@ -0,0 +1,108 @@
+#include <sketches/chunking.hpp>
+#include <hash_functions/sha256.hpp>
+#include "../hash_functions/cores/sha256.hpp"
+
+using namespace usm_smart_ptr;
+using hash::internal::CDC_SEGMENT_BYTES;
+using hash::internal::GEAR_WINDOW;
+
+/**
+ * Calls `on_candidate(cut, h)` for each position of a segment whose Gear hash `h` has the bits of `mask_large` clear,
+ * the cut being after the byte.
+ */
+template<typename T, typename Func>
+static inline void scan_segment(const byte *indata, qword len, size_t segment, const T &gear, qword mask_large, Func &&on_candidate) {
+    const qword begin = segment * CDC_SEGMENT_BYTES;
+    const qword end = begin + CDC_SEGMENT_BYTES < len ? begin + CDC_SEGMENT_BYTES : len;
+    qword h = 0;
+    for (qword i = begin >= GEAR_WINDOW - 1 ? begin - (GEAR_WINDOW - 1) : 0; i < begin; ++i) {
+        h = (h << 1) + gear[indata[i]];
+    }
+    for (qword i = begin; i < end; ++i) {
+        h = (h << 1) + gear[indata[i]];
+        if ((h & mask_large) == 0) {
+            on_candidate(i + 1, h);
+        }
+    }
+}
+
+static inline dword cdc_segments(qword len) {
+    return (dword) std::max<qword>(1, (len + CDC_SEGMENT_BYTES - 1) / CDC_SEGMENT_BYTES);
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_cdc_count_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, qword len, qword mask_large, table_placement placement, device_accessible_ptr<qword> counts) {
+        const dword n_segments = cdc_segments(len);
+        return launch_with_table<cdc_count_kernel, GEAR_TABLE>(q, std::move(e), placement, n_segments, [=](dword thread, const auto &gear) {
+            if (thread >= n_segments) {
+                return;
+            }
+            qword count = 0;
+            scan_segment(indata, len, thread, gear, mask_large, [&](qword, qword) { ++count; });
+            ((qword *) counts)[thread] = count;
+        });
+    }
+
+    sycl::event
+    launch_cdc_candidates_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, qword len, qword mask_small, qword mask_large, table_placement placement,
+                                 device_accessible_ptr<qword> offsets, device_accessible_ptr<qword> candidates) {
+        const dword n_segments = cdc_segments(len);
+        return launch_with_table<cdc_candidates_kernel, GEAR_TABLE>(q, std::move(e), placement, n_segments, [=](dword thread, const auto &gear) {
+            if (thread >= n_segments) {
+                return;
+            }
+            qword *out = (qword *) candidates + ((qword *) offsets)[thread];
+            scan_segment(indata, len, thread, gear, mask_large, [&](qword cut, qword h) {
+                *out++ = cut << 1 | ((h & mask_small) == 0);
+            });
+        });
+    }
+
+    sycl::event
+    launch_cdc_select_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> candidates, qword n_candidates, qword len, dword min_size, dword avg_size, dword max_size,
+                             device_accessible_ptr<qword> bounds, device_accessible_ptr<qword> n_chunks) {
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<cdc_select_kernel>(sycl::nd_range<1>(sycl::range<1>(1), sycl::range<1>(1)), [=](sycl::nd_item<1>) {
+                const auto *cand = (const qword *) candidates;
+                auto *out = (qword *) bounds;
+                qword start = 0, k = 0, n = 0;
+                while (start < len) {
+                    out[n++] = start;
+                    const qword limit = start + max_size < len ? start + max_size : len;
+                    qword cut = limit;
+                    while (k < n_candidates && (cand[k] >> 1) < start + min_size) {
+                        ++k;
+                    }
+                    for (; k < n_candidates && (cand[k] >> 1) <= limit; ++k) {
+                        /* Harder to cut before the average size, easier after: normalised chunking */
+                        if ((cand[k] & 1) || (cand[k] >> 1) - start > avg_size) {
+                            cut = cand[k++] >> 1;
+                            break;
+                        }
+                    }
+                    start = cut;
+                }
+                out[n] = len;
+                *(qword *) n_chunks = n;
+            });
+        });
+    }
+
+    sycl::event
+    launch_cdc_sha256_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> bounds, dword n_chunks, table_placement placement,
+                             device_accessible_ptr<byte> digests) {
+        return launch_with_table<cdc_sha256_kernel, SHA256_CONSTS>(q, std::move(e), placement, n_chunks, [=](dword thread, const auto &consts) {
+            if (thread >= n_chunks) {
+                return;
+            }
+            const qword begin = ((qword *) bounds)[thread];
+            sha256_ctx ctx{};
+            sha256_update(&ctx, (byte *) indata + begin, ((qword *) bounds)[thread + 1] - begin, consts);
+            sha256_final(&ctx, (byte *) digests + (qword) thread * SHA256_BLOCK_SIZE, consts);
+        });
+    }
+
+}
@@ -0,0 +1,220 @@
+#include <sketches/count_min.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "sketch_hash.hpp"
+
+using namespace usm_smart_ptr;
+
+using global_atomic_dword = sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+using global_atomic_qword = sycl::atomic_ref<qword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+
+/**
+ * Seed of the row `row`, the first row uses the seed of the sketch.
+ */
+static inline qword cms_row_seed(qword seed, dword row) {
+    return seed + (qword) row * 0x9e3779b97f4a7c15;
+}
+
+/**
+ * Increments a counter, which sticks at 2^32 - 1 instead of wrapping back to small counts.
+ */
+static inline void saturating_increment(dword &counter) {
+    auto atomic_counter = global_atomic_dword(counter);
+    dword current = atomic_counter.load();
+    while (current != ~0u && !atomic_counter.compare_exchange_strong(current, current + 1)) {}
+}
+
+template<hash::method M>
+static inline void kernel_cms_add(const byte *indata, dword inlen, dword n_batch, qword seed, dword width, dword depth, dword *counters, dword thread) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata + (qword) thread * inlen;
+    for (dword r = 0; r < depth; ++r) {
+        qword h = sketch_hash<M>(in, inlen, cms_row_seed(seed, r));
+        saturating_increment(counters[(qword) r * width + h % width]);
+    }
+}
+
+template<hash::method M>
+static inline void kernel_cms_estimate(const byte *indata, dword inlen, dword n_batch, qword seed, dword width, dword depth, const dword *counters, dword *estimates, dword thread) {
+    if (thread >= n_batch) {
+        return;
+    }
+    const byte *in = indata + (qword) thread * inlen;
+    dword estimate = ~0u;
+    for (dword r = 0; r < depth; ++r) {
+        qword h = sketch_hash<M>(in, inlen, cms_row_seed(seed, r));
+        dword counter = counters[(qword) r * width + h % width];
+        estimate = counter < estimate ? counter : estimate;
+    }
+    estimates[thread] = estimate;
+}
+
+template<hash::method M>
+static inline void kernel_cms_distinct(const byte *indata, dword inlen, dword n_batch, qword seed, qword *set, qword set_size, dword *estimates, dword thread) {
+    if (thread >= n_batch) {
+        return;
+    }
+    /* A seed no row uses, 0 marks the empty slots */
+    qword fingerprint = sketch_hash<M>(indata + (qword) thread * inlen, inlen, ~seed);
+    fingerprint += fingerprint == 0;
+    for (qword slot = fingerprint & (set_size - 1);; slot = (slot + 1) & (set_size - 1)) {
+        qword expected = 0;
+        if (global_atomic_qword(set[slot]).compare_exchange_strong(expected, fingerprint)) {
+            return;
+        }
+        if (expected == fingerprint) {
+            estimates[thread] = 0;
+            return;
+        }
+    }
+}
+
+template<hash::method M>
+static inline sycl::event submit_cms_add(sycl::queue &q, sycl::event e, const byte *indata, dword inlen, dword n_batch, qword seed, dword width, dword depth, dword *counters) {
+    auto config = hash::internal::get_kernel_sizes(q, n_batch);
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        cgh.parallel_for<hash::internal::cms_add_kernel<M>>(
+                sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                [=](sycl::nd_item<1> item) {
+                    kernel_cms_add<M>(indata, inlen, n_batch, seed, width, depth, counters, item.get_global_linear_id());
+                });
+    });
+}
+
+template<hash::method M>
+static inline sycl::event
+submit_cms_estimate(sycl::queue &q, sycl::event e, const byte *indata, dword inlen, dword n_batch, qword seed, dword width, dword depth, const dword *counters, dword *estimates) {
+    auto config = hash::internal::get_kernel_sizes(q, n_batch);
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        cgh.parallel_for<hash::internal::cms_estimate_kernel<M>>(
+                sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                [=](sycl::nd_item<1> item) {
+                    kernel_cms_estimate<M>(indata, inlen, n_batch, seed, width, depth, counters, estimates, item.get_global_linear_id());
+                });
+    });
+}
+
+template<hash::method M>
+static inline sycl::event submit_cms_distinct(sycl::queue &q, sycl::event e, const byte *indata, dword inlen, dword n_batch, qword seed, qword *set, qword set_size, dword *estimates) {
+    auto config = hash::internal::get_kernel_sizes(q, n_batch);
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        cgh.parallel_for<hash::internal::cms_distinct_kernel<M>>(
+                sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                [=](sycl::nd_item<1> item) {
+                    kernel_cms_distinct<M>(indata, inlen, n_batch, seed, set, set_size, estimates, item.get_global_linear_id());
+                });
+    });
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_cms_add_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, dword width, dword depth,
+                          device_accessible_ptr<dword> counters) {
+        switch (sketch_method) {
+            case method::xxhash64:
+                return submit_cms_add<method::xxhash64>(q, std::move(e), indata, inlen, n_batch, seed, width, depth, counters);
+            case method::xxh3:
+                return submit_cms_add<method::xxh3>(q, std::move(e), indata, inlen, n_batch, seed, width, depth, counters);
+            case method::murmur3:
+                return submit_cms_add<method::murmur3>(q, std::move(e), indata, inlen, n_batch, seed, width, depth, counters);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+    sycl::event
+    launch_cms_estimate_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, dword width, dword depth,
+                               device_accessible_ptr<dword> counters, device_accessible_ptr<dword> estimates) {
+        switch (sketch_method) {
+            case method::xxhash64:
+                return submit_cms_estimate<method::xxhash64>(q, std::move(e), indata, inlen, n_batch, seed, width, depth, counters, estimates);
+            case method::xxh3:
+                return submit_cms_estimate<method::xxh3>(q, std::move(e), indata, inlen, n_batch, seed, width, depth, counters, estimates);
+            case method::murmur3:
+                return submit_cms_estimate<method::murmur3>(q, std::move(e), indata, inlen, n_batch, seed, width, depth, counters, estimates);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+    sycl::event
+    launch_cms_distinct_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, device_accessible_ptr<qword> set,
+                               qword set_size, device_accessible_ptr<dword> estimates) {
+        switch (sketch_method) {
+            case method::xxhash64:
+                return submit_cms_distinct<method::xxhash64>(q, std::move(e), indata, inlen, n_batch, seed, set, set_size, estimates);
+            case method::xxh3:
+                return submit_cms_distinct<method::xxh3>(q, std::move(e), indata, inlen, n_batch, seed, set, set_size, estimates);
+            case method::murmur3:
+                return submit_cms_distinct<method::murmur3>(q, std::move(e), indata, inlen, n_batch, seed, set, set_size, estimates);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+    sycl::event
+    launch_cms_count_above_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> estimates, dword n_batch, dword threshold, device_accessible_ptr<dword> count) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<cms_count_above_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n_batch && ((dword *) estimates)[i] >= threshold) {
+                            global_atomic_dword(*(dword *) count).fetch_add(1);
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_cms_select_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> estimates, dword n_batch, dword threshold, dword n_above, dword capacity,
+                             device_accessible_ptr<heavy_hitter> out, device_accessible_ptr<dword> counts) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<cms_select_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        auto i = (dword) item.get_global_linear_id();
+                        if (i >= n_batch) {
+                            return;
+                        }
+                        dword estimate = ((dword *) estimates)[i];
+                        if (estimate > threshold) {
+                            dword slot = global_atomic_dword(((dword *) counts)[0]).fetch_add(1);
+                            ((heavy_hitter *) out)[slot] = {i, estimate};
+                        } else if (estimate == threshold) {
+                            dword slot = n_above + global_atomic_dword(((dword *) counts)[1]).fetch_add(1);
+                            if (slot < capacity) {
+                                ((heavy_hitter *) out)[slot] = {i, estimate};
+                            }
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_cms_accumulate_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> dst, device_accessible_ptr<dword> src, size_t n) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<cms_accumulate_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n) {
+                            dword sum = ((dword *) dst)[i] + ((dword *) src)[i];
+                            ((dword *) dst)[i] = sum < ((dword *) src)[i] ? ~0u : sum;
+                        }
+                    });
+        });
+    }
+
+}
@@ -0,0 +1,101 @@
+#include <sketches/digest_index.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "digest_words.hpp"
+
+using namespace usm_smart_ptr;
+
+using global_atomic_dword = sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+using global_atomic_qword = sycl::atomic_ref<qword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+
+/**
+ * Fingerprint of a digest, never 0 as 0 marks the empty slots.
+ */
+static inline qword index_fingerprint(const byte *digest, dword digest_size) {
+    qword fingerprint = digest_word(digest, digest_size);
+    return fingerprint ? fingerprint : 1;
+}
+
+/**
+ * Inserts a fingerprint, returns whether it was absent. Short digests do not spread over the table by themselves, so
+ * the first slot comes from the mixed fingerprint.
+ */
+static inline bool index_insert(qword *slots, qword capacity, qword fingerprint) {
+    for (qword slot = sketch_mix64(fingerprint) & (capacity - 1);; slot = (slot + 1) & (capacity - 1)) {
+        qword expected = 0;
+        if (global_atomic_qword(slots[slot]).compare_exchange_strong(expected, fingerprint)) {
+            return true;
+        }
+        if (expected == fingerprint) {
+            return false;
+        }
+    }
+}
+
+static inline bool index_contains(const qword *slots, qword capacity, qword fingerprint) {
+    for (qword slot = sketch_mix64(fingerprint) & (capacity - 1);; slot = (slot + 1) & (capacity - 1)) {
+        if (slots[slot] == fingerprint) {
+            return true;
+        }
+        if (slots[slot] == 0) {
+            return false;
+        }
+    }
+}
+
+static inline void index_append(dword *out, dword *out_count, dword index) {
+    out[global_atomic_dword(*out_count).fetch_add(1)] = index;
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_digest_index_insert_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword first, dword n, device_accessible_ptr<qword> slots,
+                                      qword capacity, device_accessible_ptr<dword> out, device_accessible_ptr<dword> out_count) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<digest_index_insert_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n && index_insert(slots, capacity, index_fingerprint((byte *) digests + i * digest_size, digest_size))) {
+                            index_append(out, out_count, (dword) (first + i));
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_digest_index_lookup_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> digests, dword digest_size, dword first, dword n, device_accessible_ptr<qword> slots,
+                                      qword capacity, device_accessible_ptr<dword> out, device_accessible_ptr<dword> out_count) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<digest_index_lookup_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n && !index_contains(slots, capacity, index_fingerprint((byte *) digests + i * digest_size, digest_size))) {
+                            index_append(out, out_count, (dword) (first + i));
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_digest_index_rehash_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> slots, qword capacity, device_accessible_ptr<qword> new_slots, qword new_capacity) {
+        auto config = get_kernel_sizes(q, capacity);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<digest_index_rehash_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < capacity && ((qword *) slots)[i]) {
+                            index_insert(new_slots, new_capacity, ((qword *) slots)[i]);
+                        }
+                    });
+        });
+    }
+
+}
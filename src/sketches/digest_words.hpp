@@ -0,0 +1,42 @@
+/**
+ * Turns digests of any size into the 64-bit words the sketches index with.
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+
+/**
+ * SplitMix64 finaliser, a bijection so it does not add collisions.
+ */
+static inline qword sketch_mix64(qword x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111eb;
+    x ^= x >> 31;
+    return x;
+}
+
+/**
+ * Little endian word made of the first (at most 8) bytes of a digest.
+ */
+static inline qword digest_word(const byte *digest, dword digest_size, dword offset = 0) {
+    qword w = 0;
+    for (dword i = 0; i < 8 && offset + i < digest_size; ++i) {
+        w |= (qword) digest[offset + i] << (8 * i);
+    }
+    return w;
+}
+
+/**
+ * The two words of the double hashing scheme: `h1 + i * h2` gives the i-th index.
+ * Digests shorter than 16 bytes derive `h2` from `h1`. `h2` is odd so the indices never cycle early in a power of two table.
+ */
+static inline void digest_to_pair(const byte *digest, dword digest_size, qword &h1, qword &h2) {
+    h1 = digest_word(digest, digest_size);
+    h2 = digest_size >= 16 ? digest_word(digest, digest_size, 8) : sketch_mix64(h1);
+    h2 |= 1;
+}
@@ -0,0 +1,206 @@
+#include <sketches/duplicates.hpp>
+#include <internal/determine_kernel_config.hpp>
+
+using namespace usm_smart_ptr;
+
+using global_atomic_dword = sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+
+static inline sycl::nd_range<1> radix_range(sycl::queue &q, dword n) {
+    auto config = hash::internal::get_kernel_sizes(q, std::min<size_t>(n, hash::internal::RADIX_MAX_THREADS));
+    return {sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)};
+}
+
+static inline bool same_digest(const byte *a, const byte *b, dword digest_size) {
+    for (dword i = 0; i < digest_size; ++i) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline bool is_run_head(const qword *keys, size_t i) {
+    return i == 0 || keys[i] != keys[i - 1];
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_dedup_keys_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> chunk, dword digest_size, dword first, dword n, device_accessible_ptr<byte> digests,
+                             device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<dedup_keys_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i >= n) {
+                            return;
+                        }
+                        const byte *digest = (byte *) chunk + i * digest_size;
+                        byte *dst = (byte *) digests + (first + i) * digest_size;
+                        qword key = 0;
+                        for (dword b = 0; b < digest_size; ++b) {
+                            dst[b] = digest[b];
+                            if (b < 8) {
+                                key |= (qword) digest[b] << (56 - 8 * b);
+                            }
+                        }
+                        ((qword *) keys)[first + i] = key;
+                        ((dword *) values)[first + i] = (dword) (first + i);
+                    });
+        });
+    }
+
+    dword get_radix_threads(sycl::queue &q, dword n) {
+        return (dword) radix_range(q, n).get_global_range()[0];
+    }
+
+    sycl::event launch_radix_histogram_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, dword n, dword shift, device_accessible_ptr<qword> counts) {
+        auto range = radix_range(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<radix_histogram_kernel>(range, [=](sycl::nd_item<1> item) {
+                const size_t n_threads = item.get_global_range(0);
+                const size_t t = item.get_global_linear_id();
+                const size_t segment = (n + n_threads - 1) / n_threads;
+                auto *column = (qword *) counts + t;
+                for (dword d = 0; d < RADIX_BUCKETS; ++d) {
+                    column[d * n_threads] = 0;
+                }
+                for (size_t i = t * segment; i < n && i < (t + 1) * segment; ++i) {
+                    column[((((qword *) keys)[i] >> shift) % RADIX_BUCKETS) * n_threads]++;
+                }
+            });
+        });
+    }
+
+    sycl::event
+    launch_radix_scatter_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values, dword n, dword shift, device_accessible_ptr<qword> counts,
+                                device_accessible_ptr<qword> out_keys, device_accessible_ptr<dword> out_values) {
+        auto range = radix_range(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<radix_scatter_kernel>(range, [=](sycl::nd_item<1> item) {
+                const size_t n_threads = item.get_global_range(0);
+                const size_t t = item.get_global_linear_id();
+                const size_t segment = (n + n_threads - 1) / n_threads;
+                auto *column = (qword *) counts + t;
+                for (size_t i = t * segment; i < n && i < (t + 1) * segment; ++i) {
+                    qword key = ((qword *) keys)[i];
+                    qword slot = column[((key >> shift) % RADIX_BUCKETS) * n_threads]++;
+                    ((qword *) out_keys)[slot] = key;
+                    ((dword *) out_values)[slot] = ((dword *) values)[i];
+                }
+            });
+        });
+    }
+
+    sycl::event launch_dedup_run_heads_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, dword n, device_accessible_ptr<qword> heads) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<dedup_run_heads_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n) {
+                            ((qword *) heads)[i] = is_run_head(keys, i);
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_dedup_run_starts_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, dword n, device_accessible_ptr<qword> run_ids, device_accessible_ptr<dword> run_starts) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<dedup_run_starts_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n && is_run_head(keys, i)) {
+                            ((dword *) run_starts)[((qword *) run_ids)[i]] = (dword) i;
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_dedup_leaders_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> keys, device_accessible_ptr<dword> values, dword n, device_accessible_ptr<qword> run_ids,
+                                device_accessible_ptr<dword> run_starts, device_accessible_ptr<byte> digests, dword digest_size, device_accessible_ptr<dword> leaders,
+                                device_accessible_ptr<dword> sizes) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<dedup_leaders_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i >= n) {
+                            return;
+                        }
+                        /* The exclusive scan of the heads counts the runs before `i` */
+                        qword run = ((qword *) run_ids)[i] - !is_run_head(keys, i);
+                        const byte *digest = (byte *) digests + (qword) ((dword *) values)[i] * digest_size;
+                        dword leader = ((dword *) run_starts)[run];
+                        while (leader < i && !same_digest((byte *) digests + (qword) ((dword *) values)[leader] * digest_size, digest, digest_size)) {
+                            ++leader;
+                        }
+                        ((dword *) leaders)[i] = leader;
+                        global_atomic_dword(((dword *) sizes)[leader]).fetch_add(1);
+                    });
+        });
+    }
+
+    sycl::event
+    launch_dedup_group_sizes_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> leaders, device_accessible_ptr<dword> sizes, dword n, device_accessible_ptr<qword> members,
+                                    device_accessible_ptr<qword> groups) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<dedup_group_sizes_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i >= n) {
+                            return;
+                        }
+                        bool has_duplicates = ((dword *) leaders)[i] == i && ((dword *) sizes)[i] >= 2;
+                        ((qword *) members)[i] = has_duplicates ? ((dword *) sizes)[i] : 0;
+                        ((qword *) groups)[i] = has_duplicates;
+                    });
+        });
+    }
+
+    sycl::event
+    launch_dedup_emit_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> values, device_accessible_ptr<dword> leaders, device_accessible_ptr<dword> sizes, dword n,
+                             device_accessible_ptr<qword> members, device_accessible_ptr<qword> groups, device_accessible_ptr<dword> cursors, device_accessible_ptr<dword> indices,
+                             device_accessible_ptr<qword> group_offsets) {
+        auto config = get_kernel_sizes(q, n);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<dedup_emit_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i >= n) {
+                            return;
+                        }
+                        dword leader = ((dword *) leaders)[i];
+                        if (((dword *) sizes)[leader] < 2) {
+                            return;
+                        }
+                        qword first = ((qword *) members)[leader];
+                        qword slot = first + global_atomic_dword(((dword *) cursors)[leader]).fetch_add(1);
+                        ((dword *) indices)[slot] = ((dword *) values)[i];
+                        if (leader == i) {
+                            ((qword *) group_offsets)[((qword *) groups)[leader]] = first;
+                        }
+                    });
+        });
+    }
+
+}
@@ -0,0 +1,93 @@
+#include <sketches/hyperloglog.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "sketch_hash.hpp"
+
+using namespace usm_smart_ptr;
+
+constexpr size_t HLL_GROUPS_PER_COMPUTE_UNIT = 4; // Each work-group merges all its registers, so there are few of them
+
+/**
+ * Register index and rank (position of the first set bit after the index bits) of an item.
+ */
+template<hash::method M>
+static inline void hll_update(const byte *item, dword inlen, qword seed, dword precision, dword &index, dword &rank) {
+    qword h = sketch_hash<M>(item, inlen, seed);
+    qword w = h << precision;
+    index = (dword) (h >> (64 - precision));
+    rank = w ? (dword) sycl::clz(w) + 1 : 64 - precision + 1;
+}
+
+template<hash::method M>
+static inline sycl::event submit_hll(sycl::queue &q, sycl::event e, const byte *indata, dword inlen, dword n_batch, qword seed, dword precision, dword *registers) {
+    const dword n_registers = 1u << precision;
+    auto config = hash::internal::get_kernel_sizes(q, n_batch);
+    size_t n_groups = std::min<size_t>(config.block, HLL_GROUPS_PER_COMPUTE_UNIT * q.get_device().get_info<sycl::info::device::max_compute_units>());
+    sycl::nd_range<1> range(sycl::range<1>(n_groups) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size));
+    const bool use_local = n_registers * sizeof(dword) <= q.get_device().get_info<sycl::info::device::local_mem_size>();
+
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        if (use_local) {
+            local_accessor<dword, 1> local_registers(sycl::range<1>(n_registers), cgh);
+            cgh.parallel_for<hash::internal::hll_local_kernel<M>>(range, [=](sycl::nd_item<1> item) {
+                for (size_t r = item.get_local_linear_id(); r < n_registers; r += item.get_local_range(0)) {
+                    local_registers[r] = 0;
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+                for (qword i = item.get_global_linear_id(); i < n_batch; i += item.get_global_range(0)) {
+                    dword index, rank;
+                    hll_update<M>(indata + i * inlen, inlen, seed, precision, index, rank);
+                    sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::work_group, sycl::access::address_space::local_space>(local_registers[index]).fetch_max(rank);
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+                for (size_t r = item.get_local_linear_id(); r < n_registers; r += item.get_local_range(0)) {
+                    if (local_registers[r]) {
+                        sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>(registers[r]).fetch_max(local_registers[r]);
+                    }
+                }
+            });
+        } else {
+            cgh.parallel_for<hash::internal::hll_global_kernel<M>>(range, [=](sycl::nd_item<1> item) {
+                for (qword i = item.get_global_linear_id(); i < n_batch; i += item.get_global_range(0)) {
+                    dword index, rank;
+                    hll_update<M>(indata + i * inlen, inlen, seed, precision, index, rank);
+                    sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>(registers[index]).fetch_max(rank);
+                }
+            });
+        }
+    });
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_hll_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, dword inlen, dword n_batch, qword seed, dword precision,
+                      device_accessible_ptr<dword> registers) {
+        switch (sketch_method) {
+            case method::xxhash64:
+                return submit_hll<method::xxhash64>(q, std::move(e), indata, inlen, n_batch, seed, precision, registers);
+            case method::xxh3:
+                return submit_hll<method::xxh3>(q, std::move(e), indata, inlen, n_batch, seed, precision, registers);
+            case method::murmur3:
+                return submit_hll<method::murmur3>(q, std::move(e), indata, inlen, n_batch, seed, precision, registers);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+    sycl::event launch_hll_pack_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> registers, dword n_registers, device_accessible_ptr<byte> packed) {
+        auto config = get_kernel_sizes(q, n_registers);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<hll_pack_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t r = item.get_global_linear_id();
+                        if (r < n_registers) {
+                            ((byte *) packed)[r] = (byte) ((dword *) registers)[r];
+                        }
+                    });
+        });
+    }
+
+}
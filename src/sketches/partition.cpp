@@ -0,0 +1,180 @@
+#include <sketches/partition.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "sketch_hash.hpp"
+
+using namespace usm_smart_ptr;
+
+constexpr size_t PARTITION_GROUPS_PER_COMPUTE_UNIT = 4; // Each work-group has a column of counters in the histogram
+
+using local_atomic_dword = sycl::atomic_ref<dword, sycl::memory_order::relaxed, sycl::memory_scope::work_group, sycl::access::address_space::local_space>;
+using global_atomic_qword = sycl::atomic_ref<qword, sycl::memory_order::relaxed, sycl::memory_scope::device, sycl::access::address_space::global_space>;
+
+/**
+ * Range of the histogram and scatter kernels: record `i` is handled by the work-item `i % global_range`.
+ */
+static inline sycl::nd_range<1> partition_range(sycl::queue &q, dword n_batch) {
+    auto config = hash::internal::get_kernel_sizes(q, n_batch);
+    size_t n_groups = std::min<size_t>(config.block, PARTITION_GROUPS_PER_COMPUTE_UNIT * q.get_device().get_info<sycl::info::device::max_compute_units>());
+    return {sycl::range<1>(n_groups) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)};
+}
+
+static inline bool partition_fits_local(sycl::queue &q, dword n_partitions, size_t bytes_per_partition) {
+    return n_partitions * bytes_per_partition <= q.get_device().get_info<sycl::info::device::local_mem_size>();
+}
+
+template<hash::method M>
+static inline dword partition_of(const byte *indata, const qword *offsets, dword inlen, qword i, qword seed, dword n_partitions) {
+    qword h = offsets ? sketch_hash<M>(indata + offsets[i], (dword) (offsets[i + 1] - offsets[i]), seed)
+                      : sketch_hash<M>(indata + i * inlen, inlen, seed);
+    return (dword) (h % n_partitions);
+}
+
+template<hash::method M>
+static inline sycl::event
+submit_partition_histogram(sycl::queue &q, sycl::event e, const byte *indata, const qword *offsets, dword inlen, dword n_batch, qword seed, dword n_partitions, dword *ids, qword *counts) {
+    auto range = partition_range(q, n_batch);
+    const size_t n_groups = range.get_group_range()[0];
+    const bool use_local = partition_fits_local(q, n_partitions, sizeof(dword));
+
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        if (use_local) {
+            local_accessor<dword, 1> local_counts(sycl::range<1>(n_partitions), cgh);
+            cgh.parallel_for<hash::internal::partition_local_histogram_kernel<M>>(range, [=](sycl::nd_item<1> item) {
+                for (size_t p = item.get_local_linear_id(); p < n_partitions; p += item.get_local_range(0)) {
+                    local_counts[p] = 0;
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+                for (qword i = item.get_global_linear_id(); i < n_batch; i += item.get_global_range(0)) {
+                    dword p = partition_of<M>(indata, offsets, inlen, i, seed, n_partitions);
+                    ids[i] = p;
+                    local_atomic_dword(local_counts[p]).fetch_add(1);
+                }
+                item.barrier(sycl::access::fence_space::local_space);
+                for (size_t p = item.get_local_linear_id(); p < n_partitions; p += item.get_local_range(0)) {
+                    counts[p * n_groups + item.get_group_linear_id()] = local_counts[p];
+                }
+            });
+        } else {
+            cgh.parallel_for<hash::internal::partition_global_histogram_kernel<M>>(range, [=](sycl::nd_item<1> item) {
+                for (qword i = item.get_global_linear_id(); i < n_batch; i += item.get_global_range(0)) {
+                    dword p = partition_of<M>(indata, offsets, inlen, i, seed, n_partitions);
+                    ids[i] = p;
+                    global_atomic_qword(counts[p * n_groups + item.get_group_linear_id()]).fetch_add(1);
+                }
+            });
+        }
+    });
+}
+
+/**
+ * Writes record `i` in the slot `slot` of the output.
+ */
+static inline void partition_place(const byte *indata, dword inlen, byte *records, dword *indices, qword i, qword slot) {
+    if (records) {
+        for (dword b = 0; b < inlen; ++b) {
+            records[slot * inlen + b] = indata[i * inlen + b];
+        }
+    } else {
+        indices[slot] = (dword) i;
+    }
+}
+
+namespace hash::internal {
+
+    dword get_partition_groups(sycl::queue &q, dword n_batch) {
+        return (dword) partition_range(q, n_batch).get_group_range()[0];
+    }
+
+    sycl::event
+    launch_partition_histogram_kernel(sycl::queue &q, sycl::event e, method sketch_method, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> offsets, dword inlen,
+                                      dword n_batch, qword seed, dword n_partitions, device_accessible_ptr<dword> ids, device_accessible_ptr<qword> counts) {
+        switch (sketch_method) {
+            case method::xxhash64:
+                return submit_partition_histogram<method::xxhash64>(q, std::move(e), indata, offsets, inlen, n_batch, seed, n_partitions, ids, counts);
+            case method::xxh3:
+                return submit_partition_histogram<method::xxh3>(q, std::move(e), indata, offsets, inlen, n_batch, seed, n_partitions, ids, counts);
+            case method::murmur3:
+                return submit_partition_histogram<method::murmur3>(q, std::move(e), indata, offsets, inlen, n_batch, seed, n_partitions, ids, counts);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+    sycl::event
+    launch_partition_scatter_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<dword> ids, dword n_batch, dword n_partitions, device_accessible_ptr<qword> counts,
+                                    device_accessible_ptr<byte> indata, dword inlen, device_accessible_ptr<byte> records, device_accessible_ptr<dword> indices) {
+        auto range = partition_range(q, n_batch);
+        const size_t n_groups = range.get_group_range()[0];
+        const bool use_local = partition_fits_local(q, n_partitions, sizeof(qword) + sizeof(dword));
+
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            if (use_local) {
+                local_accessor<qword, 1> local_bases(sycl::range<1>(n_partitions), cgh);
+                local_accessor<dword, 1> local_cursors(sycl::range<1>(n_partitions), cgh);
+                cgh.parallel_for<partition_local_scatter_kernel>(range, [=](sycl::nd_item<1> item) {
+                    for (size_t p = item.get_local_linear_id(); p < n_partitions; p += item.get_local_range(0)) {
+                        local_bases[p] = ((qword *) counts)[p * n_groups + item.get_group_linear_id()];
+                        local_cursors[p] = 0;
+                    }
+                    item.barrier(sycl::access::fence_space::local_space);
+                    for (qword i = item.get_global_linear_id(); i < n_batch; i += item.get_global_range(0)) {
+                        dword p = ((dword *) ids)[i];
+                        qword slot = local_bases[p] + local_atomic_dword(local_cursors[p]).fetch_add(1);
+                        partition_place(indata, inlen, records, indices, i, slot);
+                    }
+                });
+            } else {
+                cgh.parallel_for<partition_global_scatter_kernel>(range, [=](sycl::nd_item<1> item) {
+                    for (qword i = item.get_global_linear_id(); i < n_batch; i += item.get_global_range(0)) {
+                        dword p = ((dword *) ids)[i];
+                        qword slot = global_atomic_qword(((qword *) counts)[p * n_groups + item.get_group_linear_id()]).fetch_add(1);
+                        partition_place(indata, inlen, records, indices, i, slot);
+                    }
+                });
+            }
+        });
+    }
+
+    sycl::event
+    launch_partition_lengths_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> offsets, device_accessible_ptr<dword> indices, dword n_batch, device_accessible_ptr<qword> lengths) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<partition_lengths_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i < n_batch) {
+                            dword record = ((dword *) indices)[i];
+                            ((qword *) lengths)[i] = ((qword *) offsets)[record + 1] - ((qword *) offsets)[record];
+                        }
+                    });
+        });
+    }
+
+    sycl::event
+    launch_partition_gather_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<byte> indata, device_accessible_ptr<qword> offsets, device_accessible_ptr<dword> indices, dword n_batch,
+                                   device_accessible_ptr<byte> out, device_accessible_ptr<qword> out_offsets) {
+        auto config = get_kernel_sizes(q, n_batch);
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            cgh.parallel_for<partition_gather_kernel>(
+                    sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                    [=](sycl::nd_item<1> item) {
+                        size_t i = item.get_global_linear_id();
+                        if (i >= n_batch) {
+                            return;
+                        }
+                        dword record = ((dword *) indices)[i];
+                        const byte *src = (byte *) indata + ((qword *) offsets)[record];
+                        byte *dst = (byte *) out + ((qword *) out_offsets)[i];
+                        for (qword b = 0, len = ((qword *) offsets)[record + 1] - ((qword *) offsets)[record]; b < len; ++b) {
+                            dst[b] = src[b];
+                        }
+                    });
+        });
+    }
+
+}
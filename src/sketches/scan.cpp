@@ -0,0 +1,52 @@
+#include <sketches/scan.hpp>
+
+using namespace usm_smart_ptr;
+
+constexpr size_t SCAN_MAX_WG_SIZE = 256;
+
+namespace hash::internal {
+
+    sycl::event launch_exclusive_scan_kernel(sycl::queue &q, sycl::event e, device_accessible_ptr<qword> values, size_t n, size_t stride, device_accessible_ptr<qword> bounds) {
+        size_t wg_size = std::min<size_t>({SCAN_MAX_WG_SIZE, std::max<size_t>(1, q.get_device().get_info<sycl::info::device::max_work_group_size>()), n});
+        return q.submit([&](sycl::handler &cgh) {
+            cgh.depends_on(e);
+            local_accessor<qword, 1> sums(sycl::range<1>(wg_size), cgh);
+            cgh.parallel_for<exclusive_scan_kernel>(sycl::nd_range<1>(sycl::range<1>(wg_size), sycl::range<1>(wg_size)), [=](sycl::nd_item<1> item) {
+                auto *v = (qword *) values;
+                auto *out = (qword *) bounds;
+                const size_t lid = item.get_local_linear_id();
+                const size_t chunk = (n + wg_size - 1) / wg_size;
+                const size_t begin = lid * chunk < n ? lid * chunk : n;
+                const size_t end = begin + chunk < n ? begin + chunk : n;
+
+                /* Each work-item sums its chunk, then the sums are scanned in local memory */
+                qword sum = 0;
+                for (size_t i = begin; i < end; ++i) {
+                    sum += v[i];
+                }
+                sums[lid] = sum;
+                item.barrier(sycl::access::fence_space::local_space);
+                for (size_t offset = 1; offset < wg_size; offset <<= 1) {
+                    qword previous = lid >= offset ? sums[lid - offset] : 0;
+                    item.barrier(sycl::access::fence_space::local_space);
+                    sums[lid] += previous;
+                    item.barrier(sycl::access::fence_space::local_space);
+                }
+
+                qword running = sums[lid] - sum;
+                for (size_t i = begin; i < end; ++i) {
+                    qword value = v[i];
+                    v[i] = running;
+                    if (i % stride == 0) {
+                        out[i / stride] = running;
+                    }
+                    running += value;
+                }
+                if (lid == wg_size - 1) {
+                    out[n / stride] = sums[lid];
+                }
+            });
+        });
+    }
+
+}
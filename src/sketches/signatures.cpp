@@ -0,0 +1,106 @@
+#include <sketches/signatures.hpp>
+#include <internal/determine_kernel_config.hpp>
+#include "sketch_hash.hpp"
+
+using namespace usm_smart_ptr;
+
+template<hash::method M>
+static inline void kernel_minhash(const byte *data, const qword *offsets, dword n_docs, dword shingle_len, qword seed, dword k, qword *signatures, dword thread) {
+    if (thread >= n_docs) {
+        return;
+    }
+    qword *signature = signatures + (qword) thread * k;
+    for (dword i = 0; i < k; ++i) {
+        signature[i] = ~0ull;
+    }
+    for_each_shingle(data + offsets[thread], offsets[thread + 1] - offsets[thread], shingle_len, [&](const byte *shingle, dword len) {
+        qword h = sketch_hash<M>(shingle, len, seed);
+        for (dword i = 0; i < k; ++i) {
+            qword v = hash::minhash_permutation(h, i);
+            if (v < signature[i]) {
+                signature[i] = v;
+            }
+        }
+    });
+}
+
+template<hash::method M>
+static inline void kernel_simhash(const byte *data, const qword *offsets, dword n_docs, dword shingle_len, qword seed, qword *signatures, dword thread) {
+    if (thread >= n_docs) {
+        return;
+    }
+    int votes[64] = {0};
+    for_each_shingle(data + offsets[thread], offsets[thread + 1] - offsets[thread], shingle_len, [&](const byte *shingle, dword len) {
+        qword h = sketch_hash<M>(shingle, len, seed);
+#pragma unroll
+        for (dword b = 0; b < 64; ++b) {
+            votes[b] += (h >> b) & 1 ? 1 : -1;
+        }
+    });
+    qword signature = 0;
+#pragma unroll
+    for (dword b = 0; b < 64; ++b) {
+        signature |= (qword) (votes[b] > 0) << b;
+    }
+    signatures[thread] = signature;
+}
+
+template<hash::method M>
+static inline sycl::event submit_minhash(sycl::queue &q, sycl::event e, const byte *data, const qword *offsets, dword n_docs, dword shingle_len, qword seed, dword k, qword *signatures) {
+    auto config = hash::internal::get_kernel_sizes(q, n_docs);
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        cgh.parallel_for<hash::internal::minhash_kernel<M>>(
+                sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                [=](sycl::nd_item<1> item) {
+                    kernel_minhash<M>(data, offsets, n_docs, shingle_len, seed, k, signatures, item.get_global_linear_id());
+                });
+    });
+}
+
+template<hash::method M>
+static inline sycl::event submit_simhash(sycl::queue &q, sycl::event e, const byte *data, const qword *offsets, dword n_docs, dword shingle_len, qword seed, qword *signatures) {
+    auto config = hash::internal::get_kernel_sizes(q, n_docs);
+    return q.submit([&](sycl::handler &cgh) {
+        cgh.depends_on(e);
+        cgh.parallel_for<hash::internal::simhash_kernel<M>>(
+                sycl::nd_range<1>(sycl::range<1>(config.block) * sycl::range<1>(config.wg_size), sycl::range<1>(config.wg_size)),
+                [=](sycl::nd_item<1> item) {
+                    kernel_simhash<M>(data, offsets, n_docs, shingle_len, seed, signatures, item.get_global_linear_id());
+                });
+    });
+}
+
+namespace hash::internal {
+
+    sycl::event
+    launch_minhash_kernel(sycl::queue &q, sycl::event e, method shingle_method, device_accessible_ptr<byte> data, device_accessible_ptr<qword> offsets, dword n_docs, dword shingle_len, qword seed,
+                          dword k, device_accessible_ptr<qword> signatures) {
+        switch (shingle_method) {
+            case method::xxhash64:
+                return submit_minhash<method::xxhash64>(q, std::move(e), data, offsets, n_docs, shingle_len, seed, k, signatures);
+            case method::xxh3:
+                return submit_minhash<method::xxh3>(q, std::move(e), data, offsets, n_docs, shingle_len, seed, k, signatures);
+            case method::murmur3:
+                return submit_minhash<method::murmur3>(q, std::move(e), data, offsets, n_docs, shingle_len, seed, k, signatures);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+    sycl::event
+    launch_simhash_kernel(sycl::queue &q, sycl::event e, method shingle_method, device_accessible_ptr<byte> data, device_accessible_ptr<qword> offsets, dword n_docs, dword shingle_len, qword seed,
+                          device_accessible_ptr<qword> signatures) {
+        switch (shingle_method) {
+            case method::xxhash64:
+                return submit_simhash<method::xxhash64>(q, std::move(e), data, offsets, n_docs, shingle_len, seed, signatures);
+            case method::xxh3:
+                return submit_simhash<method::xxh3>(q, std::move(e), data, offsets, n_docs, shingle_len, seed, signatures);
+            case method::murmur3:
+                return submit_simhash<method::murmur3>(q, std::move(e), data, offsets, n_docs, shingle_len, seed, signatures);
+            default:
+                throw_not_sketch_method();
+        }
+    }
+
+}
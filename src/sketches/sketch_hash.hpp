@@ -0,0 +1,53 @@
+/**
+ * 64-bit hash of an item or a shingle with one of the methods allowed by `hash::is_sketch_method`, computed by the
+ * device cores.
+ */
+
+#pragma once
+
+#include <internal/config.hpp>
+#include "../hash_functions/cores/xxhash.hpp"
+#include "../hash_functions/cores/murmur3.hpp"
+
+#include <stdexcept>
+
+/*********************** FUNCTION DEFINITIONS ***********************/
+/**
+ * `murmur3` takes a 32-bit seed: only the low 32 bits of `seed` are used.
+ */
+template<hash::method M>
+static inline qword sketch_hash(const byte *item, dword len, qword seed) {
+    if constexpr (M == hash::method::xxhash64) {
+        return xxh64(item, len, seed);
+    } else if constexpr (M == hash::method::xxh3) {
+        return xxh3_64(item, len, seed);
+    } else {
+        static_assert(M == hash::method::murmur3);
+        qword h[2];
+        murmur3_x64_128(item, len, (dword) seed, h);
+        return h[0];
+    }
+}
+
+/**
+ * Thrown by the launchers of the sketch kernels for a method `hash::is_sketch_method` refuses.
+ */
+[[noreturn]] static inline void throw_not_sketch_method() {
+    throw std::invalid_argument("sketch: the method cannot be run by the sketch kernels, see is_sketch_method");
+}
+
+/**
+ * Calls `f(shingle, shingle_len)` for each shingle of a document, see `hash::ragged_documents`. `shingle_len` is not 0.
+ */
+template<typename Func>
+static inline void for_each_shingle(const byte *doc, qword doc_len, dword shingle_len, Func &&f) {
+    if (doc_len <= shingle_len) {
+        if (doc_len) {
+            f(doc, (dword) doc_len);
+        }
+        return;
+    }
+    for (qword i = 0; i + shingle_len <= doc_len; ++i) {
+        f(doc + i, shingle_len);
+    }
+}
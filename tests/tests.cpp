@@ -5,10 +5,68 @@
 #include <sycl_hash.hpp>
 #include "tests_helpers.hpp"
 #include <gtest/gtest.h>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <random>
+#include <set>
 
 constexpr size_t loop_count = 101;
 
 
+/**
+ * The digests returned through the pinned rings match the ones copied back, over more calls than there are slots,
+ * and a call finding every slot held by a handle that was not waited for throws.
+ */
+template<size_t digest_size, typename Hasher>
+void check_pinned_output(Hasher &hasher, const byte *data, size_t in_len, const byte *expected, size_t n_blocks) {
+    std::vector<byte> out(digest_size * n_blocks);
+    hasher.enable_pinned_output(2, (dword) n_blocks);
+    for (int call = 0; call < 3; ++call) {
+        std::fill(out.begin(), out.end(), 0);
+        hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, [&](dword first, const byte *digests, dword count) {
+            std::memcpy(out.data() + first * digest_size, digests, count * digest_size);
+        }).wait();
+        ASSERT_TRUE(!memcmp(out.data(), expected, out.size()));
+    }
+
+    /* Both slots held by handles that were not waited for yet */
+    auto ignore = [](dword, const byte *, dword) {};
+    auto first = hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, ignore);
+    auto second = hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, ignore);
+    ASSERT_THROW(hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, ignore), std::logic_error);
+    first.wait();
+    second.wait();
+    hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, ignore).wait();
+
+    /* The rings are replaced while a handle still writes into the old ones */
+    std::fill(out.begin(), out.end(), 0);
+    auto copy = [&](dword first, const byte *digests, dword count) { std::memcpy(out.data() + first * digest_size, digests, count * digest_size); };
+    auto pending = hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, copy);
+    hasher.enable_pinned_output(2, (dword) n_blocks);
+    pending.wait();
+    ASSERT_TRUE(!memcmp(out.data(), expected, out.size()));
+}
+
+/**
+ * A handle waited for after its hasher was destroyed still gets the digests.
+ */
+template<size_t digest_size, typename MakeHasher>
+void check_pinned_outlives_hasher(MakeHasher make_hasher, const byte *data, size_t in_len, const byte *expected, size_t n_blocks) {
+    std::vector<byte> out(digest_size * n_blocks);
+    hash::pinned_handle pending;
+    {
+        auto hasher = make_hasher();
+        hasher.enable_pinned_output(1, (dword) n_blocks);
+        pending = hasher.hash_pinned(data, (dword) in_len, (dword) n_blocks, [&](dword first, const byte *digests, dword count) {
+            std::memcpy(out.data() + first * digest_size, digests, count * digest_size);
+        });
+    }
+    pending.wait();
+    ASSERT_TRUE(!memcmp(out.data(), expected, out.size()));
+}
+
 template<hash::method M, int ... args>
 void run_test(hash::runners &q, byte *input, size_t in_len, byte *expected_hash, size_t n_blocks, const byte *key = nullptr, qword keylen = 0) {
     byte *all_out = (byte *) malloc(hash::get_block_size<M, args...>() * n_blocks);
@@ -17,9 +75,13 @@ void run_test(hash::runners &q, byte *input, size_t in_len, byte *expected_hash,
     if constexpr(M == hash::method::blake2b) {
         hash::hasher<M, args...> hasher(q, key, keylen);
         hasher.hash(all_data, in_len, all_out, n_blocks).wait();
+        check_pinned_output<hash::get_block_size<M, args...>()>(hasher, all_data, in_len, all_out, n_blocks);
+        check_pinned_outlives_hasher<hash::get_block_size<M, args...>()>([&]() { return hash::hasher<M, args...>(q, key, keylen); }, all_data, in_len, all_out, n_blocks);
     } else {
         hash::hasher<M, args...> hasher(q);
         hasher.hash(all_data, in_len, all_out, n_blocks).wait();
+        check_pinned_output<hash::get_block_size<M, args...>()>(hasher, all_data, in_len, all_out, n_blocks);
+        check_pinned_outlives_hasher<hash::get_block_size<M, args...>()>([&]() { return hash::hasher<M, args...>(q); }, all_data, in_len, all_out, n_blocks);
     }
 
     for (size_t i = 0; i < n_blocks; ++i) {
@@ -29,6 +91,174 @@ void run_test(hash::runners &q, byte *input, size_t in_len, byte *expected_hash,
     free(all_data);
 }
 
+template<hash::method M>
+void run_seeded_test(hash::runners &q, byte *input, size_t in_len, byte *expected_hash, size_t n_blocks, qword seed) {
+    byte *all_out = (byte *) malloc(hash::get_block_size<M>() * n_blocks);
+    byte *all_data = (byte *) malloc(in_len * n_blocks);
+    duplicate(input, all_data, in_len, n_blocks);
+    hash::hasher<M> hasher(q);
+    hasher.hash(all_data, in_len, all_out, n_blocks, seed).wait();
+
+    for (size_t i = 0; i < n_blocks; ++i) {
+        ASSERT_TRUE(!memcmp(expected_hash, all_out + hash::get_block_size<M>() * i, hash::get_block_size<M>()));
+    }
+    free(all_out);
+    free(all_data);
+}
+
+template<hash::method M>
+void run_keyed_test(hash::runners &q, byte *input, size_t in_len, byte *expected_hash, size_t n_blocks, const byte *key, dword n_buckets, dword expected_bucket) {
+    std::vector<byte> all_out(hash::get_block_size<M>() * n_blocks);
+    std::vector<byte> all_data(in_len * n_blocks);
+    duplicate(input, all_data.data(), in_len, n_blocks);
+    hash::hasher<M> hasher(q);
+    hasher.hash(all_data.data(), in_len, all_out.data(), n_blocks, key, hash::get_key_size<M>()).wait();
+    for (size_t i = 0; i < n_blocks; ++i) {
+        ASSERT_TRUE(!memcmp(expected_hash, all_out.data() + hash::get_block_size<M>() * i, hash::get_block_size<M>()));
+    }
+
+    for (auto &runner: q) {
+        std::vector<dword> buckets(n_blocks);
+        hash::compute_buckets<M>(runner.q, all_data.data(), in_len, buckets.data(), n_blocks, key, hash::get_key_size<M>(), n_buckets);
+        for (size_t i = 0; i < n_blocks; ++i) {
+            ASSERT_EQ(buckets[i], expected_bucket);
+        }
+    }
+}
+
+/**
+ * Vectors of the SipHash reference implementation: the key is 00 01 .. 0f (00 .. 07 for HalfSipHash) and the
+ * message of length n is 00 01 .. n-1. The bucket ids are the little endian digests modulo 1000.
+ */
+void siphash_test(hash::runners &q, size_t count) {
+    byte key[SIPHASH_KEY_SIZE];
+    byte message[63];
+    for (dword i = 0; i < sizeof(key); ++i) {
+        key[i] = (byte) i;
+    }
+    for (dword i = 0; i < sizeof(message); ++i) {
+        message[i] = (byte) i;
+    }
+    constexpr dword n_buckets = 1000;
+
+    constexpr size_t siphash_lengths[] = {0, 7, 8, 15, 63};
+    byte siphash_hashes[5][SIPHASH_BLOCK_SIZE] = {
+            {0x31, 0x0e, 0x0e, 0xdd, 0x47, 0xdb, 0x6f, 0x72},
+            {0x37, 0xd1, 0x01, 0x8b, 0xf5, 0x00, 0x02, 0xab},
+            {0x62, 0x24, 0x93, 0x9a, 0x79, 0xf5, 0xf5, 0x93},
+            {0xe5, 0x45, 0xbe, 0x49, 0x61, 0xca, 0x29, 0xa1},
+            {0x72, 0x45, 0x06, 0xeb, 0x4c, 0x32, 0x8a, 0x95}};
+    dword siphash_buckets[5] = {353, 7, 618, 557, 42};
+    for (size_t i = 0; i < std::size(siphash_lengths); ++i) {
+        run_keyed_test<hash::method::siphash>(q, message, siphash_lengths[i], siphash_hashes[i], count, key, n_buckets, siphash_buckets[i]);
+    }
+
+    constexpr size_t halfsiphash_lengths[] = {0, 1, 3, 4, 63};
+    byte halfsiphash_hashes[5][HALFSIPHASH_BLOCK_SIZE] = {
+            {0xa9, 0x35, 0x9f, 0x5b},
+            {0x27, 0x47, 0x5a, 0xb8},
+            {0x8a, 0xfe, 0xe7, 0x04},
+            {0x2a, 0x6e, 0x46, 0x89},
+            {0x59, 0xea, 0x4a, 0x74}};
+    dword halfsiphash_buckets[5] = {617, 199, 842, 314, 713};
+    for (size_t i = 0; i < std::size(halfsiphash_lengths); ++i) {
+        run_keyed_test<hash::method::halfsiphash>(q, message, halfsiphash_lengths[i], halfsiphash_hashes[i], count, key, n_buckets, halfsiphash_buckets[i]);
+    }
+
+    byte digest[SIPHASH_BLOCK_SIZE];
+    for (auto &runner: q) {
+        ASSERT_THROW(hash::compute<hash::method::siphash>(runner.q, message, 8, digest, 1, nullptr, SIPHASH_KEY_SIZE), std::invalid_argument);
+        ASSERT_THROW(hash::compute<hash::method::siphash>(runner.q, message, 8, digest, 1, key, HALFSIPHASH_KEY_SIZE), std::invalid_argument);
+        ASSERT_THROW(hash::compute<hash::method::halfsiphash>(runner.q, message, 8, digest, 1, key, SIPHASH_KEY_SIZE), std::invalid_argument);
+    }
+}
+
+/**
+ * Lengths covering every code path of XXH3 (0, 1-3, 4-8, 9-16, 17-128, 129-240 and long inputs), with and without seed.
+ * Expected values are the canonical digests of the reference implementations.
+ */
+void non_cryptographic_test(hash::runners &q, size_t count) {
+    constexpr size_t lengths[] = {0, 3, 6, 12, 20, 100, 200, 1001, 3000};
+    constexpr qword seed = 0x9e3779b97f4a7c15;
+    std::vector<byte> buf(3000);
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = (uint8_t) (i * 7 + 3);
+    }
+    byte xxhash64_hashes[9][XXHASH64_BLOCK_SIZE] = {
+            {0xef, 0x46, 0xdb, 0x37, 0x51, 0xd8, 0xe9, 0x99},
+            {0x31, 0xd2, 0x36, 0x3f, 0x52, 0xe5, 0x64, 0xc9},
+            {0x61, 0x43, 0x6f, 0xb2, 0x8d, 0x5c, 0xe4, 0xc4},
+            {0xd5, 0x2e, 0x40, 0x78, 0x33, 0xaf, 0x51, 0x33},
+            {0x18, 0xae, 0x38, 0x5a, 0xda, 0x6b, 0x00, 0xcb},
+            {0xa6, 0x1f, 0x8d, 0x4c, 0x17, 0x0f, 0xe5, 0x31},
+            {0xa6, 0xcb, 0x3c, 0x09, 0xbc, 0x82, 0x9b, 0x24},
+            {0xa7, 0xa1, 0xc8, 0xc8, 0xa4, 0x4e, 0x70, 0x44},
+            {0x5f, 0x58, 0xb0, 0x24, 0xb3, 0x62, 0x8a, 0x2c}};
+    byte xxhash64_seeded[9][XXHASH64_BLOCK_SIZE] = {
+            {0xc4, 0x34, 0x9f, 0xc9, 0x3c, 0x01, 0x00, 0x00},
+            {0x78, 0xef, 0xd7, 0x75, 0x75, 0xe2, 0x65, 0x75},
+            {0x3d, 0xdb, 0x92, 0x21, 0x0d, 0x49, 0xdf, 0x39},
+            {0xbc, 0xc9, 0xf0, 0xd6, 0x16, 0xff, 0x9a, 0x7b},
+            {0xb9, 0x7d, 0x6d, 0x95, 0x7a, 0x8a, 0x5a, 0x1b},
+            {0xf6, 0xd8, 0xf6, 0x5c, 0x62, 0x5a, 0xbb, 0x4f},
+            {0x17, 0xe5, 0xf0, 0xaa, 0x67, 0x28, 0xf8, 0x59},
+            {0x1f, 0xeb, 0xdb, 0xcd, 0x08, 0x5a, 0x0e, 0x92},
+            {0x0d, 0x13, 0xba, 0xa3, 0xb7, 0xd7, 0x47, 0xd0}};
+    byte xxh3_hashes[9][XXH3_BLOCK_SIZE] = {
+            {0x2d, 0x06, 0x80, 0x05, 0x38, 0xd3, 0x94, 0xc2},
+            {0xa9, 0x08, 0x8d, 0xda, 0x48, 0x5b, 0x48, 0x1c},
+            {0xf9, 0xf1, 0xd9, 0x9e, 0xf1, 0xed, 0xd3, 0x56},
+            {0x68, 0x29, 0x45, 0x4b, 0xe0, 0xcc, 0x31, 0x99},
+            {0x88, 0x51, 0xaf, 0x10, 0x0e, 0xa3, 0x2e, 0x06},
+            {0xb5, 0x93, 0x78, 0x57, 0xf0, 0xd7, 0x8c, 0x9f},
+            {0x74, 0x6c, 0xd0, 0x02, 0x53, 0x27, 0xbf, 0x5b},
+            {0x0a, 0xde, 0x30, 0xdc, 0x8a, 0x47, 0xe9, 0x9f},
+            {0xc8, 0x91, 0x78, 0xbb, 0x87, 0x3c, 0x6b, 0x3d}};
+    byte xxh3_seeded[9][XXH3_BLOCK_SIZE] = {
+            {0x60, 0x2b, 0x0e, 0x2c, 0xd6, 0x66, 0x2c, 0x8b},
+            {0xa8, 0xba, 0xcd, 0x84, 0x76, 0x19, 0x19, 0x9e},
+            {0x2e, 0x2a, 0xbc, 0xe5, 0xe9, 0x90, 0x30, 0x17},
+            {0xcd, 0x38, 0x90, 0x51, 0xb9, 0x56, 0x1a, 0x62},
+            {0x37, 0xd5, 0x19, 0x1d, 0xa9, 0x5b, 0xda, 0x5f},
+            {0xc2, 0x01, 0x87, 0x4f, 0x33, 0x30, 0x6c, 0x7f},
+            {0x30, 0x2a, 0x45, 0xdf, 0xe0, 0x46, 0x8b, 0xe1},
+            {0xff, 0x6b, 0xd8, 0xfd, 0xf3, 0x43, 0x39, 0x18},
+            {0x16, 0xed, 0xdd, 0xe1, 0x0b, 0xf7, 0x7c, 0x73}};
+    byte murmur3_hashes[9][MURMUR3_BLOCK_SIZE] = {
+            {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+            {0xce, 0x3d, 0xb5, 0xf3, 0xca, 0xeb, 0x3f, 0x6e, 0x88, 0xb6, 0xff, 0x75, 0xe3, 0x83, 0xbb, 0xe5},
+            {0x29, 0x41, 0x31, 0x12, 0x29, 0xbf, 0xcd, 0x46, 0xac, 0x01, 0x16, 0x9d, 0x2a, 0x51, 0xd9, 0x3f},
+            {0x70, 0xa0, 0x3e, 0xcf, 0x98, 0x88, 0x40, 0x92, 0x15, 0xf2, 0xb4, 0xaf, 0x57, 0xd1, 0x0f, 0x7b},
+            {0x2f, 0x85, 0x4b, 0x7c, 0x64, 0x59, 0xc9, 0x68, 0xcc, 0xaf, 0xec, 0xb6, 0x7a, 0x1f, 0xa0, 0x47},
+            {0xd3, 0xa4, 0x75, 0xb6, 0xa2, 0x52, 0x6a, 0x17, 0x2a, 0x28, 0x1c, 0x38, 0x70, 0x0b, 0xac, 0xa2},
+            {0xed, 0xb1, 0xb1, 0x99, 0x7f, 0xc8, 0x8e, 0xfd, 0xcd, 0x58, 0xd3, 0xb0, 0x2f, 0x77, 0x83, 0x68},
+            {0x77, 0xb4, 0x6e, 0x09, 0xa6, 0x77, 0x2b, 0xd0, 0xe8, 0xdf, 0xd6, 0xb2, 0xc5, 0xea, 0x9d, 0x84},
+            {0x0e, 0x2d, 0x0f, 0xc3, 0x98, 0xc1, 0xdd, 0xc0, 0x6a, 0xca, 0xa5, 0x89, 0xc2, 0xef, 0xc0, 0x27}};
+    byte murmur3_seeded[9][MURMUR3_BLOCK_SIZE] = {
+            {0x23, 0x85, 0x1b, 0xfa, 0x7d, 0xa7, 0x2a, 0xf0, 0xb9, 0xcb, 0x11, 0xda, 0x10, 0x66, 0x01, 0xd1},
+            {0x80, 0x75, 0x7d, 0x3b, 0x8e, 0xcd, 0x47, 0x25, 0x37, 0xec, 0x92, 0x5d, 0x83, 0xd9, 0xc7, 0xb4},
+            {0x65, 0x22, 0xd2, 0x12, 0x22, 0x04, 0x0e, 0x35, 0x8a, 0x22, 0x85, 0x26, 0xe0, 0xf6, 0x2e, 0x8a},
+            {0xd6, 0x39, 0x93, 0x85, 0xc7, 0xf7, 0x1f, 0xe0, 0x6e, 0xf8, 0x45, 0xcb, 0x84, 0x39, 0x6e, 0x5e},
+            {0x6a, 0xad, 0x3a, 0x57, 0xc0, 0x40, 0x24, 0x14, 0x14, 0x47, 0x10, 0x65, 0x97, 0x22, 0x0b, 0x75},
+            {0xe7, 0xa7, 0x54, 0xb9, 0x6c, 0x69, 0x4f, 0x26, 0x49, 0x01, 0x93, 0xd8, 0x39, 0xdb, 0x80, 0x40},
+            {0x02, 0x18, 0x49, 0x98, 0xba, 0x4b, 0x0a, 0x58, 0x99, 0x27, 0xdc, 0x2e, 0x1b, 0xae, 0x8a, 0xc9},
+            {0x14, 0x3c, 0x4c, 0x1b, 0xb7, 0xc7, 0xf6, 0xa9, 0x26, 0x99, 0x4b, 0x20, 0x99, 0x69, 0x15, 0xcd},
+            {0x95, 0x67, 0x52, 0x19, 0x7b, 0xc8, 0x5e, 0xb9, 0xaf, 0x9c, 0x23, 0x6a, 0xf9, 0x1a, 0x1a, 0xe1}};
+
+    for (size_t i = 0; i < std::size(lengths); ++i) {
+        run_test<hash::method::xxhash64>(q, buf.data(), lengths[i], xxhash64_hashes[i], count);
+        run_seeded_test<hash::method::xxhash64>(q, buf.data(), lengths[i], xxhash64_seeded[i], count, seed);
+        run_test<hash::method::xxh3>(q, buf.data(), lengths[i], xxh3_hashes[i], count);
+        run_seeded_test<hash::method::xxh3>(q, buf.data(), lengths[i], xxh3_seeded[i], count, seed);
+        run_test<hash::method::murmur3>(q, buf.data(), lengths[i], murmur3_hashes[i], count);
+        run_seeded_test<hash::method::murmur3>(q, buf.data(), lengths[i], murmur3_seeded[i], count, 42);
+    }
+
+    byte out[XXH3_BLOCK_SIZE];
+    hash::compute_xxh3(q[0].q, buf.data(), 200, out, 1, seed);
+    ASSERT_TRUE(!memcmp(xxh3_seeded[6], out, XXH3_BLOCK_SIZE));
+}
+
 void sha1_test(hash::runners &q, size_t count) {
     byte text1[] = {
             "abc"
@@ -73,6 +303,1048 @@ void sha256_test(hash::runners &q, size_t n_blocks) {
     run_test<hash::method::sha256>(q, text2, strlen((char *) text2), hash2, n_blocks);
 }
 
+void sha256d_test(hash::runners &q, size_t count) {
+    byte text1[] = {"abc"};
+    byte text2[] = {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"};
+    // Bitcoin genesis block header, its id is the reversed digest
+    byte header[80] = {
+            0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+            0x00, 0x00, 0x00, 0x00, 0x3b, 0xa3, 0xed, 0xfd, 0x7a, 0x7b, 0x12, 0xb2, 0x7a, 0xc7, 0x2c, 0x3e,
+            0x67, 0x76, 0x8f, 0x61, 0x7f, 0xc8, 0x1b, 0xc3, 0x88, 0x8a, 0x51, 0x32, 0x3a, 0x9f, 0xb8, 0xaa,
+            0x4b, 0x1e, 0x5e, 0x4a, 0x29, 0xab, 0x5f, 0x49, 0xff, 0xff, 0x00, 0x1d, 0x1d, 0xac, 0x2b, 0x7c};
+    byte hash1[SHA256D_BLOCK_SIZE] = {
+            0x4f, 0x8b, 0x42, 0xc2, 0x2d, 0xd3, 0x72, 0x9b,
+            0x51, 0x9b, 0xa6, 0xf6, 0x8d, 0x2d, 0xa7, 0xcc,
+            0x5b, 0x2d, 0x60, 0x6d, 0x05, 0xda, 0xed, 0x5a,
+            0xd5, 0x12, 0x8c, 0xc0, 0x3e, 0x6c, 0x63, 0x58};
+    byte hash2[SHA256D_BLOCK_SIZE] = {
+            0x0c, 0xff, 0xe1, 0x7f, 0x68, 0x95, 0x4d, 0xac,
+            0x3a, 0x84, 0xfb, 0x14, 0x58, 0xbd, 0x5e, 0xc9,
+            0x92, 0x09, 0x44, 0x97, 0x49, 0xb2, 0xb3, 0x08,
+            0xb7, 0xcb, 0x55, 0x81, 0x2f, 0x95, 0x63, 0xaf};
+    byte hash3[SHA256D_BLOCK_SIZE] = {
+            0x6f, 0xe2, 0x8c, 0x0a, 0xb6, 0xf1, 0xb3, 0x72,
+            0xc1, 0xa6, 0xa2, 0x46, 0xae, 0x63, 0xf7, 0x4f,
+            0x93, 0x1e, 0x83, 0x65, 0xe1, 0x5a, 0x08, 0x9c,
+            0x68, 0xd6, 0x19, 0x00, 0x00, 0x00, 0x00, 0x00};
+    run_test<hash::method::sha256d>(q, text1, strlen((char *) text1), hash1, count);
+    run_test<hash::method::sha256d>(q, text2, strlen((char *) text2), hash2, count);
+    run_test<hash::method::sha256d>(q, header, sizeof(header), hash3, count);
+}
+
+void hash160_test(hash::runners &q, size_t count) {
+    byte text1[] = {"abc"};
+    byte text2[] = {"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"};
+    byte hash1[HASH160_BLOCK_SIZE] = {0xbb, 0x1b, 0xe9, 0x8c, 0x14, 0x24, 0x44, 0xd7, 0xa5, 0x6a, 0xa3, 0x98, 0x1c, 0x39, 0x42, 0xa9, 0x78, 0xe4, 0xdc, 0x33};
+    byte hash2[HASH160_BLOCK_SIZE] = {0x69, 0xdd, 0xa8, 0xa6, 0x0e, 0x0c, 0xfc, 0x23, 0x53, 0xaa, 0x77, 0x68, 0x64, 0x09, 0x2c, 0x0e, 0x5c, 0xcb, 0x48, 0x34};
+    run_test<hash::method::hash160>(q, text1, strlen((char *) text1), hash1, count);
+    run_test<hash::method::hash160>(q, text2, strlen((char *) text2), hash2, count);
+}
+
+/**
+ * Lengths that go through the specialised single/two blocks kernels.
+ */
+void small_input_test(hash::runners &q, size_t count) {
+    constexpr size_t lengths[] = {16, 20, 32, 48, 64};
+    byte buf[64];
+    for (size_t i = 0; i < 64; ++i) {
+        buf[i] = (uint8_t) i;
+    }
+    byte sha256_hashes[5][SHA256_BLOCK_SIZE] = {
+            {0xbe, 0x45, 0xcb, 0x26, 0x05, 0xbf, 0x36, 0xbe, 0xbd, 0xe6, 0x84, 0x84, 0x1a, 0x28, 0xf0, 0xfd, 0x43, 0xc6, 0x98, 0x50, 0xa3, 0xdc, 0xe5, 0xfe, 0xdb, 0xa6, 0x99, 0x28, 0xee, 0x3a, 0x89, 0x91},
+            {0xe7, 0xae, 0xbf, 0x57, 0x7f, 0x60, 0x41, 0x2f, 0x03, 0x12, 0xd4, 0x42, 0xc7, 0x0a, 0x1f, 0xa6, 0x14, 0x8c, 0x09, 0x0b, 0xf5, 0xba, 0xb4, 0x04, 0xca, 0xec, 0x29, 0x48, 0x2a, 0xe7, 0x79, 0xe8},
+            {0x63, 0x0d, 0xcd, 0x29, 0x66, 0xc4, 0x33, 0x66, 0x91, 0x12, 0x54, 0x48, 0xbb, 0xb2, 0x5b, 0x4f, 0xf4, 0x12, 0xa4, 0x9c, 0x73, 0x2d, 0xb2, 0xc8, 0xab, 0xc1, 0xb8, 0x58, 0x1b, 0xd7, 0x10, 0xdd},
+            {0x4d, 0xbd, 0xc2, 0xb2, 0xb6, 0x2c, 0xb0, 0x07, 0x49, 0x78, 0x5b, 0xc8, 0x42, 0x02, 0x23, 0x6d, 0xbc, 0x37, 0x77, 0xd7, 0x46, 0x60, 0x61, 0x1b, 0x8e, 0x58, 0x81, 0x2f, 0x0c, 0xfd, 0xe6, 0xc3},
+            {0xfd, 0xea, 0xb9, 0xac, 0xf3, 0x71, 0x03, 0x62, 0xbd, 0x26, 0x58, 0xcd, 0xc9, 0xa2, 0x9e, 0x8f, 0x9c, 0x75, 0x7f, 0xcf, 0x98, 0x11, 0x60, 0x3a, 0x8c, 0x44, 0x7c, 0xd1, 0xd9, 0x15, 0x11, 0x08}};
+    byte sha1_hashes[5][SHA1_BLOCK_SIZE] = {
+            {0x56, 0x17, 0x8b, 0x86, 0xa5, 0x7f, 0xac, 0x22, 0x89, 0x9a, 0x99, 0x64, 0x18, 0x5c, 0x2c, 0xc9, 0x6e, 0x7d, 0xa5, 0x89},
+            {0x60, 0x2c, 0x63, 0xd2, 0xf3, 0xd1, 0x3c, 0xa3, 0x20, 0x6c, 0xdf, 0x20, 0x4c, 0xde, 0x24, 0xe7, 0xd8, 0xf4, 0x26, 0x6c},
+            {0xae, 0x5b, 0xd8, 0xef, 0xea, 0x53, 0x22, 0xc4, 0xd9, 0x98, 0x6d, 0x06, 0x68, 0x0a, 0x78, 0x13, 0x92, 0xf9, 0xa6, 0x42},
+            {0xdf, 0x7f, 0x23, 0xb1, 0x60, 0xe7, 0x5b, 0x9b, 0xae, 0x5e, 0xa1, 0xe6, 0x2b, 0x43, 0xa5, 0xa3, 0x4a, 0x26, 0x01, 0x27},
+            {0xc6, 0x13, 0x8d, 0x51, 0x4f, 0xfa, 0x21, 0x35, 0xbf, 0xce, 0x0e, 0xd0, 0xb8, 0xfa, 0xc6, 0x56, 0x69, 0x91, 0x7e, 0xc7}};
+    byte md5_hashes[5][MD5_BLOCK_SIZE] = {
+            {0x1a, 0xc1, 0xef, 0x01, 0xe9, 0x6c, 0xaf, 0x1b, 0xe0, 0xd3, 0x29, 0x33, 0x1a, 0x4f, 0xc2, 0xa8},
+            {0x15, 0x49, 0xd1, 0xaa, 0xe2, 0x02, 0x14, 0xe0, 0x65, 0xab, 0x4b, 0x76, 0xaa, 0xac, 0x89, 0xa8},
+            {0xb4, 0xff, 0xcb, 0x23, 0x73, 0x7c, 0xec, 0x31, 0x5a, 0x4a, 0x4d, 0x1a, 0xa2, 0xa6, 0x20, 0xce},
+            {0x04, 0x60, 0x5c, 0xa5, 0x42, 0xb2, 0xd8, 0x2b, 0x98, 0x86, 0xa4, 0xb4, 0xb9, 0xac, 0xfb, 0x1c},
+            {0xb2, 0xd3, 0xf5, 0x6b, 0xc1, 0x97, 0xfd, 0x98, 0x5d, 0x59, 0x65, 0x07, 0x9b, 0x5e, 0x71, 0x48}};
+
+    for (size_t i = 0; i < std::size(lengths); ++i) {
+        run_test<hash::method::sha256>(q, buf, lengths[i], sha256_hashes[i], count);
+        run_test<hash::method::sha1>(q, buf, lengths[i], sha1_hashes[i], count);
+        run_test<hash::method::md5>(q, buf, lengths[i], md5_hashes[i], count);
+    }
+}
+
+/**
+ * Inputs spanning many blocks. With an odd length the items alternate between aligned and unaligned addresses
+ * so both load paths of the update loops are exercised.
+ */
+void multi_block_test(hash::runners &q, size_t count) {
+    constexpr size_t len = 1001;
+    byte buf[len];
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] = (uint8_t) (i * 7 + 3);
+    }
+    byte sha256_hash[SHA256_BLOCK_SIZE] = {
+            0x58, 0xbd, 0x46, 0x32, 0xb5, 0xbd, 0x5c, 0x2f,
+            0x04, 0xa2, 0xd0, 0xa9, 0xad, 0xb2, 0x6b, 0x3d,
+            0x9b, 0x75, 0xf0, 0x9c, 0x5b, 0x36, 0x05, 0x18,
+            0x34, 0x74, 0xac, 0x23, 0x99, 0xae, 0xa7, 0xf1};
+    byte sha1_hash[SHA1_BLOCK_SIZE] = {0x97, 0x64, 0xdb, 0xec, 0x43, 0x43, 0x77, 0xb3, 0x3a, 0x37, 0xc9, 0x47, 0x1d, 0xed, 0x58, 0xe9, 0xd5, 0x10, 0x45, 0x09};
+    byte md5_hash[MD5_BLOCK_SIZE] = {0x97, 0x4f, 0x1c, 0x55, 0x64, 0x0d, 0x1e, 0xc9, 0xdf, 0x60, 0x35, 0x70, 0x4a, 0xa3, 0x33, 0x2b};
+    run_test<hash::method::sha256>(q, buf, len, sha256_hash, count);
+    run_test<hash::method::sha1>(q, buf, len, sha1_hash, count);
+    run_test<hash::method::md5>(q, buf, len, md5_hash, count);
+}
+
+/**
+ * Lengths known at compile time with compute<M, fixed_len<N>>, and registered lengths picked up by the runtime dispatch.
+ */
+void fixed_length_test(hash::runners &q, size_t count) {
+    constexpr size_t len = 4096;
+    std::vector<byte> buf(len * count);
+    for (size_t i = 0; i < len; ++i) {
+        buf[i] = (uint8_t) (i * 13 + 1);
+    }
+    duplicate(buf.data(), buf.data(), len, count);
+    byte sha256_hash[SHA256_BLOCK_SIZE] = {
+            0xcc, 0x27, 0xdc, 0x29, 0xed, 0x0b, 0x4a, 0xa1,
+            0x34, 0xd2, 0xc4, 0x3f, 0xba, 0xf0, 0xc8, 0xe8,
+            0x23, 0xa5, 0xae, 0x9a, 0xd1, 0xac, 0x63, 0x1e,
+            0x4c, 0x0b, 0x6c, 0xf7, 0x06, 0x1a, 0x4c, 0xae};
+    byte sha1_hash[SHA1_BLOCK_SIZE] = {0x23, 0x0c, 0x3b, 0x2d, 0x9a, 0x55, 0xf5, 0xf6, 0x6d, 0xf9, 0x82, 0x7d, 0x03, 0x1e, 0x5a, 0xc1, 0x3b, 0xb2, 0x29, 0x9e};
+    byte md5_hash[MD5_BLOCK_SIZE] = {0x2e, 0x09, 0x98, 0xf0, 0x2b, 0x1a, 0xc8, 0xa0, 0xe1, 0x8e, 0xa9, 0x08, 0xb8, 0x0f, 0x3b, 0xbc};
+
+    std::vector<byte> out(SHA256_BLOCK_SIZE * count);
+    for (auto &runner: q) {
+        hash::compute<hash::method::sha256, hash::fixed_len<len>>(runner.q, buf.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_TRUE(!memcmp(sha256_hash, out.data() + SHA256_BLOCK_SIZE * i, SHA256_BLOCK_SIZE));
+        }
+        hash::compute<hash::method::sha1, hash::fixed_len<len>>(runner.q, buf.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_TRUE(!memcmp(sha1_hash, out.data() + SHA1_BLOCK_SIZE * i, SHA1_BLOCK_SIZE));
+        }
+        hash::compute<hash::method::md5, hash::fixed_len<len>>(runner.q, buf.data(), out.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_TRUE(!memcmp(md5_hash, out.data() + MD5_BLOCK_SIZE * i, MD5_BLOCK_SIZE));
+        }
+    }
+
+    byte sha256_hash_128[SHA256_BLOCK_SIZE] = {
+            0x1b, 0xd9, 0xb7, 0x2c, 0x6f, 0x0a, 0x1d, 0xce,
+            0xfb, 0xe2, 0x00, 0x88, 0x98, 0x3e, 0xa7, 0xcb,
+            0xa3, 0xcb, 0x09, 0x7d, 0x60, 0x14, 0x68, 0xd6,
+            0x90, 0xda, 0x69, 0x3a, 0xf5, 0x57, 0x30, 0x90};
+    run_test<hash::method::sha256>(q, buf.data(), 128, sha256_hash_128, count);
+}
+
+/**
+ * Every lookup table placement must give the same digests, whatever the device.
+ */
+void table_placement_test(hash::runners &q, size_t count) {
+    byte text[] = {"abc"};
+    constexpr size_t len = 3;
+    byte md2_hash[MD2_BLOCK_SIZE] = {0xda, 0x85, 0x3b, 0x0d, 0x3f, 0x88, 0xd9, 0x9b, 0x30, 0x28, 0x3a, 0x69, 0xe6, 0xde, 0xd6, 0xbb};
+    byte sha256_hash[SHA256_BLOCK_SIZE] = {
+            0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+            0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+            0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+            0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad};
+
+    for (auto &runner: q) {
+        auto in = usm_smart_ptr::usm_unique_ptr<byte, usm_smart_ptr::alloc::shared>(len * count, runner.q);
+        auto out = usm_smart_ptr::usm_unique_ptr<byte, usm_smart_ptr::alloc::shared>(SHA256_BLOCK_SIZE * count, runner.q);
+        duplicate(text, in.raw(), len, count);
+        for (auto placement: {hash::table_placement::private_memory, hash::table_placement::local_memory, hash::table_placement::constant_memory}) {
+            hash::internal::dispatch_hash<hash::method::md2, 0>(runner.q, sycl::event{}, in.get(), out.get(), len, count, nullptr, 0, placement).wait();
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE(!memcmp(md2_hash, out.raw() + MD2_BLOCK_SIZE * i, MD2_BLOCK_SIZE));
+            }
+            hash::internal::dispatch_hash<hash::method::sha256, 0>(runner.q, sycl::event{}, in.get(), out.get(), len, count, nullptr, 0, placement).wait();
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE(!memcmp(sha256_hash, out.raw() + SHA256_BLOCK_SIZE * i, SHA256_BLOCK_SIZE));
+            }
+        }
+    }
+}
+
+/**
+ * The CRC check values ("123456789"), then inputs that go through the sliced loop and its byte-wise tail.
+ * Each explicit table placement runs the byte-wise kernel, which must agree with the slice-by-8 one.
+ */
+void crc_test(hash::runners &q, size_t count) {
+    byte check[] = {"123456789"};
+    byte crc32c_check[CRC32C_BLOCK_SIZE] = {0xe3, 0x06, 0x92, 0x83};
+    byte crc64nvme_check[CRC64NVME_BLOCK_SIZE] = {0xae, 0x8b, 0x14, 0x86, 0x0a, 0x79, 0x98, 0x88};
+    run_test<hash::method::crc32c>(q, check, 9, crc32c_check, count);
+    run_test<hash::method::crc64nvme>(q, check, 9, crc64nvme_check, count);
+
+    constexpr size_t lengths[] = {0, 13, 4096};
+    std::vector<byte> buf(4096);
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = (uint8_t) (i * 7 + 3);
+    }
+    byte crc32c_hashes[3][CRC32C_BLOCK_SIZE] = {
+            {0x00, 0x00, 0x00, 0x00},
+            {0xef, 0x90, 0x67, 0x63},
+            {0xed, 0x96, 0xb6, 0x43}};
+    byte crc64nvme_hashes[3][CRC64NVME_BLOCK_SIZE] = {
+            {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},
+            {0xad, 0xda, 0x0c, 0xb8, 0xee, 0x0b, 0xe4, 0x0e},
+            {0xee, 0xd9, 0x6e, 0xc7, 0x91, 0xf1, 0x40, 0xcb}};
+    for (size_t i = 0; i < std::size(lengths); ++i) {
+        run_test<hash::method::crc32c>(q, buf.data(), lengths[i], crc32c_hashes[i], count);
+        run_test<hash::method::crc64nvme>(q, buf.data(), lengths[i], crc64nvme_hashes[i], count);
+    }
+
+    constexpr size_t len = 4096;
+    for (auto &runner: q) {
+        auto in = usm_smart_ptr::usm_unique_ptr<byte, usm_smart_ptr::alloc::shared>(len * count, runner.q);
+        auto out = usm_smart_ptr::usm_unique_ptr<byte, usm_smart_ptr::alloc::shared>(CRC64NVME_BLOCK_SIZE * count, runner.q);
+        duplicate(buf.data(), in.raw(), len, count);
+        for (auto placement: {hash::table_placement::private_memory, hash::table_placement::local_memory, hash::table_placement::constant_memory}) {
+            hash::internal::dispatch_hash<hash::method::crc32c, 0>(runner.q, sycl::event{}, in.get(), out.get(), len, count, nullptr, 0, placement).wait();
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE(!memcmp(crc32c_hashes[2], out.raw() + CRC32C_BLOCK_SIZE * i, CRC32C_BLOCK_SIZE));
+            }
+            hash::internal::dispatch_hash<hash::method::crc64nvme, 0>(runner.q, sycl::event{}, in.get(), out.get(), len, count, nullptr, 0, placement).wait();
+            for (size_t i = 0; i < count; ++i) {
+                ASSERT_TRUE(!memcmp(crc64nvme_hashes[2], out.raw() + CRC64NVME_BLOCK_SIZE * i, CRC64NVME_BLOCK_SIZE));
+            }
+        }
+    }
+}
+
+template<hash::method M>
+void run_bloom_filter_test(sycl::queue &q, const byte *key = nullptr, dword keylen = 0) {
+    constexpr dword n_inserted = 2000;
+    constexpr dword n_items = 2 * n_inserted;
+    constexpr dword item_len = 16;
+    std::vector<byte> items(item_len * n_items);
+    for (dword i = 0; i < n_items; ++i) {
+        for (dword j = 0; j < item_len; ++j) {
+            items[item_len * i + j] = (byte) ((i >> (8 * (j % 4))) + j);
+        }
+    }
+    hash::bloom_filter<M> filter(q, hash::optimal_bloom_filter_params(n_inserted, 0.01), key, keylen);
+    filter.insert(items.data(), item_len, n_inserted);
+
+    std::vector<dword> bitmap((n_items + 31) / 32);
+    filter.query(items.data(), item_len, n_items, bitmap.data());
+    dword false_positives = 0;
+    for (dword i = 0; i < n_items; ++i) {
+        bool maybe_present = bitmap[i / 32] & (1u << (i % 32));
+        if (i < n_inserted) {
+            ASSERT_TRUE(maybe_present);
+        } else {
+            false_positives += maybe_present;
+        }
+    }
+    ASSERT_LT(false_positives, 3 * n_inserted / 100);
+
+    auto device_items = usm_smart_ptr::usm_unique_ptr<byte, usm_smart_ptr::alloc::shared>(items.size(), q);
+    memcpy(device_items.raw(), items.data(), items.size());
+    filter.clear();
+    filter.query(device_items.raw(), item_len, n_items, bitmap.data());
+    for (auto word: bitmap) {
+        ASSERT_EQ(word, 0u);
+    }
+    filter.insert(device_items.raw() + item_len * n_inserted, item_len, n_inserted);
+    filter.query(items.data(), item_len, n_items, bitmap.data());
+    for (dword i = n_inserted; i < n_items; ++i) {
+        ASSERT_TRUE(bitmap[i / 32] & (1u << (i % 32)));
+    }
+}
+
+/**
+ * No false negatives, a false positive rate close to the one asked for, with host and device memory inputs. Sizing
+ * rejects rates outside (0, 1).
+ */
+void bloom_filter_test(hash::runners &q) {
+    byte key[SIPHASH_KEY_SIZE] = {0};
+    for (auto &runner: q) {
+        run_bloom_filter_test<hash::method::xxh3>(runner.q);
+        run_bloom_filter_test<hash::method::crc32c>(runner.q);
+        run_bloom_filter_test<hash::method::sha256>(runner.q);
+        run_bloom_filter_test<hash::method::siphash>(runner.q, key, sizeof(key));
+    }
+
+    const auto empty = hash::optimal_bloom_filter_params(0, 0.01), single = hash::optimal_bloom_filter_params(1, 0.01);
+    ASSERT_EQ(empty.n_bits, single.n_bits);
+    ASSERT_EQ(empty.n_hashes, single.n_hashes);
+    for (double rate: {0.0, 1.0, -0.5, 2.0, std::nan("")}) {
+        ASSERT_THROW(hash::optimal_bloom_filter_params(1000, rate), std::invalid_argument);
+    }
+}
+
+/**
+ * MinHash and SimHash of the shingles hashed one by one with `compute`, xxh3 digests being big endian.
+ */
+static void reference_signatures(sycl::queue &q, const byte *doc, size_t doc_len, dword shingle_len, dword k, qword seed, qword *minhash, qword &simhash) {
+    size_t n_shingles = doc_len <= shingle_len ? (doc_len != 0) : doc_len - shingle_len + 1;
+    dword len = (dword) std::min<size_t>(doc_len, shingle_len);
+    std::vector<byte> shingles(n_shingles * len + 1);
+    for (size_t i = 0; i < n_shingles; ++i) {
+        memcpy(shingles.data() + i * len, doc + i, len);
+    }
+    std::vector<byte> digests(n_shingles * XXH3_BLOCK_SIZE + 1);
+    hash::compute<hash::method::xxh3>(q, shingles.data(), len, digests.data(), (dword) n_shingles, seed);
+    int votes[64] = {0};
+    std::fill(minhash, minhash + k, ~0ull);
+    for (size_t i = 0; i < n_shingles; ++i) {
+        qword h = 0;
+        for (dword j = 0; j < XXH3_BLOCK_SIZE; ++j) {
+            h = (h << 8) | digests[i * XXH3_BLOCK_SIZE + j];
+        }
+        for (dword j = 0; j < k; ++j) {
+            minhash[j] = std::min(minhash[j], hash::minhash_permutation(h, j));
+        }
+        for (dword b = 0; b < 64; ++b) {
+            votes[b] += (h >> b) & 1 ? 1 : -1;
+        }
+    }
+    simhash = 0;
+    for (dword b = 0; b < 64; ++b) {
+        simhash |= (qword) (votes[b] > 0) << b;
+    }
+}
+
+/**
+ * Signatures of ragged documents: a long one, a near duplicate of it, one shorter than a shingle and an empty one.
+ */
+void signatures_test(hash::runners &q) {
+    constexpr dword shingle_len = 8;
+    constexpr dword k = 64;
+    constexpr qword seed = 1234;
+    std::string text;
+    for (int i = 0; i < 40; ++i) {
+        text += "the quick brown fox " + std::to_string(i * 7) + " jumps ";
+    }
+    std::string near_duplicate = text;
+    near_duplicate[100] = '#';
+    near_duplicate[700] = '#';
+    std::string all = text + near_duplicate + "abc";
+    std::vector<qword> offsets = {0, text.size(), 2 * text.size(), 2 * text.size() + 3, 2 * text.size() + 3};
+    hash::ragged_documents docs{(const byte *) all.data(), offsets.data(), 4};
+
+    for (auto &runner: q) {
+        std::vector<qword> minhash(k * docs.n_docs);
+        std::vector<qword> simhash(docs.n_docs);
+        hash::compute_minhash<hash::method::xxh3>(runner.q, docs, shingle_len, k, minhash.data(), seed);
+        hash::compute_simhash<hash::method::xxh3>(runner.q, docs, shingle_len, simhash.data(), seed);
+        for (dword d = 0; d < docs.n_docs; ++d) {
+            std::vector<qword> expected_minhash(k);
+            qword expected_simhash;
+            reference_signatures(runner.q, (const byte *) all.data() + offsets[d], offsets[d + 1] - offsets[d], shingle_len, k, seed, expected_minhash.data(), expected_simhash);
+            for (dword i = 0; i < k; ++i) {
+                ASSERT_EQ(minhash[d * k + i], expected_minhash[i]);
+            }
+            ASSERT_EQ(simhash[d], expected_simhash);
+        }
+
+        auto device_minhash = usm_smart_ptr::usm_unique_ptr<qword, usm_smart_ptr::alloc::shared>(k * docs.n_docs, runner.q);
+        hash::compute_minhash<hash::method::murmur3>(runner.q, docs, shingle_len, k, device_minhash.raw(), seed);
+        dword matches = 0;
+        for (dword i = 0; i < k; ++i) {
+            matches += device_minhash.raw()[i] == device_minhash.raw()[k + i];
+        }
+        ASSERT_GT(matches, k / 2);
+        ASSERT_LT(matches, k);
+
+        /* Empty shingles would give every document the same signature */
+        ASSERT_THROW(hash::compute_minhash<hash::method::xxh3>(runner.q, docs, 0, k, minhash.data(), seed), std::invalid_argument);
+        ASSERT_THROW(hash::compute_simhash<hash::method::xxh3>(runner.q, docs, 0, simhash.data(), seed), std::invalid_argument);
+    }
+
+    /* The runtime launchers refuse the methods the sketch kernels cannot run */
+    auto &any_q = q[0].q;
+    ASSERT_THROW(hash::internal::launch_simhash_kernel(any_q, sycl::event{}, hash::method::sha256, usm_smart_ptr::device_accessible_ptr<byte>((byte *) nullptr),
+                                                       usm_smart_ptr::device_accessible_ptr<qword>((qword *) nullptr), 0, shingle_len, seed,
+                                                       usm_smart_ptr::device_accessible_ptr<qword>((qword *) nullptr)), std::invalid_argument);
+}
+
+/**
+ * Estimates within 5 % (3 standard errors) and sketches that do not depend on how the items are split: between the
+ * runners, between calls or between merged sketches.
+ */
+void hyperloglog_test(hash::runners &q) {
+    constexpr dword n_items = 100000;
+    std::vector<qword> items(n_items);
+    for (dword i = 0; i < n_items; ++i) {
+        items[i] = (qword) i * 0x9e3779b97f4a7c15;
+    }
+    const byte *in = (const byte *) items.data();
+
+    for (dword precision: {12, 16}) {
+        hash::hyperloglog<hash::method::xxh3> all(q, precision, 42);
+        all.add(in, sizeof(qword), n_items);
+        ASSERT_NEAR(all.estimate(), n_items, 0.05 * n_items);
+        auto registers = all.registers();
+
+        all.add(in, sizeof(qword), n_items / 2);
+        ASSERT_EQ(all.registers(), registers);
+
+        hash::hyperloglog<hash::method::xxh3> first_half(q, precision, 42);
+        hash::hyperloglog<hash::method::xxh3> second_half(q, precision, 42);
+        first_half.add(in, sizeof(qword), n_items / 2);
+        second_half.add(in + sizeof(qword) * (n_items / 2), sizeof(qword), n_items - n_items / 2);
+        first_half.merge(second_half);
+        ASSERT_EQ(first_half.registers(), registers);
+        hash::hyperloglog<hash::method::xxh3> coarser(q, precision - 2, 42), reseeded(q, precision, 43);
+        ASSERT_THROW(first_half.merge(coarser), std::invalid_argument);
+        ASSERT_THROW(first_half.merge(reseeded), std::invalid_argument);
+
+        for (auto &runner: q) {
+            hash::hyperloglog<hash::method::xxh3> single(hash::runners{runner}, precision, 42);
+            single.add(in, sizeof(qword), n_items);
+            ASSERT_EQ(single.registers(), registers);
+        }
+    }
+
+    hash::hyperloglog<hash::method::murmur3> small(q);
+    small.add(in, sizeof(qword), 1000);
+    ASSERT_NEAR(small.estimate(), 1000, 30);
+    small.clear();
+    ASSERT_EQ(small.estimate(), 0);
+}
+
+void count_min_test(hash::runners &q) {
+    /* Key i appears 200 / (i + 1) times for the first 20 keys, the 2000 others once */
+    std::vector<qword> keys;
+    std::vector<dword> truth;
+    for (dword i = 0; i < 2020; ++i) {
+        truth.push_back(i < 20 ? 200 / (i + 1) : 1);
+        for (dword j = 0; j < truth.back(); ++j) {
+            keys.push_back((qword) i * 0x9e3779b97f4a7c15 + 1);
+        }
+    }
+    std::vector<qword> distinct(truth.size());
+    for (dword i = 0; i < distinct.size(); ++i) {
+        distinct[i] = (qword) i * 0x9e3779b97f4a7c15 + 1;
+    }
+    const auto n_keys = (dword) keys.size();
+    const auto n_distinct = (dword) distinct.size();
+
+    hash::count_min_sketch<hash::method::xxh3> sketch(q, 4096, 4, 42);
+    sketch.add((const byte *) keys.data(), sizeof(qword), n_keys);
+    std::vector<dword> estimates(n_distinct);
+    sketch.estimate((const byte *) distinct.data(), sizeof(qword), n_distinct, estimates.data());
+    for (dword i = 0; i < n_distinct; ++i) {
+        ASSERT_GE(estimates[i], truth[i]);
+    }
+    ASSERT_EQ(estimates[0], 200);
+
+    /* The stream itself holds many copies of each hot key, only one of each must come back */
+    auto top = sketch.top_k((const byte *) keys.data(), sizeof(qword), n_keys, 5);
+    ASSERT_EQ(top.size(), 5);
+    for (dword i = 0; i < 5; ++i) {
+        ASSERT_EQ(keys[top[i].index], distinct[i]);
+        ASSERT_EQ(top[i].count, estimates[i]);
+    }
+    ASSERT_EQ(sketch.top_k((const byte *) distinct.data(), sizeof(qword), 3, 10).size(), 3);
+
+    auto counters = sketch.counters();
+    for (auto &runner: q) {
+        hash::count_min_sketch<hash::method::xxh3> single(hash::runners{runner}, 4096, 4, 42);
+        single.add((const byte *) keys.data(), sizeof(qword), n_keys);
+        ASSERT_EQ(single.counters(), counters);
+    }
+
+    hash::count_min_sketch<hash::method::xxh3> other(q, 4096, 4, 42);
+    other.add((const byte *) keys.data(), sizeof(qword), n_keys);
+    sketch.merge(other);
+    sketch.estimate((const byte *) distinct.data(), sizeof(qword), 1, estimates.data());
+    ASSERT_EQ(estimates[0], 400);
+    hash::count_min_sketch<hash::method::xxh3> wider(q, 8192, 4, 42), deeper(q, 4096, 5, 42), reseeded(q, 4096, 4, 43);
+    ASSERT_THROW(sketch.merge(wider), std::invalid_argument);
+    ASSERT_THROW(sketch.merge(deeper), std::invalid_argument);
+    ASSERT_THROW(sketch.merge(reseeded), std::invalid_argument);
+
+    /* Doubled by merging with itself until the counters would wrap, they saturate instead, and stay there */
+    for (int i = 0; i < 32; ++i) {
+        sketch.merge(sketch);
+    }
+    sketch.add((const byte *) distinct.data(), sizeof(qword), 1);
+    sketch.estimate((const byte *) distinct.data(), sizeof(qword), 1, estimates.data());
+    ASSERT_EQ(estimates[0], ~0u);
+
+    sketch.clear();
+    sketch.estimate((const byte *) distinct.data(), sizeof(qword), n_distinct, estimates.data());
+    ASSERT_EQ(*std::max_element(estimates.begin(), estimates.end()), 0);
+}
+
+/**
+ * Partition of each record of `inlen` bytes, from the xxh3 digests of `compute`.
+ */
+static std::vector<dword> reference_partitions(sycl::queue &q, const byte *in, dword inlen, dword n_batch, dword n_partitions, qword seed) {
+    std::vector<byte> digests(n_batch * XXH3_BLOCK_SIZE);
+    hash::compute<hash::method::xxh3>(q, in, inlen, digests.data(), n_batch, seed);
+    std::vector<dword> partitions(n_batch);
+    for (dword i = 0; i < n_batch; ++i) {
+        qword h = 0;
+        for (dword j = 0; j < XXH3_BLOCK_SIZE; ++j) {
+            h = (h << 8) | digests[i * XXH3_BLOCK_SIZE + j];
+        }
+        partitions[i] = (dword) (h % n_partitions);
+    }
+    return partitions;
+}
+
+/**
+ * Checks that each partition holds exactly its records, `record_of(slot)` being the index of the record in an output slot.
+ */
+template<typename Func>
+static void check_partitions(const std::vector<dword> &expected, const std::vector<qword> &partition_offsets, dword n_partitions, Func &&record_of) {
+    const auto n_batch = (dword) expected.size();
+    std::vector<bool> seen(n_batch);
+    ASSERT_EQ(partition_offsets[0], 0);
+    ASSERT_EQ(partition_offsets[n_partitions], n_batch);
+    for (dword p = 0; p < n_partitions; ++p) {
+        ASSERT_LE(partition_offsets[p], partition_offsets[p + 1]);
+        for (qword slot = partition_offsets[p]; slot < partition_offsets[p + 1]; ++slot) {
+            dword record = record_of(slot);
+            ASSERT_LT(record, n_batch);
+            ASSERT_FALSE(seen[record]);
+            seen[record] = true;
+            ASSERT_EQ(expected[record], p);
+        }
+    }
+}
+
+/**
+ * Partitions in local and in global memory, of fixed-size and of ragged records.
+ */
+static void partition_test(sycl::queue &q) {
+    constexpr dword n_batch = 5000;
+    constexpr dword inlen = 16;
+    constexpr qword seed = 77;
+    std::vector<byte> in(n_batch * inlen);
+    for (dword i = 0; i < n_batch; ++i) {
+        memcpy(in.data() + i * inlen, &i, sizeof(dword));
+        memset(in.data() + i * inlen + sizeof(dword), (int) (i * 31), inlen - sizeof(dword));
+    }
+
+    for (dword n_partitions: {1, 7, 3000, 20000}) {
+        auto expected = reference_partitions(q, in.data(), inlen, n_batch, n_partitions, seed);
+        std::vector<dword> indices(n_batch);
+        std::vector<qword> partition_offsets(n_partitions + 1);
+        hash::partition_indices<hash::method::xxh3>(q, in.data(), inlen, n_batch, n_partitions, indices.data(), partition_offsets.data(), seed);
+        check_partitions(expected, partition_offsets, n_partitions, [&](qword slot) { return indices[slot]; });
+
+        std::vector<byte> out(n_batch * inlen);
+        std::vector<qword> record_offsets(n_partitions + 1);
+        hash::partition_records<hash::method::xxh3>(q, in.data(), inlen, n_batch, n_partitions, out.data(), record_offsets.data(), seed);
+        ASSERT_EQ(record_offsets, partition_offsets);
+        check_partitions(expected, record_offsets, n_partitions, [&](qword slot) {
+            dword record;
+            memcpy(&record, out.data() + slot * inlen, sizeof(dword));
+            return memcmp(out.data() + slot * inlen, in.data() + record * inlen, inlen) == 0 ? record : n_batch;
+        });
+    }
+
+    /* Record i has 4 + i % 37 bytes and starts with i */
+    constexpr dword n_ragged = 300;
+    constexpr dword n_partitions = 5;
+    std::vector<byte> data;
+    std::vector<qword> offsets = {0};
+    std::vector<dword> expected;
+    for (dword i = 0; i < n_ragged; ++i) {
+        std::vector<byte> record(4 + i % 37, (byte) i);
+        memcpy(record.data(), &i, sizeof(dword));
+        expected.push_back(reference_partitions(q, record.data(), (dword) record.size(), 1, n_partitions, seed)[0]);
+        data.insert(data.end(), record.begin(), record.end());
+        offsets.push_back(data.size());
+    }
+    hash::ragged_documents records{data.data(), offsets.data(), n_ragged};
+
+    std::vector<dword> indices(n_ragged);
+    std::vector<qword> partition_offsets(n_partitions + 1);
+    hash::partition_indices<hash::method::xxh3>(q, records, n_partitions, indices.data(), partition_offsets.data(), seed);
+    check_partitions(expected, partition_offsets, n_partitions, [&](qword slot) { return indices[slot]; });
+
+    std::vector<byte> out_data(data.size());
+    std::vector<qword> out_offsets(n_ragged + 1);
+    hash::partition_records<hash::method::xxh3>(q, records, n_partitions, out_data.data(), out_offsets.data(), partition_offsets.data(), seed);
+    ASSERT_EQ(out_offsets[n_ragged], data.size());
+    check_partitions(expected, partition_offsets, n_partitions, [&](qword slot) {
+        dword record;
+        memcpy(&record, out_data.data() + out_offsets[slot], sizeof(dword));
+        bool same = record < n_ragged && out_offsets[slot + 1] - out_offsets[slot] == offsets[record + 1] - offsets[record] &&
+                    memcmp(out_data.data() + out_offsets[slot], data.data() + offsets[record], offsets[record + 1] - offsets[record]) == 0;
+        return same ? record : n_ragged;
+    });
+
+    /* No partitions to split the records in */
+    ASSERT_THROW(hash::partition_indices<hash::method::xxh3>(q, in.data(), inlen, n_batch, 0, indices.data(), partition_offsets.data(), seed), std::invalid_argument);
+    ASSERT_THROW(hash::partition_records<hash::method::xxh3>(q, in.data(), inlen, n_batch, 0, out_data.data(), partition_offsets.data(), seed), std::invalid_argument);
+    ASSERT_THROW(hash::partition_indices<hash::method::xxh3>(q, records, 0, indices.data(), partition_offsets.data(), seed), std::invalid_argument);
+    ASSERT_THROW(hash::partition_records<hash::method::xxh3>(q, records, 0, out_data.data(), out_offsets.data(), partition_offsets.data(), seed), std::invalid_argument);
+}
+
+void partition_test(hash::runners &q) {
+    for (auto &runner: q) {
+        partition_test(runner.q);
+    }
+}
+
+/**
+ * Groups of equal digests found on the host from `compute`, each group sorted and the groups ordered by first item.
+ */
+template<hash::method M>
+static std::vector<std::vector<dword>> reference_duplicates(sycl::queue &q, const byte *in, dword inlen, dword n_batch) {
+    constexpr dword digest_size = hash::get_block_size<M>();
+    std::vector<byte> digests(n_batch * digest_size);
+    hash::compute<M>(q, in, inlen, digests.data(), n_batch);
+    std::map<std::vector<byte>, std::vector<dword>> by_digest;
+    for (dword i = 0; i < n_batch; ++i) {
+        by_digest[std::vector<byte>(digests.begin() + i * digest_size, digests.begin() + (i + 1) * digest_size)].push_back(i);
+    }
+    std::vector<std::vector<dword>> groups;
+    for (auto &[digest, items]: by_digest) {
+        if (items.size() > 1) groups.push_back(items);
+    }
+    std::sort(groups.begin(), groups.end());
+    return groups;
+}
+
+template<hash::method M>
+static void run_duplicates_test(sycl::queue &q, const byte *in, dword inlen, dword n_batch) {
+    auto found = hash::find_duplicates<M>(q, in, inlen, n_batch);
+    std::vector<std::vector<dword>> groups;
+    for (size_t g = 0; g < found.size(); ++g) {
+        groups.emplace_back(found.indices.begin() + (long) found.offsets[g], found.indices.begin() + (long) found.offsets[g + 1]);
+        ASSERT_TRUE(std::is_sorted(groups.back().begin(), groups.back().end()));
+    }
+    std::sort(groups.begin(), groups.end());
+    ASSERT_EQ(groups, reference_duplicates<M>(q, in, inlen, n_batch));
+}
+
+/**
+ * The first 2000 blocks repeat 500 contents four times, the others are unique.
+ */
+void duplicates_test(hash::runners &q) {
+    constexpr dword n_batch = 3000;
+    constexpr dword inlen = 64;
+    std::vector<byte> in(n_batch * inlen);
+    for (dword i = 0; i < n_batch; ++i) {
+        dword content = i < 2000 ? i % 500 : i;
+        memset(in.data() + i * inlen, (int) content, inlen);
+        memcpy(in.data() + i * inlen, &content, sizeof(dword));
+    }
+    for (auto &runner: q) {
+        auto found = hash::find_duplicates<hash::method::sha256>(runner.q, in.data(), inlen, n_batch);
+        ASSERT_EQ(found.size(), 500);
+        ASSERT_EQ(found.indices.size(), 2000);
+        run_duplicates_test<hash::method::sha256>(runner.q, in.data(), inlen, n_batch);
+        run_duplicates_test<hash::method::xxh3>(runner.q, in.data(), inlen, n_batch);
+        run_duplicates_test<hash::method::crc32c>(runner.q, in.data(), inlen, n_batch);
+        ASSERT_EQ(hash::find_duplicates<hash::method::sha256>(runner.q, in.data() + 2000 * inlen, inlen, n_batch - 2000).size(), 0);
+    }
+}
+
+/**
+ * Inserts and lookups across a growth of the table and a save and load cycle.
+ */
+void digest_index_test(hash::runners &q) {
+    constexpr dword n_items = 3000;
+    constexpr dword inlen = 32;
+    std::vector<byte> in(n_items * inlen);
+    for (dword i = 0; i < n_items; ++i) {
+        memset(in.data() + i * inlen, (int) i, inlen);
+        memcpy(in.data() + i * inlen, &i, sizeof(dword));
+    }
+    auto range = [](dword first, dword last) {
+        std::vector<dword> indices(last - first);
+        std::iota(indices.begin(), indices.end(), first);
+        return indices;
+    };
+    const std::string path = testing::TempDir() + "digest_index_test.bin";
+
+    for (auto &runner: q) {
+        hash::digest_index<hash::method::sha256> index(runner.q, 100);
+        ASSERT_EQ(index.insert(in.data(), inlen, 1000), range(0, 1000));
+        ASSERT_EQ(index.size(), 1000);
+        ASSERT_GE(index.capacity(), 2000);
+        ASSERT_EQ(index.insert(in.data() + 500 * inlen, inlen, 1500), range(500, 1500));
+        ASSERT_EQ(index.lookup(in.data(), inlen, n_items), range(2000, n_items));
+
+        std::vector<byte> twice(in.begin() + 2500 * inlen, in.begin() + 2501 * inlen);
+        twice.insert(twice.end(), twice.begin(), twice.end());
+        ASSERT_EQ(index.insert(twice.data(), inlen, 2).size(), 1);
+        ASSERT_EQ(index.size(), 2001);
+
+        index.save(path);
+        hash::digest_index<hash::method::sha256> loaded(runner.q, 10);
+        loaded.load(path);
+        ASSERT_EQ(loaded.size(), 2001);
+        ASSERT_EQ(loaded.capacity(), index.capacity());
+        auto unknown = range(2000, n_items);
+        unknown.erase(unknown.begin() + 500);
+        ASSERT_EQ(loaded.lookup(in.data(), inlen, n_items), unknown);
+
+        hash::digest_index<hash::method::md5> other_method(runner.q, 10);
+        ASSERT_THROW(other_method.load(path), std::runtime_error);
+
+        /* A full table would make the probes endless, a wrong size or length is not a saved index either */
+        std::ifstream saved(path, std::ios::binary);
+        const std::vector<char> bytes((std::istreambuf_iterator<char>(saved)), std::istreambuf_iterator<char>());
+        const size_t size_at = sizeof(hash::DIGEST_INDEX_MAGIC) + 4 * sizeof(qword);
+        auto load_altered = [&](std::vector<char> altered) {
+            std::ofstream(path, std::ios::binary | std::ios::trunc).write(altered.data(), (std::streamsize) altered.size());
+            loaded.load(path);
+        };
+        auto full = bytes;
+        const qword capacity = loaded.capacity();
+        std::memcpy(full.data() + size_at, &capacity, sizeof(qword));
+        std::fill(full.begin() + (std::ptrdiff_t) (size_at + sizeof(qword)), full.end(), (char) 1);
+        ASSERT_THROW(load_altered(full), std::runtime_error);
+        auto wrong_size = bytes;
+        wrong_size[size_at] ^= 1;
+        ASSERT_THROW(load_altered(wrong_size), std::runtime_error);
+        auto trailing = bytes;
+        trailing.resize(trailing.size() + sizeof(qword));
+        ASSERT_THROW(load_altered(trailing), std::runtime_error);
+        ASSERT_EQ(loaded.size(), 2001);
+        index.clear();
+        ASSERT_EQ(index.lookup(in.data(), inlen, 10), range(0, 10));
+    }
+    std::remove(path.c_str());
+}
+
+/**
+ * Sequential FastCDC over the whole buffer, with the rules of the device.
+ */
+static std::vector<qword> reference_chunks(const std::vector<byte> &data, const hash::cdc_params &params) {
+    qword mask_small, mask_large;
+    hash::internal::cdc_masks(params, mask_small, mask_large);
+    std::vector<qword> bounds{0};
+    qword start = 0;
+    while (start < data.size()) {
+        const qword limit = std::min<qword>(start + params.max_size, data.size());
+        qword cut = limit, h = 0;
+        for (qword i = start >= 63 ? start - 63 : 0; i < limit; ++i) {
+            h = (h << 1) + hash::GEAR_TABLE[data[i]];
+            if (i + 1 < start + params.min_size) continue;
+            if ((h & mask_small) == 0 || ((h & mask_large) == 0 && i + 1 - start > params.avg_size)) {
+                cut = i + 1;
+                break;
+            }
+        }
+        bounds.push_back(start = cut);
+    }
+    return bounds;
+}
+
+void chunking_test(hash::runners &q) {
+    const hash::cdc_params params{256, 1024, 4096};
+    std::mt19937 gen(42);
+    std::vector<byte> data(200'000);
+    std::generate(data.begin(), data.end(), [&]() { return (byte) gen(); });
+    std::vector<byte> shifted(100, 0xab);
+    shifted.insert(shifted.end(), data.begin(), data.end());
+    const auto expected = reference_chunks(data, params);
+
+    for (auto &runner: q) {
+        ASSERT_EQ(hash::content_defined_chunks(runner.q, data.data(), data.size(), params), expected);
+        ASSERT_EQ(hash::content_defined_chunks(runner.q, data.data(), 100, params), (std::vector<qword>{0, 100}));
+
+        auto chunks = hash::chunk_and_hash<hash::method::sha256>(runner.q, data.data(), data.size(), params);
+        ASSERT_EQ(chunks.size() + 1, expected.size());
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            ASSERT_EQ(chunks[i].offset, expected[i]);
+            ASSERT_EQ(chunks[i].offset + chunks[i].length, expected[i + 1]);
+            ASSERT_LE(chunks[i].length, params.max_size);
+            if (i + 1 < chunks.size()) {
+                ASSERT_GE(chunks[i].length, params.min_size);
+            }
+            std::array<byte, SHA256_BLOCK_SIZE> digest{};
+            hash::compute<hash::method::sha256>(runner.q, data.data() + chunks[i].offset, chunks[i].length, digest.data(), 1);
+            ASSERT_EQ(chunks[i].digest, digest);
+        }
+
+        /* Inserting bytes in front only changes the first chunks */
+        auto moved = hash::chunk_and_hash<hash::method::sha256>(runner.q, shifted.data(), shifted.size(), params);
+        std::set<std::array<byte, SHA256_BLOCK_SIZE>> digests;
+        for (const auto &chunk: moved) digests.insert(chunk.digest);
+        size_t kept = std::count_if(chunks.begin(), chunks.end(), [&](const auto &chunk) { return digests.count(chunk.digest) != 0; });
+        ASSERT_GE(kept + 3, chunks.size());
+    }
+}
+
+/**
+ * Files of a few sizes, half of them sharing one, a file too big to be batched and a missing file. Few io_uring slots
+ * and a shallow queue, so that reads wait for the consumer.
+ */
+template<hash::method M>
+static void run_hash_files_test(sycl::queue &q, const hash::file_hash_function &function, hash::file_io io, const std::vector<std::string> &paths,
+                                const std::vector<std::vector<byte>> &contents, const std::function<void(const byte *, dword, byte *)> &reference) {
+    hash::file_hash_options options;
+    options.io = io;
+    options.queue_depth = 4;
+    options.slot_bytes = 4096;
+    options.n_slots = 6;
+    options.small_file_bytes = 4096;
+    options.batch_bytes = 8192;
+    options.memory_budget = 16384;
+    options.n_readers = 3;
+    std::vector<std::vector<byte>> digests(paths.size());
+    std::vector<std::string> errors(paths.size());
+    hash::hash_files(q, function, paths, options, [&](size_t index, const byte *digest, const std::string &error) {
+        ASSERT_TRUE(digests[index].empty() && errors[index].empty());
+        if (digest) digests[index].assign(digest, digest + function.digest_size);
+        errors[index] = error;
+    });
+    for (size_t i = 0; i < contents.size(); ++i) {
+        std::vector<byte> expected(hash::get_block_size<M>());
+        byte empty = 0;
+        reference(contents[i].empty() ? &empty : contents[i].data(), (dword) contents[i].size(), expected.data());
+        ASSERT_EQ(digests[i], expected);
+        ASSERT_TRUE(errors[i].empty());
+    }
+    ASSERT_TRUE(digests.back().empty());
+    ASSERT_NE(errors.back().find(paths.back()), std::string::npos);
+}
+
+void hash_files_test(hash::runners &q) {
+    std::vector<std::string> paths;
+    std::vector<std::vector<byte>> contents;
+    for (dword i = 0; i < 41; ++i) {
+        std::vector<byte> content(i == 40 ? 100'000 : i % 2 ? 100 : 37 * i);
+        for (size_t b = 0; b < content.size(); ++b) {
+            content[b] = (byte) (b * 7 + i);
+        }
+        paths.push_back(testing::TempDir() + "hash_files_test_" + std::to_string(i));
+        std::ofstream(paths.back(), std::ios::binary).write((const char *) content.data(), (std::streamsize) content.size());
+        contents.push_back(content);
+    }
+    const size_t n_written = paths.size();
+    /* procfs reports a size of 0 for files with contents */
+    std::ifstream proc_file("/proc/version", std::ios::binary);
+    if (proc_file) {
+        paths.emplace_back("/proc/version");
+        contents.emplace_back(std::istreambuf_iterator<char>(proc_file), std::istreambuf_iterator<char>());
+    }
+    paths.push_back(testing::TempDir() + "hash_files_test_missing");
+
+    for (auto &runner: q) {
+        for (auto io: {hash::file_io::mapped, hash::file_io::pread, hash::file_io::io_uring}) {
+            run_hash_files_test<hash::method::sha256>(runner.q, hash::make_file_hash_function<hash::method::sha256>(), io, paths, contents, [&](const byte *in, dword inlen, byte *out) {
+                hash::compute<hash::method::sha256>(runner.q, in, inlen, out, 1);
+            });
+        }
+        auto seed = hash::internal::seed_to_key(42);
+        run_hash_files_test<hash::method::xxh3>(runner.q, hash::make_file_hash_function<hash::method::xxh3>(seed.data(), (dword) seed.size()), hash::file_io::io_uring, paths, contents,
+                                                [&](const byte *in, dword inlen, byte *out) {
+                                                    hash::compute<hash::method::xxh3>(runner.q, in, inlen, out, 1, 42);
+                                                });
+    }
+    for (size_t i = 0; i < n_written; ++i) {
+        std::remove(paths[i].c_str());
+    }
+}
+
+/**
+ * A mapped file hashed in place once registered, on the devices that can read host memory.
+ */
+void host_registration_test(hash::runners &q) {
+    std::vector<byte> content(100'000);
+    for (size_t b = 0; b < content.size(); ++b) {
+        content[b] = (byte) (b * 13);
+    }
+    const std::string path = testing::TempDir() + "host_registration_test";
+    std::ofstream(path, std::ios::binary).write((const char *) content.data(), (std::streamsize) content.size());
+    auto mapped = hash::file_contents::load(path);
+    ASSERT_EQ(mapped.size(), content.size());
+
+    for (auto &runner: q) {
+        std::vector<byte> expected(SHA256_BLOCK_SIZE), digest(SHA256_BLOCK_SIZE);
+        hash::compute<hash::method::sha256>(runner.q, content.data(), (dword) content.size(), expected.data(), 1);
+        const bool cpu = runner.q.get_device().is_cpu() || runner.q.get_device().is_host();
+        {
+            hash::host_registration in(mapped.data(), mapped.size(), runner.q), out(digest.data(), digest.size(), runner.q);
+            ASSERT_EQ(in.in_place(), cpu);
+#ifdef IMPLICIT_MEMORY_COPY
+            ASSERT_EQ(is_ptr_usable(mapped.data() + 1000, runner.q), cpu);
+#endif
+            hash::compute<hash::method::sha256>(runner.q, mapped.data(), (dword) mapped.size(), digest.data(), 1);
+        }
+        ASSERT_EQ(digest, expected);
+#ifdef IMPLICIT_MEMORY_COPY
+        if (runner.q.get_device().is_cpu()) {
+            ASSERT_FALSE(is_ptr_usable(digest.data(), runner.q));
+        }
+#endif
+    }
+    std::remove(path.c_str());
+}
+
+/**
+ * Allocations of the library found in the pointer cache, user allocations once registered, overlapping host ranges.
+ */
+void pointer_cache_test(hash::runners &q) {
+    auto &cache = hash::internal::pointer_cache::instance();
+    for (auto &runner: q) {
+        auto shared = hash::usm_unique_ptr<byte, hash::alloc::shared>(1000, runner.q);
+        byte *allocation = shared.raw();
+        auto info = cache.find(allocation + 999);
+        ASSERT_TRUE(info && info->begin == allocation && info->kind == hash::alloc::shared && info->context);
+#ifdef IMPLICIT_MEMORY_COPY
+        ASSERT_TRUE(is_ptr_usable(allocation + 10, runner.q));
+#endif
+        shared.reset();
+        ASSERT_FALSE(cache.find(allocation));
+
+        byte *user = sycl::malloc_device<byte>(64, runner.q);
+        ASSERT_FALSE(cache.find(user));
+        hash::register_usm_allocation(user, 64, runner.q);
+        ASSERT_EQ(cache.find(user + 63)->kind, hash::alloc::device);
+        cache.add(user, (size_t) 1 << 40, hash::alloc::unknown, std::nullopt); // Host ranges as large as a mapped file do not hide allocations
+        ASSERT_EQ(cache.find(user + 63)->kind, hash::alloc::device);
+        ASSERT_EQ(cache.find(user + 64)->kind, hash::alloc::unknown);
+        cache.remove(user, (size_t) 1 << 40);
+        ASSERT_FALSE(cache.find(user + 64) && cache.find(user + 64)->begin == user);
+        hash::unregister_usm_allocation(user);
+        ASSERT_FALSE(cache.find(user));
+        sycl::free(user, runner.q);
+
+        std::vector<byte> host(4096);
+        ASSERT_THROW(hash::register_usm_allocation(host.data(), host.size(), runner.q), std::invalid_argument);
+        {
+            hash::host_registration outer(host.data(), host.size(), runner.q), inner(host.data() + 100, 100, runner.q);
+            ASSERT_EQ(cache.find(host.data() + 3000).has_value(), outer.in_place());
+            ASSERT_EQ(cache.find(host.data() + 150).has_value(), outer.in_place());
+        }
+        ASSERT_FALSE(cache.find(host.data() + 3000));
+    }
+}
+
+/**
+ * Truncated, strided and structure of arrays outputs hold the bytes of the full digests, the gaps are left untouched.
+ */
+template<hash::method M, int n_outbit = 0>
+static void check_output_layouts(sycl::queue &q, const byte *in, dword inlen, dword n, const byte *key = nullptr, dword keylen = 0) {
+    const dword size = hash::get_block_size<M, n_outbit>();
+    const dword width = std::min<dword>(size, 16);
+    std::vector<byte> full(size * n);
+    hash::compute<M, n_outbit>(q, in, inlen, full.data(), n, hash::output_layout{}, key, keylen);
+
+    std::vector<byte> truncated(8 * n);
+    hash::compute<M, n_outbit>(q, in, inlen, truncated.data(), n, hash::output_layout{std::min<dword>(size, 8)}, key, keylen);
+    for (dword i = 0; i < n; ++i) {
+        ASSERT_TRUE(std::equal(full.begin() + i * size, full.begin() + i * size + std::min<dword>(size, 8), truncated.begin() + i * std::min<dword>(size, 8)));
+    }
+
+    const size_t stride = width + 5;
+    std::vector<byte> strided(stride * n, 0xAA);
+    hash::compute<M, n_outbit>(q, in, inlen, strided.data(), n, hash::output_layout{width, stride}, key, keylen);
+    for (dword i = 0; i < n; ++i) {
+        ASSERT_TRUE(std::equal(full.begin() + i * size, full.begin() + i * size + width, strided.begin() + i * stride));
+        ASSERT_TRUE(std::all_of(strided.begin() + i * stride + width, strided.begin() + (i + 1) * stride, [](byte b) { return b == 0xAA; }));
+    }
+
+    auto soa = hash::usm_unique_ptr<byte, hash::alloc::shared>(width * n, q);
+    hash::compute<M, n_outbit>(q, in, inlen, soa.raw(), n, hash::output_layout{width, 0, true}, key, keylen);
+    for (dword i = 0; i < n; ++i) {
+        for (dword b = 0; b < width; ++b) {
+            ASSERT_EQ(soa.raw()[((b / 4) * n + i) * 4 + b % 4], full[i * size + b]);
+        }
+    }
+
+    ASSERT_THROW((hash::compute<M, n_outbit>(q, in, inlen, full.data(), n, hash::output_layout{size + 1}, key, keylen)), std::invalid_argument);
+    ASSERT_THROW((hash::compute<M, n_outbit>(q, in, inlen, full.data(), n, hash::output_layout{width, width - 1}, key, keylen)), std::invalid_argument);
+    if (size > 4) {
+        ASSERT_THROW((hash::compute<M, n_outbit>(q, in, inlen, full.data(), n, hash::output_layout{6, 0, true}, key, keylen)), std::invalid_argument);
+    }
+}
+
+void output_layout_test(hash::runners &q) {
+    constexpr dword n = 37;
+    std::vector<byte> input(64 * n);
+    for (size_t b = 0; b < input.size(); ++b) {
+        input[b] = (byte) (b * 31 + 7);
+    }
+    const auto seed = hash::internal::seed_to_key(42);
+    const byte sip_key[SIPHASH_KEY_SIZE] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15};
+    for (auto &runner: q) {
+        check_output_layouts<hash::method::sha256>(runner.q, input.data(), 50, n);
+        check_output_layouts<hash::method::sha256>(runner.q, input.data(), 64, n);
+        check_output_layouts<hash::method::md5>(runner.q, input.data(), 64, n);
+        check_output_layouts<hash::method::blake2b, 512>(runner.q, input.data(), 50, n);
+        check_output_layouts<hash::method::sha3, 256>(runner.q, input.data(), 50, n);
+        check_output_layouts<hash::method::xxh3>(runner.q, input.data(), 50, n, seed.data(), seed.size());
+        check_output_layouts<hash::method::siphash>(runner.q, input.data(), 50, n, sip_key, SIPHASH_KEY_SIZE);
+        check_output_layouts<hash::method::crc32c>(runner.q, input.data(), 50, n);
+
+        std::vector<byte> expected(SHA256_BLOCK_SIZE * n), digests(SHA256_BLOCK_SIZE * n);
+        hash::compute<hash::method::sha256>(runner.q, input.data(), 50, expected.data(), n);
+        hash::compute<hash::method::sha256>(runner.q, input.data(), 50, digests.data(), n, hash::output_layout{});
+        ASSERT_EQ(digests, expected);
+    }
+}
+
+/**
+ * Items read from a field of an array of structures and digests written into another, both in host memory (copied)
+ * and in shared memory (in place), match gathering and scattering around a packed call. Overlapping items too.
+ */
+template<hash::method M, int n_outbit = 0>
+static void check_record_layouts(sycl::queue &q, const byte *records, dword n, const byte *key = nullptr, dword keylen = 0) {
+    constexpr dword record_size = 80, field_offset = 8, inlen = 50, out_record_size = 48, out_offset = 16;
+    const dword size = hash::get_block_size<M, n_outbit>(), width = std::min<dword>(size, 32);
+    std::vector<byte> gathered(inlen * n), expected(size * n);
+    for (dword i = 0; i < n; ++i) {
+        std::copy(records + i * record_size + field_offset, records + i * record_size + field_offset + inlen, gathered.begin() + i * inlen);
+    }
+    hash::compute<M, n_outbit>(q, gathered.data(), inlen, expected.data(), n, hash::output_layout{}, key, keylen);
+
+    const hash::input_layout in_layout{field_offset, record_size};
+    const hash::output_layout out_layout{width, out_record_size, false, out_offset};
+    std::vector<byte> host_out(out_record_size * n, 0x55);
+    auto shared_in = hash::usm_unique_ptr<byte, hash::alloc::shared>(record_size * n, q);
+    auto shared_out = hash::usm_unique_ptr<byte, hash::alloc::shared>(out_record_size * n, q);
+    std::copy(records, records + record_size * n, shared_in.raw());
+    std::fill(shared_out.raw(), shared_out.raw() + out_record_size * n, 0x55);
+    hash::compute<M, n_outbit>(q, records, inlen, host_out.data(), n, in_layout, out_layout, key, keylen);
+    hash::compute<M, n_outbit>(q, shared_in.raw(), inlen, shared_out.raw(), n, in_layout, out_layout, key, keylen);
+    for (const byte *out: {(const byte *) host_out.data(), (const byte *) shared_out.raw()}) {
+        for (dword i = 0; i < n; ++i) {
+            const byte *field = out + i * out_record_size;
+            ASSERT_TRUE(std::equal(expected.begin() + i * size, expected.begin() + i * size + width, field + out_offset));
+            ASSERT_TRUE(std::all_of(field, field + out_offset, [](byte b) { return b == 0x55; }));
+            ASSERT_TRUE(std::all_of(field + out_offset + width, field + out_record_size, [](byte b) { return b == 0x55; }));
+        }
+    }
+
+    /* Sliding windows: item i is the bytes i to i + inlen - 1 */
+    std::vector<byte> windows(size * n), sliding(size * n);
+    for (dword i = 0; i < n; ++i) {
+        hash::compute<M, n_outbit>(q, records + i, inlen, windows.data() + i * size, 1, hash::output_layout{}, key, keylen);
+    }
+    hash::compute<M, n_outbit>(q, records, inlen, sliding.data(), n, hash::input_layout{0, 1}, hash::output_layout{}, key, keylen);
+    ASSERT_EQ(sliding, windows);
+}
+
+void record_layout_test(hash::runners &q) {
+    constexpr dword n = 29;
+    std::vector<byte> records(80 * n);
+    for (size_t b = 0; b < records.size(); ++b) {
+        records[b] = (byte) (b * 17 + 3);
+    }
+    const auto seed = hash::internal::seed_to_key(7);
+    const byte sip_key[SIPHASH_KEY_SIZE] = {15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0};
+    for (auto &runner: q) {
+        check_record_layouts<hash::method::sha256>(runner.q, records.data(), n);
+        check_record_layouts<hash::method::sha1>(runner.q, records.data(), n);
+        check_record_layouts<hash::method::blake2b, 256>(runner.q, records.data(), n);
+        check_record_layouts<hash::method::keccak, 512>(runner.q, records.data(), n);
+        check_record_layouts<hash::method::murmur3>(runner.q, records.data(), n, seed.data(), seed.size());
+        check_record_layouts<hash::method::halfsiphash>(runner.q, records.data(), n, sip_key, HALFSIPHASH_KEY_SIZE);
+        check_record_layouts<hash::method::crc64nvme>(runner.q, records.data(), n);
+    }
+}
+
 void md2_test(hash::runners &q, size_t count) {
     byte text1[] = {
             "abc"
@@ -96,6 +1368,65 @@ void keccak_test(hash::runners &q, size_t count) {
     run_test<hash::method::keccak, 256>(q, text1, 3, hash1, count);
 }
 
+/**
+ * Messages ending one byte before the rate (both padding bytes fall in the same byte), on the rate and spanning several blocks.
+ */
+void keccak_rate_boundary_test(hash::runners &q, size_t count) {
+    std::vector<byte> buf(1001);
+    for (size_t i = 0; i < buf.size(); ++i) {
+        buf[i] = (uint8_t) (i * 7 + 3);
+    }
+    byte sha3_135[hash::get_block_size<hash::method::sha3, 256>()] = {
+            0xd9, 0xdc, 0xf1, 0xf9, 0x8e, 0x49, 0xa7, 0x9b,
+            0x06, 0x43, 0xa9, 0xe6, 0x8f, 0xef, 0x48, 0x07,
+            0x9f, 0xf8, 0x77, 0x7c, 0x5e, 0x7e, 0x7f, 0x93,
+            0x46, 0x9d, 0xed, 0x65, 0xf1, 0x92, 0xac, 0x71};
+    byte sha3_136[hash::get_block_size<hash::method::sha3, 256>()] = {
+            0x74, 0x3b, 0xd3, 0x2e, 0x77, 0x5a, 0xc7, 0x38,
+            0x7a, 0x57, 0xd4, 0xd5, 0x74, 0xc8, 0x9d, 0xde,
+            0xf5, 0xeb, 0xcb, 0x08, 0xbb, 0x5c, 0xc6, 0xb8,
+            0x8c, 0x55, 0xa2, 0x7b, 0x50, 0x35, 0xcc, 0x45};
+    byte sha3_1001[hash::get_block_size<hash::method::sha3, 256>()] = {
+            0xeb, 0xdf, 0x1e, 0x59, 0xbd, 0x18, 0x34, 0x43,
+            0x3d, 0xdf, 0xa5, 0x4b, 0x67, 0x08, 0xf7, 0x21,
+            0x3e, 0x59, 0xaf, 0x94, 0x31, 0xb6, 0x2b, 0xc9,
+            0x1b, 0x00, 0xbc, 0xdc, 0xda, 0x48, 0xad, 0x40};
+    byte keccak_71[hash::get_block_size<hash::method::keccak, 512>()] = {
+            0x86, 0xbf, 0x2e, 0x58, 0x8d, 0x18, 0x3d, 0x65,
+            0x77, 0x94, 0xba, 0x7f, 0x8e, 0x54, 0x7a, 0xec,
+            0x6f, 0xe1, 0x56, 0x24, 0x19, 0xa5, 0x47, 0x1c,
+            0x91, 0x8a, 0x87, 0xe0, 0x6d, 0x7a, 0x35, 0xc4,
+            0x14, 0x97, 0xcb, 0x01, 0x60, 0xb9, 0xcb, 0xb0,
+            0xe2, 0x87, 0x93, 0x42, 0xfb, 0xff, 0xe2, 0xab,
+            0xe1, 0x8b, 0x32, 0xe0, 0xb7, 0x59, 0x96, 0x64,
+            0x90, 0xdf, 0x88, 0x78, 0x22, 0x81, 0xe4, 0x26};
+    byte keccak_72[hash::get_block_size<hash::method::keccak, 512>()] = {
+            0xa5, 0x9a, 0xd3, 0x57, 0x67, 0x0b, 0xfb, 0x24,
+            0x24, 0x0f, 0xf9, 0xfe, 0xfa, 0x95, 0xaa, 0x3e,
+            0x89, 0x96, 0x03, 0xe5, 0x53, 0x2e, 0xcb, 0x10,
+            0x33, 0x3c, 0xad, 0x31, 0x63, 0x85, 0x15, 0x89,
+            0xd0, 0x99, 0x24, 0xb6, 0x88, 0x92, 0x1f, 0xdc,
+            0x71, 0xf2, 0xf2, 0x56, 0xba, 0xdc, 0x48, 0xd8,
+            0x39, 0x0a, 0x58, 0x62, 0x87, 0x9a, 0x86, 0x74,
+            0x3a, 0x45, 0x65, 0xd4, 0x43, 0x6e, 0x76, 0xe1};
+    byte keccak_1001[hash::get_block_size<hash::method::keccak, 512>()] = {
+            0x90, 0x0a, 0xd8, 0x4b, 0x79, 0xee, 0xef, 0x8d,
+            0x12, 0x07, 0x9a, 0x2f, 0x62, 0x48, 0xef, 0x3d,
+            0xca, 0x0e, 0xd4, 0x5c, 0xb4, 0x10, 0x57, 0x68,
+            0x60, 0x3a, 0x63, 0x78, 0xb3, 0x1c, 0x5f, 0x39,
+            0xed, 0x03, 0xa1, 0x17, 0x52, 0x98, 0xda, 0xe5,
+            0xf3, 0x6e, 0x5d, 0x00, 0x91, 0xa7, 0x55, 0x50,
+            0x50, 0x99, 0xb7, 0x9e, 0x6a, 0xcb, 0x17, 0x62,
+            0xf1, 0x40, 0x60, 0xd9, 0xb5, 0x2a, 0x15, 0x4b};
+
+    run_test<hash::method::sha3, 256>(q, buf.data(), 135, sha3_135, count);
+    run_test<hash::method::sha3, 256>(q, buf.data(), 136, sha3_136, count);
+    run_test<hash::method::sha3, 256>(q, buf.data(), 1001, sha3_1001, count);
+    run_test<hash::method::keccak, 512>(q, buf.data(), 71, keccak_71, count);
+    run_test<hash::method::keccak, 512>(q, buf.data(), 72, keccak_72, count);
+    run_test<hash::method::keccak, 512>(q, buf.data(), 1001, keccak_1001, count);
+}
+
 void sha3_test(hash::runners &q, size_t count) {
     byte text1[] = {
             "abc"
@@ -126,6 +1457,17 @@ void blake2b_test(hash::runners &q, size_t count) {
             0x55, 0xed, 0x30, 0x4d, 0x30, 0x2c, 0x86, 0xb5};
     run_test<hash::method::blake2b, 512>(q, text1, 3, hash1, count, key1, 3);
 
+    byte unkeyed_hash1[hash::get_block_size<hash::method::blake2b, 512>()] = {
+            0xba, 0x80, 0xa5, 0x3f, 0x98, 0x1c, 0x4d, 0x0d,
+            0x6a, 0x27, 0x97, 0xb6, 0x9f, 0x12, 0xf6, 0xe9,
+            0x4c, 0x21, 0x2f, 0x14, 0x68, 0x5a, 0xc4, 0xb7,
+            0x4b, 0x12, 0xbb, 0x6f, 0xdb, 0xff, 0xa2, 0xd1,
+            0x7d, 0x87, 0xc5, 0x39, 0x2a, 0xab, 0x79, 0x2d,
+            0xc2, 0x52, 0xd5, 0xde, 0x45, 0x33, 0xcc, 0x95,
+            0x18, 0xd3, 0x8a, 0xa8, 0xdb, 0xf1, 0x92, 0x5a,
+            0xb9, 0x23, 0x86, 0xed, 0xd4, 0x00, 0x99, 0x23};
+    run_test<hash::method::blake2b, 512>(q, text1, 3, unkeyed_hash1, count);
+
 
     constexpr int KAT_LENGTH = 256;
     constexpr int blake2b_keylen = 64;
@@ -209,6 +1551,34 @@ void blake2b_test(hash::runners &q, size_t count) {
 
 }
 
+/**
+ * Large single messages, on CPUs this goes through the row-vectorized compression.
+ */
+void blake2b_large_input_test(hash::runners &q, size_t count) {
+    constexpr int blake2b_keylen = 64;
+    constexpr size_t large_len = 256 * 1024 + 3;
+    byte key[blake2b_keylen];
+    for (size_t i = 0; i < blake2b_keylen; ++i) {
+        key[i] = (uint8_t) i;
+    }
+
+    std::vector<byte> buf(large_len);
+    for (size_t i = 0; i < large_len; ++i) {
+        buf[i] = (uint8_t) i;
+    }
+
+    byte hash1[hash::get_block_size<hash::method::blake2b, 512>()] = {
+            0x7b, 0x3e, 0xd0, 0x2d, 0x42, 0x79, 0x24, 0x83,
+            0xb9, 0xe1, 0xea, 0xd9, 0xf4, 0x90, 0x77, 0x9e,
+            0x3d, 0xc7, 0x4e, 0xe6, 0x8b, 0x1e, 0x69, 0x71,
+            0x9d, 0x0c, 0xad, 0xeb, 0xf9, 0xe6, 0x24, 0xba,
+            0xbd, 0x3e, 0x72, 0x4d, 0x70, 0x4f, 0xe8, 0xd3,
+            0x90, 0x3e, 0xbf, 0x91, 0xaf, 0x4f, 0x04, 0x16,
+            0x69, 0x6a, 0x89, 0x7b, 0xe8, 0x73, 0xc2, 0x6d,
+            0x55, 0xe5, 0x97, 0x56, 0xcc, 0xf8, 0x17, 0xf5};
+    run_test<hash::method::blake2b, 512>(q, buf.data(), large_len, hash1, count, key, blake2b_keylen);
+}
+
 
 TEST(Hash_Test, Blake2b) {
     for_all_workers([](auto q) {
@@ -222,6 +1592,12 @@ TEST(Hash_Test_Pairs, Blake2b) {
     });
 }
 
+TEST(Hash_Test, Blake2bLargeInput) {
+    for_all_workers([](auto q) {
+        blake2b_large_input_test(q, 1);
+    });
+}
+
 TEST(Hash_Test, Keccak) {
     for_all_workers([](auto q) {
         keccak_test(q, loop_count);
@@ -246,6 +1622,12 @@ TEST(Hash_Test_Pairs, SHA3) {
     });
 }
 
+TEST(Hash_Test, KeccakRateBoundaries) {
+    for_all_workers([](auto q) {
+        keccak_rate_boundary_test(q, 5);
+    });
+}
+
 TEST(Hash_Test, SHA256) {
     for_all_workers([](auto q) {
         sha256_test(q, loop_count);
@@ -258,6 +1640,30 @@ TEST(Hash_Test_Pairs, SHA256) {
     });
 }
 
+TEST(Hash_Test, SHA256D) {
+    for_all_workers([](auto q) {
+        sha256d_test(q, loop_count);
+    });
+}
+
+TEST(Hash_Test_Pairs, SHA256D) {
+    for_all_workers_pairs([](hash::runners q) {
+        sha256d_test(q, loop_count);
+    });
+}
+
+TEST(Hash_Test, HASH160) {
+    for_all_workers([](auto q) {
+        hash160_test(q, loop_count);
+    });
+}
+
+TEST(Hash_Test_Pairs, HASH160) {
+    for_all_workers_pairs([](hash::runners q) {
+        hash160_test(q, loop_count);
+    });
+}
+
 TEST(Hash_Test, SHA1) {
     for_all_workers([](auto q) {
         sha1_test(q, loop_count);
@@ -270,6 +1676,162 @@ TEST(Hash_Test_Pairs, SHA1) {
     });
 }
 
+TEST(Hash_Test, SmallInputs) {
+    for_all_workers([](auto q) {
+        small_input_test(q, loop_count);
+    });
+}
+
+TEST(Hash_Test_Pairs, SmallInputs) {
+    for_all_workers_pairs([](hash::runners q) {
+        small_input_test(q, loop_count);
+    });
+}
+
+TEST(Hash_Test, MultiBlockInputs) {
+    for_all_workers([](auto q) {
+        multi_block_test(q, loop_count);
+    });
+}
+
+TEST(Hash_Test, FixedLength) {
+    for_all_workers([](auto q) {
+        fixed_length_test(q, 7);
+    });
+}
+
+TEST(Hash_Test, TablePlacement) {
+    for_all_workers([](auto q) {
+        table_placement_test(q, 37);
+    });
+}
+
+TEST(Hash_Test, NonCryptographic) {
+    for_all_workers([](auto q) {
+        non_cryptographic_test(q, 5);
+    });
+}
+
+TEST(Hash_Test_Pairs, NonCryptographic) {
+    for_all_workers_pairs([](hash::runners q) {
+        non_cryptographic_test(q, 5);
+    });
+}
+
+TEST(Hash_Test, CRC) {
+    for_all_workers([](auto q) {
+        crc_test(q, 5);
+    });
+}
+
+TEST(Hash_Test_Pairs, CRC) {
+    for_all_workers_pairs([](hash::runners q) {
+        crc_test(q, 5);
+    });
+}
+
+TEST(Hash_Test, SipHash) {
+    for_all_workers([](auto q) {
+        siphash_test(q, 7);
+    });
+}
+
+TEST(Hash_Test_Pairs, SipHash) {
+    for_all_workers_pairs([](hash::runners q) {
+        siphash_test(q, 7);
+    });
+}
+
+TEST(Sketch_Test, BloomFilter) {
+    for_all_workers([](auto q) {
+        bloom_filter_test(q);
+    });
+}
+
+TEST(Sketch_Test, Signatures) {
+    for_all_workers([](auto q) {
+        signatures_test(q);
+    });
+}
+
+TEST(Sketch_Test, HyperLogLog) {
+    for_all_workers([](auto q) {
+        hyperloglog_test(q);
+    });
+}
+
+TEST(Sketch_Test_Pairs, HyperLogLog) {
+    for_all_workers_pairs([](hash::runners q) {
+        hyperloglog_test(q);
+    });
+}
+
+TEST(Sketch_Test, CountMin) {
+    for_all_workers([](auto q) {
+        count_min_test(q);
+    });
+}
+
+TEST(Sketch_Test_Pairs, CountMin) {
+    for_all_workers_pairs([](hash::runners q) {
+        count_min_test(q);
+    });
+}
+
+TEST(Sketch_Test, Partition) {
+    for_all_workers([](auto q) {
+        partition_test(q);
+    });
+}
+
+TEST(Sketch_Test, Duplicates) {
+    for_all_workers([](auto q) {
+        duplicates_test(q);
+    });
+}
+
+TEST(Sketch_Test, DigestIndex) {
+    for_all_workers([](auto q) {
+        digest_index_test(q);
+    });
+}
+
+TEST(Sketch_Test, Chunking) {
+    for_all_workers([](auto q) {
+        chunking_test(q);
+    });
+}
+
+TEST(File_Test, HashFiles) {
+    for_all_workers([](auto q) {
+        hash_files_test(q);
+    });
+}
+
+TEST(File_Test, HostRegistration) {
+    for_all_workers([](auto q) {
+        host_registration_test(q);
+    });
+}
+
+TEST(Memory_Test, PointerCache) {
+    for_all_workers([](auto q) {
+        pointer_cache_test(q);
+    });
+}
+
+TEST(Hash_Test, OutputLayout) {
+    for_all_workers([](auto q) {
+        output_layout_test(q);
+    });
+}
+
+TEST(Hash_Test, RecordLayout) {
+    for_all_workers([](auto q) {
+        record_layout_test(q);
+    });
+}
+
 TEST(Hash_Test, MD2) {
     for_all_workers([](auto q) {
         md2_test(q, loop_count);